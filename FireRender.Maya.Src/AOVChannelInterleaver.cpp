@@ -0,0 +1,61 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "AOVChannelInterleaver.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+void InterleaveAOVChannels(const std::vector<AOVChannelSource>& sources,
+	unsigned int width, unsigned int height, size_t pixelSize, float* output)
+{
+	auto interleaveRows = [&](unsigned int firstRow, unsigned int lastRow)
+	{
+		for (unsigned int row = firstRow; row < lastRow; ++row)
+		{
+			size_t firstPixel = size_t(row) * width;
+			size_t lastPixel = firstPixel + width;
+			size_t channelOffset = 0;
+
+			// one AOV at a time within a row: sequential reads, fixed stride writes to a row which stays in cache
+			for (const AOVChannelSource& source : sources)
+			{
+				float* destination = output + firstPixel * pixelSize + channelOffset;
+				const float* sourcePixel = source.pixels + firstPixel * source.pixelStride;
+				unsigned int componentCount = source.componentCount;
+
+				for (size_t pixelIdx = firstPixel; pixelIdx < lastPixel; ++pixelIdx, destination += pixelSize, sourcePixel += source.pixelStride)
+				{
+					for (unsigned int component = 0; component < componentCount; ++component)
+					{
+						destination[component] = sourcePixel[component];
+					}
+				}
+
+				channelOffset += componentCount;
+			}
+		}
+	};
+
+	unsigned int taskCount = std::max(std::thread::hardware_concurrency(), 1u);
+	unsigned int rowsPerTask = (height + taskCount - 1) / taskCount;
+
+	std::vector<std::future<void>> tasks;
+	for (unsigned int firstRow = 0; firstRow < height; firstRow += rowsPerTask)
+	{
+		tasks.push_back(std::async(std::launch::async, interleaveRows, firstRow, std::min(firstRow + rowsPerTask, height)));
+	}
+
+	for (auto& task : tasks)
+		task.get();
+}
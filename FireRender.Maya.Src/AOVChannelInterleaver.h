@@ -0,0 +1,31 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// consecutive channels of multichannel image taken from one AOV
+struct AOVChannelSource
+{
+	// first float of first pixel, pixels are pixelStride floats apart (4 for RV_PIXEL)
+	const float* pixels;
+	unsigned int pixelStride;
+	unsigned int componentCount;
+};
+
+// Interleaves AOV components for OIIO (each output pixel contains all channels data, in order of sources).
+// Bands of rows are processed in parallel; values are copied as is, so cryptomatte
+// ids (uint32 hashes stored as float bits) are written bit-exact.
+void InterleaveAOVChannels(const std::vector<AOVChannelSource>& sources,
+	unsigned int width, unsigned int height, size_t pixelSize, float* output);
@@ -41,9 +41,11 @@ limitations under the License.
 #include <fstream>
 
 #include "FireRenderThread.h"
+#include "SceneTeardownWorker.h"
 #include "FireRenderMaterialSwatchRender.h"
 #include "CompositeWrapper.h"
 #include <InstancerMASH.h>
+#include <InstancerParticle.h>
 
 #include <deque>
 
@@ -58,15 +60,13 @@ limitations under the License.
 using namespace RPR;
 using namespace FireMaya;
 
-#ifdef DEBUG_LOCKS
-std::map<FireRenderContext*,FireRenderContext::Lock::frcinfo> FireRenderContext::Lock::lockMap;
-#endif
-
 #include <imageio.h>
 
 #include <maya/MUuid.h>
 #include "FireRenderIBL.h"
 #include <maya/MFnRenderLayer.h>
+#include <maya/MIteratorType.h>
+#include <unordered_set>
 
 #ifdef OPTIMIZATION_CLOCK
 	int FireRenderContext::timeInInnerAddPolygon;
@@ -113,7 +113,8 @@ FireRenderContext::FireRenderContext() :
 	m_RenderType(RenderType::Undefined),
 	m_bIsGLTFExport(false),
 	m_IterationsPowerOf2Mode(false),
-	m_DisableSetDirtyObjects(false)
+	m_DisableSetDirtyObjects(false),
+	m_cpuThreadShareCount(1)
 {
 	DebugPrint("FireRenderContext::FireRenderContext()");
 
@@ -485,26 +486,24 @@ bool FireRenderContext::buildScene(bool isViewport, bool glViewport, bool freshe
 		MGlobal::executeCommand("isRenderSelectedObjectsOnlyFlagSet()", isRenderSelectedOnly);
 		m_renderSelectedObjectsOnly = isRenderSelectedOnly > 0;
 
-		MStatus status;
-
-		MItDag itDag(MItDag::kDepthFirst, MFn::kDagNode, &status);
-		if (MStatus::kSuccess != status)
-			MGlobal::displayError("MItDag::MItDag");
+		TimePoint scanStartTime = GetCurrentChronoTime();
 
-		for (; !itDag.isDone(); itDag.next())
-		{
-			MDagPath dagPath;
-			status = itDag.getPath(dagPath);
+		std::vector<MDagPath> scenePaths;
+		size_t foundCount = CollectSceneDagPaths(scenePaths);
 
-			if (MStatus::kSuccess != status)
-			{
-				MGlobal::displayError("MDagPath::getPath");
-				break;
-			}
+		TimePoint translateStartTime = GetCurrentChronoTime();
 
+		for (const MDagPath& dagPath : scenePaths)
+		{
 			AddSceneObject(dagPath);
 		}
 
+		LogPrint("FireRenderContext::buildScene: dag scan %d ms (%zu shapes and lights found, %zu paths kept), objects created in %d ms",
+			(int) TimeDiffChrono<std::chrono::milliseconds>(translateStartTime, scanStartTime),
+			foundCount,
+			scenePaths.size(),
+			(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), translateStartTime));
+
 		//Should be called when all scene objects are constucted
 		BuildLateinitObjects();
 
@@ -1062,10 +1061,44 @@ void FireRenderContext::cleanScene()
 	});
 }
 
+void FireRenderContext::detachFromMaya()
+{
+	MAIN_THREAD_ONLY;
+
+	LOCKMUTEX(this);
+	removeCallbacks();
+
+	for (auto& it : m_sceneObjects)
+	{
+		it.second->DetachFromMaya();
+	}
+
+	m_camera.DetachFromMaya();
+}
+
 void FireRenderContext::cleanSceneAsync(std::shared_ptr<FireRenderContext> refToKeepAlive)
 {
-	m_cleanSceneFuture = std::async( [] (std::shared_ptr<FireRenderContext> refToKeepAlive)
-		{ refToKeepAlive->cleanScene(); }, refToKeepAlive);
+	// Maya messages may only be used on the main thread, teardown worker releases RPR objects only
+	FireRenderThread::RunProcOnMainThread([&refToKeepAlive]()
+	{
+		refToKeepAlive->detachFromMaya();
+	});
+
+	SceneTeardownWorker::Enqueue("FireRenderContext", [refToKeepAlive]() mutable
+	{
+		size_t memoryUsed = FireRenderThread::RunOnceAndWait<size_t>([&refToKeepAlive]()
+		{
+			frw::Context context = refToKeepAlive->GetContext();
+			return context ? context.GetMemoryUsage() : 0;
+		});
+
+		refToKeepAlive->cleanScene();
+
+		// rpr context itself is destroyed with the last reference
+		refToKeepAlive.reset();
+
+		LogPrint("SceneTeardownWorker: context released, %zu MB of RPR memory reclaimed", memoryUsed >> 20);
+	});
 }
 
 void FireRenderContext::initSwatchScene()
@@ -1391,6 +1424,17 @@ int FireRenderContext::getThreadCountToOverride() const
 
 	FireRenderGlobalsData::getCPUThreadSetup(isOverriden, cpuThreadCount, m_RenderType);
 
+	if (m_cpuThreadShareCount > 1)
+	{
+		// several contexts are rendering concurrently, split threads between them
+		if (!isOverriden)
+		{
+			cpuThreadCount = (int) std::thread::hardware_concurrency();
+		}
+
+		return std::max(1, cpuThreadCount / m_cpuThreadShareCount);
+	}
+
 	if (isOverriden)
 	{
 		return cpuThreadCount;
@@ -1400,11 +1444,105 @@ int FireRenderContext::getThreadCountToOverride() const
 	return 0;
 }
 
+size_t FireRenderContext::CollectSceneDagPaths(std::vector<MDagPath>& outPaths) const
+{
+	MStatus status;
+
+	// Backdoor for comparing with the previous behaviour: every dag node is passed to AddSceneObject
+	if (std::getenv("RPR_MAYA_FULL_DAG_SCAN") != nullptr)
+	{
+		MItDag itDag(MItDag::kDepthFirst, MFn::kDagNode, &status);
+		if (MStatus::kSuccess != status)
+			MGlobal::displayError("MItDag::MItDag");
+
+		for (; !itDag.isDone(); itDag.next())
+		{
+			MDagPath dagPath;
+			if (itDag.getPath(dagPath) != MStatus::kSuccess)
+			{
+				MGlobal::displayError("MDagPath::getPath");
+				break;
+			}
+
+			outPaths.push_back(dagPath);
+		}
+
+		return outPaths.size();
+	}
+
+	// Everything AddSceneObject can translate; plugin shapes and locators cover RPR, VRay, xgen, Ornatrix and gpuCache nodes
+	MIntArray filterTypes;
+	filterTypes.append(MFn::kMesh);
+	filterTypes.append(MFn::kNurbsSurface);
+	filterTypes.append(MFn::kSubdiv);
+	filterTypes.append(MFn::kLight);
+	filterTypes.append(MFn::kFluid);
+	filterTypes.append(MFn::kInstancer);
+	filterTypes.append(MFn::kPfxHair);
+	filterTypes.append(MFn::kPluginShape);
+	filterTypes.append(MFn::kPluginLocatorNode);
+	if (m_bIsGLTFExport)
+	{
+		filterTypes.append(MFn::kLocator);
+	}
+
+	MIteratorType iteratorType;
+	iteratorType.setFilterList(filterTypes);
+
+	MItDag itDag(iteratorType, MItDag::kDepthFirst, &status);
+	if (MStatus::kSuccess != status)
+		MGlobal::displayError("MItDag::MItDag");
+
+	// transforms above translated nodes; rig-only transforms without renderable children are not needed
+	std::unordered_set<std::string> addedTransforms;
+	std::vector<MDagPath> ancestors;
+	size_t visitedCount = 0;
+
+	for (; !itDag.isDone(); itDag.next())
+	{
+		++visitedCount;
+
+		MDagPath dagPath;
+		if (itDag.getPath(dagPath) != MStatus::kSuccess)
+		{
+			MGlobal::displayError("MDagPath::getPath");
+			break;
+		}
+
+		// intermediate shapes (deformer inputs) are never rendered
+		if (MFnDagNode(dagPath).isIntermediateObject())
+			continue;
+
+		ancestors.clear();
+		MDagPath parentPath = dagPath;
+		while ((parentPath.pop() == MStatus::kSuccess) && (parentPath.length() > 0))
+		{
+			if (!addedTransforms.insert(parentPath.fullPathName().asChar()).second)
+				break; // this transform and everything above it is already added
+
+			ancestors.push_back(parentPath);
+		}
+
+		outPaths.insert(outPaths.end(), ancestors.rbegin(), ancestors.rend());
+		outPaths.push_back(dagPath);
+	}
+
+	return visitedCount;
+}
+
 void FireRenderContext::BuildLateinitObjects()
 {
 	for (const MDagPath path : m_LateinitMASHInstancers)
 	{
-		CreateSceneObject<InstancerMASH, NodeCachingOptions::AddPath>(path);
+		// the same instancer node type is driven either by MASH or by particles
+		if (InstancerParticle::IsParticleInstancer(path.node()))
+		{
+			CreateSceneObject<InstancerParticle, NodeCachingOptions::AddPath>(path);
+		}
+		else
+		{
+			CreateSceneObject<InstancerMASH, NodeCachingOptions::AddPath>(path);
+		}
 	}
 	m_LateinitMASHInstancers.clear();
 }
@@ -1521,7 +1659,7 @@ bool FireRenderContext::ConsiderShadowReflectionCatcherOverride(const ReadFrameB
 	if ((!isReflectionCatcher) && (!isShadowCather))
 		return false; // SC or RC not used
 
-	std::lock_guard<std::mutex> lock(m_rifLock);
+	AutoProfiledLock lock(m_rifLock, __FUNCTION__);
 
 	if (isShadowCather && isReflectionCatcher)
 	{
@@ -2175,6 +2313,10 @@ void FireRenderContext::updateRenderLayers()
 	if (!m_renderLayersChanged)
 		return;
 
+	// viewport shows every object regardless of current render layer
+	bool checkLayerMembership = GetRenderType() != RenderType::ViewportRender;
+	MFnRenderLayer renderLayer(MFnRenderLayer::currentLayer());
+
 	for (const auto& it : m_sceneObjects)
 	{
 		if (auto frNode = dynamic_cast<FireRenderNode*>(it.second.get()))
@@ -2185,7 +2327,9 @@ void FireRenderContext::updateRenderLayers()
 			MString name = nodeFn.name();
 			if (path.isValid())
 			{
-				if (path.isVisible())
+				bool isInLayer = !checkLayerMembership || renderLayer.inCurrentRenderLayer(path);
+
+				if (path.isVisible() && isInLayer)
 					frNode->attachToScene();
 				else
 					frNode->detachFromScene();
@@ -2200,6 +2344,68 @@ void FireRenderContext::updateRenderLayers()
 	m_renderLayersChanged = false;
 }
 
+size_t FireRenderContext::SwitchRenderLayer(const MObject& layer)
+{
+	MAIN_THREAD_ONLY;
+
+	TimePoint startTime = GetCurrentChronoTime();
+
+	MFnDependencyNode layerNodeFn(layer);
+	MGlobal::executeCommand("editRenderLayerGlobals -currentRenderLayer " + layerNodeFn.name(), false, true);
+
+	MFnRenderLayer renderLayer(layer);
+	size_t changedCount = 0;
+
+	for (const auto& it : m_sceneObjects)
+	{
+		auto mesh = dynamic_cast<FireRenderMesh*>(it.second.get());
+		if (!mesh)
+			continue;
+
+		MDagPath path = mesh->DagPath();
+		if (!path.isValid() || !path.isVisible() || !renderLayer.inCurrentRenderLayer(path))
+			continue;
+
+		// mesh was hidden in previous layers and was never translated
+		bool needsTranslation = mesh->Elements().empty();
+
+		// material override of the layer changes shading engine assignment
+		bool shadingChanged = false;
+		if (!needsTranslation)
+		{
+			MFnDagNode meshFn(path);
+			MObjectArray shadingEngines = GetShadingEngines(meshFn, mesh->Instance());
+			const std::vector<MObject>& assignedShadingEngines = mesh->Elements().back().shadingEngines;
+
+			shadingChanged = shadingEngines.length() != assignedShadingEngines.size();
+			for (unsigned int idx = 0; !shadingChanged && (idx < shadingEngines.length()); ++idx)
+			{
+				shadingChanged = shadingEngines[idx] != assignedShadingEngines[idx];
+			}
+		}
+
+		if (needsTranslation || shadingChanged)
+		{
+			mesh->setDirty();
+			changedCount++;
+		}
+	}
+
+	// attach / detach is done for all objects by updateRenderLayers(), render settings overrides are reread from globals
+	{
+		AutoMutexLock lock(m_dirtyMutex);
+
+		m_renderLayersChanged = true;
+		m_globalsChanged = true;
+	}
+	setDirty();
+
+	DebugPrint("FireRenderContext::SwitchRenderLayer(%s): %zu objects to update, %d ms",
+		layerNodeFn.name().asUTF8(), changedCount, (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), startTime));
+
+	return changedCount;
+}
+
 // TODO Need to be refactored in a more flexible way
 void FireRenderContext::globalsChangedCallback(MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug, void *clientData)
 {
@@ -2848,6 +3054,11 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 	syncProgressData.elapsed = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), syncStartTime);
 	UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::SyncComplete);
 
+	DebugPrint("FireRenderContext: sync took %lld ms, %zu meshes translated, peak process memory %zu MB",
+		syncProgressData.elapsed,
+		meshesToFreshen.size(),
+		GetPeakResidentMemoryMB());
+
 	if (changed)
 	{
 		UpdateDefaultLights();
@@ -3387,7 +3598,7 @@ std::vector<float> FireRenderContext::DenoiseAndUpscaleForViewport()
 		ReadDenoiserFrameBuffersIntoRAM(params);
 	}
 
-	std::lock_guard<std::mutex> lock(m_rifLock);
+	AutoProfiledLock lock(m_rifLock, __FUNCTION__);
 	bool isDenoiserInitialized = setupDenoiserForViewport(); // will read data from outBuffers if useRAMBuffer == true
 	assert(isDenoiserInitialized);
 	if (!isDenoiserInitialized || !IsDenoiserCreated())
@@ -3444,7 +3655,7 @@ bool FireRenderContext::TonemapIntoRAM()
 	readFrameBuffer(params);
 
 	// create and run tonemap filters
-	std::lock_guard<std::mutex> lock(m_rifLock);
+	AutoProfiledLock lock(m_rifLock, __FUNCTION__);
 	bool isTonemapperInitialized = TryCreateTonemapImageFilters(); 
 
 	if (!isTonemapperInitialized)
@@ -3499,7 +3710,7 @@ std::vector<float> FireRenderContext::DenoiseIntoRAM()
 		ReadDenoiserFrameBuffersIntoRAM(params);
 	}
 
-	std::lock_guard<std::mutex> lock(m_rifLock);
+	AutoProfiledLock lock(m_rifLock, __FUNCTION__);
 	bool isDenoiserInitialized = TryCreateDenoiserImageFilters(useRAMBuffer); // will read data from outBuffers if useRAMBuffer == true
 	assert(isDenoiserInitialized);
 	if (!isDenoiserInitialized || !IsDenoiserCreated())
@@ -37,6 +37,7 @@ limitations under the License.
 
 #include "FireRenderUtils.h"
 #include "FireRenderContextIFace.h"
+#include "ProfiledMutex.h"
 
 // Forward declarations.
 class FireRenderViewport;
@@ -44,9 +45,6 @@ class ImageFilter;
 struct RV_PIXEL;
 
 
-// Turn on to track lock information
-//#define DEBUG_LOCKS 1
-
 // Image file description
 // This class stores the information need by the image file writer
 // during a non interactive render session, like file image extension
@@ -174,9 +172,16 @@ public:
 	// Clean scene
 	void cleanScene();
 
-	// Run clean scene asynchronously
+	// Hand the context over to teardown worker: scene is cleaned and context is released in background
 	void cleanSceneAsync(std::shared_ptr<FireRenderContext> refToKeepAlive);
 
+	// Remove context and scene object callbacks, must run on the main thread
+	void detachFromMaya();
+
+	// Make given render layer current while keeping translated scene. Objects with changed layer membership,
+	// visibility or shading assignment are updated on next Freshen(). Returns count of objects marked for update.
+	size_t SwitchRenderLayer(const MObject& layer);
+
 	// Setup the motion blur
 	void updateMotionBlurParameters(const FireRenderGlobalsData& globalData);
 	void setMotionBlurParameters(const FireRenderGlobalsData& globalData);
@@ -686,6 +691,9 @@ public:
 	void SetWorkProgressCallback(WorkProgressCallback callback) { m_WorkProgressCallback = callback; }
 	void SetIterationsPowerOf2Mode(bool flag) { m_IterationsPowerOf2Mode = flag; }
 
+	// Number of contexts sharing the CPU with this one, should be set before the context is created
+	void SetCPUThreadShareCount(int count) { m_cpuThreadShareCount = count; }
+
 	int GetSamplesPerUpdate() const { return m_samplesPerUpdate; }
 
 	void ResetRAMBuffers(void);
@@ -751,8 +759,12 @@ private:
 	void setupDenoiserRAM(void);
 	void BuildLateinitObjects();
 
+	// Collects paths to be passed to AddSceneObject in parent first order: supported shapes and lights
+	// (intermediate objects skipped) and the transforms above them. Returns count of found shapes and lights.
+	size_t CollectSceneDagPaths(std::vector<MDagPath>& outPaths) const;
+
 private:
-	std::mutex m_rifLock;
+	RPR::ProfiledMutex m_rifLock{ "FireRenderContext::rif" };
 	std::shared_ptr<ImageFilter> m_denoiserFilter;
 	std::shared_ptr<ImageFilter> m_upscalerFilter;
 
@@ -767,7 +779,7 @@ private:
 	FireRenderObjectMap m_sceneObjects;
 
 	// Main mutex
-	std::mutex m_mutex;
+	RPR::ProfiledMutex m_mutex{ "FireRenderContext::Lock" };
 
 	// these are all automatically destructing handles
 	struct Handles
@@ -843,9 +855,6 @@ private:
 
 	bool m_inRefresh = false;
 
-	/** Future object for async cleaning*/
-	std::future<void> m_cleanSceneFuture;
-
 	/** Returns valid context pointer only if we are in the mood to process callbacks */
 	static FireRenderContext* GetCallbackContext(void *clientData)
 	{
@@ -885,6 +894,9 @@ private:
 	// Used for deformation motion blur feature. We need to disable dirtying object when perform deformation motion blur operations (switcihng current time which leads to dirty all objects)
 	bool m_DisableSetDirtyObjects;
 
+	// Number of contexts rendering on the CPU concurrently with this one (used in multi-context tile rendering)
+	int m_cpuThreadShareCount;
+
 public:
 	FireRenderEnvLight *iblLight = nullptr;
 	MObject iblTransformObject = MObject();
@@ -1000,10 +1012,7 @@ public:
 		{
 			if (context)
 			{
-#ifdef DEBUG_LOCKS
-                addMapLock(context,lockedBy);
-#endif
-				context->m_mutex.lock();
+				context->m_mutex.lock(lockedBy);
 				oldState = context->GetState();
 				context->SetState(newState);
 				context->lockedBy = lockedBy;
@@ -1015,10 +1024,7 @@ public:
 		{
 			if (context)
 			{
-#ifdef DEBUG_LOCKS
-                addMapLock(context,lockedBy);
-#endif
-				context->m_mutex.lock();
+				context->m_mutex.lock(lockedBy);
 				oldState = -1;
 				context->lockedBy = lockedBy;
 			}
@@ -1030,9 +1036,6 @@ public:
 			{
 				if (oldState >= 0)
 					context->SetState(StateEnum(oldState));
-#ifdef DEBUG_LOCKS
-                removeMapLock(context);
-#endif
 				context->m_mutex.unlock();
 			}
 		}
@@ -20,6 +20,7 @@ limitations under the License.
 #include "FireRenderError.h"
 #include "FireRenderThread.h"
 #include "AutoLock.h"
+#include <cstring>
 
 #ifdef MAYA2015
 #undef min
@@ -32,6 +33,24 @@ using namespace FireMaya;
 
 #ifndef MAYA2015
 
+namespace
+{
+	// Plain value of a plug, as Scope::GetValue passes it to a material input
+	bool ReadPlugValue(FireMaya::Scope& scope, const MPlug& plug, rpr_float value[4])
+	{
+		frw::Value plugValue = scope.GetValue(plug);
+		if (!plugValue.IsFloat())
+			return false;
+
+		value[0] = plugValue.GetX();
+		value[1] = plugValue.GetY();
+		value[2] = plugValue.GetZ();
+		value[3] = plugValue.GetW();
+
+		return true;
+	}
+}
+
 // ================================
 // FireRenderRenderData
 // ================================
@@ -94,6 +113,12 @@ FireMaterialViewRenderer::FireMaterialViewRenderer() :
 {
 }
 
+FireMaterialViewRenderer::~FireMaterialViewRenderer()
+{
+	if (m_watchedShaderCallback != 0)
+		MNodeMessage::removeCallback(m_watchedShaderCallback);
+}
+
 MStatus FireMaterialViewRenderer::startAsync(const JobParams& params)
 {
 	if (!m_renderDataPtr)
@@ -145,6 +170,7 @@ MStatus FireMaterialViewRenderer::beginSceneUpdate()
 
 	m_threadCmd = ThreadCommand::BEGIN_UPDATE;
 	m_renderDataPtr->m_mutex.lock();
+	m_updateStartTime = GetCurrentChronoTime();
 	return MS::kSuccess;
 }
 
@@ -161,8 +187,16 @@ MStatus FireMaterialViewRenderer::translateMesh(const MUuid& id, const MObject&
 
 		m_renderDataPtr->m_shape.Reset();
 
-		std::vector<int> faceMaterialIndices;
-		const frw::Shape shape = FireMaya::MeshTranslator::TranslateMesh(m_renderDataPtr->m_context.GetContext(), node, faceMaterialIndices);
+		std::string shapeKey = std::string(id.asString().asChar()) + nodeFn.name().asChar();
+		frw::Shape shape = m_renderDataPtr->m_shapeCache[shapeKey];
+
+		if (!shape)
+		{
+			std::vector<int> faceMaterialIndices;
+			shape = FireMaya::MeshTranslator::TranslateMesh(m_renderDataPtr->m_context.GetContext(), node, faceMaterialIndices);
+			m_renderDataPtr->m_shapeCache[shapeKey] = shape;
+		}
+
 		if (shape)
 		{
 			m_renderDataPtr->m_shape = shape;
@@ -339,24 +373,176 @@ MStatus FireMaterialViewRenderer::translateTransform(const MUuid& id, const MUui
 	});
 }
 
+void FireMaterialViewRenderer::watchShaderNode(const MObject& node)
+{
+	MAIN_THREAD_ONLY;
+
+	if (m_watchedShaderCallback != 0 && m_watchedShader == node)
+		return;
+
+	if (m_watchedShaderCallback != 0)
+		MNodeMessage::removeCallback(m_watchedShaderCallback);
+
+	m_watchedShader = node;
+	m_shaderEdits = ShaderEdits();
+
+	MStatus status;
+	MObject watchedNode = node;
+	m_watchedShaderCallback = MNodeMessage::addAttributeChangedCallback(watchedNode, ShaderAttributeChanged, this, &status);
+	if (status != MStatus::kSuccess)
+		m_watchedShaderCallback = 0;
+}
+
+void FireMaterialViewRenderer::ShaderAttributeChanged(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug& otherPlug, void* clientData)
+{
+	ShaderEdits& edits = static_cast<FireMaterialViewRenderer*>(clientData)->m_shaderEdits;
+
+	const int topologyMessages = MNodeMessage::kConnectionMade | MNodeMessage::kConnectionBroken |
+		MNodeMessage::kAttributeAdded | MNodeMessage::kAttributeRemoved | MNodeMessage::kAttributeRenamed |
+		MNodeMessage::kAttributeArrayAdded | MNodeMessage::kAttributeArrayRemoved;
+
+	if (msg & topologyMessages)
+	{
+		edits.topologyChanged = true;
+		return;
+	}
+
+	if (!(msg & MNodeMessage::kAttributeSet))
+		return;
+
+	// colours and vectors go to one input as a whole
+	MPlug valuePlug = plug.isChild() ? plug.parent() : plug;
+
+	for (const MPlug& setPlug : edits.setPlugs)
+	{
+		if (setPlug == valuePlug)
+			return;
+	}
+
+	edits.setPlugs.push_back(valuePlug);
+}
+
+bool FireMaterialViewRenderer::updateBoundValues(const ShaderEdits& edits)
+{
+	RPR_THREAD_ONLY;
+
+	// a volume shader could read the same plugs
+	if (edits.topologyChanged || edits.setPlugs.empty() || m_renderDataPtr->m_volumeShader)
+		return false;
+
+	struct BoundValue
+	{
+		FireRenderRenderData::ValueBinding binding;
+		rpr_float value[4];
+	};
+
+	FireMaya::Scope& scope = m_renderDataPtr->m_context.GetScope();
+	std::vector<BoundValue> boundValues;
+	boundValues.reserve(edits.setPlugs.size());
+
+	for (const MPlug& plug : edits.setPlugs)
+	{
+		auto it = m_renderDataPtr->m_valueBindings.find(plug.name().asChar());
+		if (it == m_renderDataPtr->m_valueBindings.end())
+			return false;
+
+		BoundValue boundValue;
+		boundValue.binding = it->second;
+		if (!ReadPlugValue(scope, plug, boundValue.value))
+			return false;
+
+		boundValues.push_back(boundValue);
+	}
+
+	for (const BoundValue& boundValue : boundValues)
+	{
+		rpr_int res = rprMaterialNodeSetInputFByKey(boundValue.binding.node, boundValue.binding.key,
+			boundValue.value[0], boundValue.value[1], boundValue.value[2], boundValue.value[3]);
+		checkStatus(res);
+	}
+
+	return true;
+}
+
+void FireMaterialViewRenderer::learnValueBinding(const ShaderEdits& edits, const std::vector<frw::NodePatch::Patch>& patches)
+{
+	RPR_THREAD_ONLY;
+
+	// only trusted when one plug edit changed one input to exactly the plug value
+	if (edits.topologyChanged || (edits.setPlugs.size() != 1) || (patches.size() != 1) || (patches[0].type != frw::NodeInputTypeFloat4))
+		return;
+
+	const MPlug& plug = edits.setPlugs[0];
+	rpr_float value[4];
+	if (!ReadPlugValue(m_renderDataPtr->m_context.GetScope(), plug, value) || (memcmp(value, patches[0].value, sizeof(value)) != 0))
+		return;
+
+	m_renderDataPtr->m_valueBindings[plug.name().asChar()] = { patches[0].node, patches[0].key };
+}
+
 MStatus FireMaterialViewRenderer::translateShader(const MUuid& id, const MObject& node)
 {
-	return FireRenderThread::RunOnceAndWait<MStatus>([this, id, node]()
+	// edits made since the last translation, recorded on the main thread
+	watchShaderNode(node);
+	ShaderEdits edits = std::move(m_shaderEdits);
+	m_shaderEdits = ShaderEdits();
+
+	return FireRenderThread::RunOnceAndWait<MStatus>([this, id, node, &edits]()
 	{
 		assert(m_renderDataPtr);
-		std::get<frw::Shader>(m_renderDataPtr->m_surfaceShader) = m_renderDataPtr->m_context.GetShader(node);
+		TimePoint start = GetCurrentChronoTime();
 
 		MFnDependencyNode fnShdr(node);
 		std::string shdrName = fnShdr.name().asChar(); 
 		std::string shaderId = getNodeUUid(node);
 		shaderId += shdrName;
+
+		frw::Shader& surfaceShader = std::get<frw::Shader>(m_renderDataPtr->m_surfaceShader);
+		frw::Shader attachedShader;
+		if (std::get<FireMaya::NodeId>(m_renderDataPtr->m_surfaceShader) == shaderId)
+		{
+			attachedShader = surfaceShader;
+		}
+
+		// Value drags of plugs bound to an input skip the translation altogether
+		if (attachedShader && updateBoundValues(edits))
+		{
+			LogPrint("Material view shader update: set %d bound values in %d ms", (int) edits.setPlugs.size(),
+				(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), start));
+
+			return MS::kSuccess;
+		}
+
+		frw::Shader shader = m_renderDataPtr->m_context.GetShader(node);
+
+		// Edits that keep the graph topology (e.g. a colour drag) only patch the values of the attached graph,
+		// so the shape keeps its material and nothing is rebuilt in the core
+		std::vector<frw::NodePatch::Patch> patches;
+		bool patched = attachedShader && shader && (attachedShader.Handle() != shader.Handle()) &&
+			attachedShader.PatchValuesFrom(shader, &patches);
+
+		if (patched)
+		{
+			attachedShader.SetDirty(false);
+			m_renderDataPtr->m_context.GetScope().SetCachedShader(shaderId, attachedShader);
+			shader = attachedShader;
+
+			learnValueBinding(edits, patches);
+		}
+		else if (!attachedShader || (attachedShader.Handle() != shader.Handle()))
+		{
+			// bindings point into the graph which is being replaced
+			m_renderDataPtr->m_valueBindings.clear();
+		}
+
+		surfaceShader = shader;
 		std::get<FireMaya::NodeId>(m_renderDataPtr->m_surfaceShader) = shaderId;
 
 		m_renderDataPtr->m_volumeShader = m_renderDataPtr->m_context.GetVolumeShader(node);
 
-		if (m_renderDataPtr->m_shape && std::get<frw::Shader>(m_renderDataPtr->m_surfaceShader))
+		if (m_renderDataPtr->m_shape && surfaceShader && !patched)
 		{
-			m_renderDataPtr->m_shape.SetShader(std::get<frw::Shader>(m_renderDataPtr->m_surfaceShader));
+			m_renderDataPtr->m_shape.SetShader(surfaceShader);
 		}
 
 		if (m_renderDataPtr->m_shape && m_renderDataPtr->m_volumeShader)
@@ -364,6 +550,9 @@ MStatus FireMaterialViewRenderer::translateShader(const MUuid& id, const MObject
 			m_renderDataPtr->m_shape.SetVolumeShader(m_renderDataPtr->m_volumeShader);
 		}
 
+		LogPrint("Material view shader update: %s in %d ms", patched ? ("patched " + std::to_string(patches.size()) + " values").c_str() : "translated",
+			(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), start));
+
 		return MS::kSuccess;
 	});
 }
@@ -390,6 +579,14 @@ MStatus FireMaterialViewRenderer::setProperty(const MUuid& id, const MString& na
 		assert(m_renderDataPtr);
 		if ((id == m_envId) && (name == "imageFile"))
 		{
+			// same IBL as the last update, light and image are still attached
+			if (m_renderDataPtr->m_endLight && (value == m_renderDataPtr->m_envImagePath))
+			{
+				return MS::kSuccess;
+			}
+
+			m_renderDataPtr->m_envImagePath = "";
+
 			if (m_renderDataPtr->m_endLight)
 			{
 				m_renderDataPtr->m_context.GetScene().Detach(m_renderDataPtr->m_endLight);
@@ -452,6 +649,8 @@ MStatus FireMaterialViewRenderer::setProperty(const MUuid& id, const MString& na
 					float mfloats[4][4];
 					scaleM.get(mfloats);
 					m_renderDataPtr->m_endLight.SetTransform((rpr_float*)mfloats);
+
+					m_renderDataPtr->m_envImagePath = value;
 				}
 
 				//remove lights
@@ -529,13 +728,23 @@ MStatus FireMaterialViewRenderer::endSceneUpdate()
 		assert(m_renderDataPtr);
 		rpr_framebuffer_format fmt = { 4, RPR_COMPONENT_TYPE_FLOAT32 };
 
-		m_renderDataPtr->m_framebufferColor = frw::FrameBuffer(m_renderDataPtr->m_context.GetContext(), m_renderDataPtr->m_width, m_renderDataPtr->m_height, fmt);
-		m_renderDataPtr->m_framebufferColor.Clear();
+		// framebuffers are only recreated on resize, an update just restarts accumulation
+		bool resized = !m_renderDataPtr->m_framebufferColor ||
+			(m_renderDataPtr->m_framebufferWidth != m_renderDataPtr->m_width) ||
+			(m_renderDataPtr->m_framebufferHeight != m_renderDataPtr->m_height);
 
-		m_renderDataPtr->m_framebufferResolved = frw::FrameBuffer(m_renderDataPtr->m_context.GetContext(), m_renderDataPtr->m_width, m_renderDataPtr->m_height, fmt);
-		m_renderDataPtr->m_framebufferResolved.Clear();
+		if (resized)
+		{
+			m_renderDataPtr->m_framebufferColor = frw::FrameBuffer(m_renderDataPtr->m_context.GetContext(), m_renderDataPtr->m_width, m_renderDataPtr->m_height, fmt);
+			m_renderDataPtr->m_framebufferResolved = frw::FrameBuffer(m_renderDataPtr->m_context.GetContext(), m_renderDataPtr->m_width, m_renderDataPtr->m_height, fmt);
+			m_renderDataPtr->m_framebufferWidth = m_renderDataPtr->m_width;
+			m_renderDataPtr->m_framebufferHeight = m_renderDataPtr->m_height;
 
-		m_renderDataPtr->m_context.GetContext().SetAOV(m_renderDataPtr->m_framebufferColor, RPR_AOV_COLOR);
+			m_renderDataPtr->m_context.GetContext().SetAOV(m_renderDataPtr->m_framebufferColor, RPR_AOV_COLOR);
+		}
+
+		m_renderDataPtr->m_framebufferColor.Clear();
+		m_renderDataPtr->m_framebufferResolved.Clear();
 
 		m_numIteration = 0;
 		m_threadCmd = ThreadCommand::RENDER_IMAGE;
@@ -586,6 +795,7 @@ void FireMaterialViewRenderer::render()
 		//Prevents view freezing after selecting invalid material and then selecting valid
 		auto& nodeId = std::get<FireMaya::NodeId>(m_renderDataPtr->m_surfaceShader);
 		m_renderDataPtr->m_context.GetScope().SetCachedShader(nodeId, nullptr);
+		m_renderDataPtr->m_valueBindings.clear();
 
 		m_threadCmd = ThreadCommand::BEGIN_UPDATE;
 		return;
@@ -619,12 +829,19 @@ void FireMaterialViewRenderer::render()
 	parameters.data = m_renderDataPtr->m_pixels.data();
 	refresh(parameters);
 
+	if (m_numIteration == 1)
+	{
+		LogPrint("Material view first iteration shown %d ms after update", (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_updateStartTime));
+	}
+
 	if (m_numIteration >= FireRenderGlobalsData::getThumbnailIterCount())
 	{
 		ProgressParams params;
 		params.progress = 1.0;
 		progress(params);
 
+		LogPrint("Material view rendered in %d ms", (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_updateStartTime));
+
 		m_threadCmd = ThreadCommand::BEGIN_UPDATE;
 	}
 }
@@ -21,9 +21,11 @@ limitations under the License.
 #include <maya/MGlobal.h>
 #include <maya/MString.h>
 #include <maya/MThreadAsync.h>
+#include <maya/MNodeMessage.h>
 #include <map>
 #include <string>
 #include <tuple>
+#include <vector>
 
 class FireRenderRenderData
 {
@@ -44,6 +46,17 @@ public:
 
 	std::tuple<frw::Shader, FireMaya::NodeId> m_surfaceShader;
 
+	/** Material node input which takes the value of a plug unchanged. */
+	struct ValueBinding
+	{
+		rpr_material_node node;
+		rpr_material_node_input key;
+	};
+
+	// inputs of the attached surface shader keyed by plug name, learned while patching;
+	// valid as long as the same graph stays attached
+	std::map<std::string, ValueBinding> m_valueBindings;
+
 	frw::Shader m_volumeShader;
 
 	frw::Shape m_shape;
@@ -54,9 +67,19 @@ public:
 
 	frw::Image m_envImage;
 
+	// path m_envImage was loaded from, the same IBL is not loaded again
+	MString m_envImagePath;
+
+	// translated preview meshes, the viewer switches between a few fixed ones
+	std::map<std::string, frw::Shape> m_shapeCache;
+
 	frw::FrameBuffer m_framebufferColor;
 	frw::FrameBuffer m_framebufferResolved;
 
+	// size the framebuffers were created with
+	unsigned int m_framebufferWidth = 0;
+	unsigned int m_framebufferHeight = 0;
+
 	unsigned int m_width;
 
 	unsigned int m_height;
@@ -75,7 +98,7 @@ public:
 	FireMaterialViewRenderer();
 
 	// Destructor
-	virtual ~FireMaterialViewRenderer() = default;
+	virtual ~FireMaterialViewRenderer();
 
 	// Start async render
 	virtual MStatus startAsync(const JobParams& params);
@@ -149,6 +172,9 @@ public:
 	// Number of render iterations
 	int m_numIteration;
 
+	// Start of the last scene update, for update to final image latency
+	TimePoint m_updateStartTime;
+
 	enum ThreadCommand {
 		BEGIN_UPDATE = 0,
 		RENDER_IMAGE = 1,
@@ -160,6 +186,29 @@ public:
 
 private:
 
+	// Attribute edits of the watched shader node since its last translation
+	struct ShaderEdits
+	{
+		bool topologyChanged = false;
+		std::vector<MPlug> setPlugs;
+	};
+
+	// Record edits of the shader node, the previously watched node is dropped
+	void watchShaderNode(const MObject& node);
+
+	static void ShaderAttributeChanged(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug& otherPlug, void* clientData);
+
+	// Write edited values straight to their bound inputs; false if any edit needs a translation
+	bool updateBoundValues(const ShaderEdits& edits);
+
+	// Bind the edited plug to the input a patch changed, if it took the plug value unchanged
+	void learnValueBinding(const ShaderEdits& edits, const std::vector<frw::NodePatch::Patch>& patches);
+
+	// Shader node whose edits are recorded, main thread only
+	MObject m_watchedShader;
+	MCallbackId m_watchedShaderCallback = 0;
+	ShaderEdits m_shaderEdits;
+
 	// Camera uuid
 	MUuid m_cameraId;
 
@@ -1941,6 +1941,24 @@ void FireMaya::Scope::SetCachedImage(const MString& key, frw::Image img) const
 		m->imageCache[std::string(key.asChar())] = img;
 }
 
+frw::Shape FireMaya::Scope::GetCachedAreaLightShape(int shapeType) const
+{
+	auto it = m->areaLightShapeCache.find(shapeType);
+
+	if (it != m->areaLightShapeCache.end())
+		return it->second;
+
+	return nullptr;
+}
+
+void FireMaya::Scope::SetCachedAreaLightShape(int shapeType, frw::Shape shape) const
+{
+	if (!shape)
+		m->areaLightShapeCache.erase(shapeType);
+	else
+		m->areaLightShapeCache[shapeType] = shape;
+}
+
 FireMaya::Scope::Scope()
 	: m_pContextInfo(nullptr)
 {
@@ -2223,6 +2241,8 @@ FireMaya::Scope::Data::~Data()
 	shaderMap.clear();
 	lightShaderMap.clear();
 
+	areaLightShapeCache.clear();
+
 	// everything else destroyed automatically
 }
 
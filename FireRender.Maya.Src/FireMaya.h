@@ -213,6 +213,7 @@ namespace FireMaya
 			std::map<NodeId, MCallbackId> m_nodeDirtyCallbacks;
 			std::map<NodeId, MCallbackId> m_AttributeChangedCallbacks;
 			std::map<std::string, frw::Image> imageCache;
+			std::map<int, frw::Shape> areaLightShapeCache; // unit shapes instanced by physical area lights
 
 			FireRenderMeshCommon const* m_pCurrentlyParsedMesh; // is not supposed to keep any data outside of during mesh parsing 
 			MObject m_pLastLinkedLight; // is not supposed to keep any data outside of during mesh parsing 
@@ -254,9 +255,6 @@ namespace FireMaya
 		frw::Value GetCachedValue(const NodeId& str) const;
 		void SetCachedValue(const NodeId& str, frw::Value shader);
 
-		frw::Image GetCachedImage(const MString& key) const;
-		void SetCachedImage(const MString& key, frw::Image img) const;
-
 		frw::Shader ParseVolumeShader( MObject ob );
 		frw::Shader ParseShader(MObject ob);
 
@@ -296,6 +294,10 @@ namespace FireMaya
 
 		frw::Image GetImage(MString path, MString colorSpace, const MString& ownerNodeName) const;
 
+		// images generated by converters, shared with the file image cache
+		frw::Image GetCachedImage(const MString& key) const;
+		void SetCachedImage(const MString& key, frw::Image img) const;
+
 		frw::Image GetTiledImage(MString texturePath, 
 			int viewWidth, int viewHeight,
 			int maxTileWidth, int maxTileHeight,
@@ -339,6 +341,9 @@ namespace FireMaya
 		void SetCachedShaderId(const NodeId& lightId, NodeId& shaderId);// shaderId = lightShaderMap[lightNodeId]
 		void ClearCachedShaderIds(const NodeId& lightId);
 
+		frw::Shape GetCachedAreaLightShape(int shapeType) const;
+		void SetCachedAreaLightShape(int shapeType, frw::Shape shape) const;
+
 		void Reset();
 		void Init(rpr_context handle, bool destroyMaterialSystemOnDelete = true, bool createScene = true);
 		void CreateScene(void);
@@ -26,60 +26,7 @@ limitations under the License.
 #include <ostream>
 
 
-void PixelBuffer::resize(size_t newCount)
-{
-	size_t newSize = sizeof(RV_PIXEL) * newCount;
-	if (newSize != m_size)
-	{
-		void * newBuffer = nullptr;
-#ifdef WIN32
-		newBuffer = _aligned_realloc(m_pBuffer, newSize, 128);
-#else
-		newBuffer = malloc(newSize);
-		if(m_pBuffer)
-		{
-			free(m_pBuffer);
-			m_pBuffer = nullptr;
-		}
-#endif
-
-		m_pBuffer = static_cast<RV_PIXEL*>(newBuffer);
-		m_size = newSize;
-	}
-}
-
-void PixelBuffer::overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id /*= 0*/)
-{
-	// ensure valid input
-	assert(input != nullptr);
-
-	if (region.top > totalHeight)
-		return;
-
-	if (region.right > totalWidth)
-		return;
-
-	// Get region dimensions.
-	unsigned int regionWidth = region.getWidth();
-	unsigned int regionHeight = region.getHeight();
-
-	// copy line by line
-	for (unsigned int y = 0; y < regionHeight; y++)
-	{
-		unsigned int inputIndex = y * regionWidth;
-
-		unsigned int destShiftY = y + totalHeight - region.top - 1;
-		unsigned int destIndex = region.left + (destShiftY) * totalWidth;
-
-		memcpy(&m_pBuffer[destIndex], &input[inputIndex], sizeof(RV_PIXEL) * regionWidth);
-	}
-
-#ifdef _DEBUG
-#ifdef DUMP_PIXELS_PIXELBUFF
-	debugDump(totalHeight, totalWidth, std::string(FireRenderAOV::GetAOVName(aov_id) + "_tile_"), "C://temp//buffers//");
-#endif
-#endif
-}
+static_assert(sizeof(RV_PIXEL) == PixelBuffer::PixelSize, "PixelBuffer copies RV_PIXEL as four floats");
 
 #ifdef _DEBUG
 void generateBitmapImage(unsigned char *image, int height, int width, int pitch, const char* imageFileName);
@@ -12,6 +12,7 @@ limitations under the License.
 ********************************************************************/
 #pragma once
 #include <maya/MString.h>
+#include "PixelBuffer.h"
 #include "RenderRegion.h"
 #include "RenderStamp.h"
 #include <memory>
@@ -25,9 +26,6 @@ limitations under the License.
 // Forward declarations.
 class FireRenderContext;
 
-struct RV_PIXEL;
-
-
 /** AOV description of channel components and data types. */
 struct AOVDescription
 {
@@ -35,90 +33,6 @@ struct AOVDescription
 	OIIO::TypeDesc types;
 };
 
-/** Automated handler for RV_PIXEL data.
-	Uses aligned memory manager and prevents unnecessary re-allocations */
-class PixelBuffer
-{
-	RV_PIXEL * m_pBuffer;
-	size_t m_size;
-	size_t m_width;
-	size_t m_height;
-
-public:
-	PixelBuffer() 
-		:	m_pBuffer(nullptr)
-		,	m_size(0)
-		,	m_width(0)
-		,	m_height(0)
-	{
-	}
-	virtual ~PixelBuffer()
-	{
-		reset();
-	}
-
-public:
-	operator bool() const
-	{
-		return m_pBuffer != nullptr;
-	}
-
-	RV_PIXEL * const get() const
-	{
-		return m_pBuffer;
-	}
-
-	size_t size() const
-	{
-		return m_size;
-	}
-
-	size_t width() const
-	{
-		return m_width;
-	}
-
-	size_t height() const
-	{
-		return m_height;
-	}
-
-	float* data()
-	{
-		return (float*)m_pBuffer;
-	}
-
-	void resize(size_t newCount);
-
-	void resize(size_t width, size_t height)
-	{
-		m_width = width;
-		m_height = height;
-
-		resize(width*height);
-	}
-
-	void reset()
-	{
-		if (m_pBuffer)
-		{
-#ifdef WIN32
-			_aligned_free(m_pBuffer);
-#else
-			free(m_pBuffer);
-#endif
-		}
-		m_pBuffer = nullptr;
-		m_size = 0;
-	}
-
-	void overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id = 0);
-
-	void debugDump(unsigned int height, unsigned int width, const std::string& fbName, const std::string& pathToFile);
-};
-
-typedef std::map<unsigned int, PixelBuffer> AOVPixelBuffers;
-
 /** AOV data. */
 class FireRenderAOV
 {
@@ -45,6 +45,7 @@ limitations under the License.
 #include "RenderRegion.h"
 #include "FireRenderThread.h"
 #include "RenderStampUtils.h"
+#include "StartupContextChecker.h"
 
 #include "Context/ContextCreator.h"
 
@@ -60,6 +61,7 @@ using namespace FireMaya;
 // -----------------------------------------------------------------------------
 bool FireRenderCmd::s_rendering = false;
 bool FireRenderCmd::s_waitForIt = false;
+long FireRenderCmd::s_pluginLoadTimeMs = 0;
 unique_ptr<FireRenderIpr> FireRenderCmd::s_ipr;
 unique_ptr<FireRenderProduction> FireRenderCmd::s_production = make_unique<FireRenderProduction>();
 
@@ -95,6 +97,10 @@ MSyntax FireRenderCmd::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kWaitForIt, kWaitForItLong, MSyntax::kNoArg));
 	CHECK_MSTATUS(syntax.addFlag(kWaitForItTwoStep, kWaitForItTwoStepLong, MSyntax::kNoArg));
 	CHECK_MSTATUS(syntax.addFlag(kExportsGLTF, kExportsGLTFLong, MSyntax::kBoolean));
+	CHECK_MSTATUS(syntax.addFlag(kMLDenoiserSupportedCPU, kMLDenoiserSupportedCPULong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kVerifyTelemetryCounters, kVerifyTelemetryCountersLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kTelemetryCountersMatched, kTelemetryCountersMatchedLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kPluginLoadTime, kPluginLoadTimeLong, MSyntax::kNoArg));
 
 	return syntax;
 }
@@ -114,6 +120,28 @@ MStatus FireRenderCmd::doIt(const MArgList & args)
 	{
 		return exportsGLTF(argData);
 	}
+	else if (argData.isFlagSet(kMLDenoiserSupportedCPU))
+	{
+		// waits for the startup check if it is still running
+		setResult(StartupContextChecker::IsMLDenoiserSupportedCPU() ? 1 : 0);
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kVerifyTelemetryCounters))
+	{
+		// next production render recounts polygons and textures through RPR
+		FireRenderProduction::VerifyTelemetryCountersOnNextRender();
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kTelemetryCountersMatched))
+	{
+		setResult(FireRenderProduction::TelemetryCountersMatched() ? 1 : 0);
+		return MS::kSuccess;
+	}
+	else if (argData.isFlagSet(kPluginLoadTime))
+	{
+		setResult((int) s_pluginLoadTimeMs);
+		return MS::kSuccess;
+	}
 	else if (argData.isFlagSet(kOpenFolder))
 	{
 		MString path;
@@ -456,46 +484,76 @@ MStatus FireRenderCmd::renderBatch(const MArgDatabase& args)
 		// Get the list of cameras to render frames for.
 		MDagPathArray renderableCameras = GetSceneCameras(true);
 
-		// Process each render-able camera.
-		for (MDagPath camera : renderableCameras)
+		std::vector<MString> cameraNames;
+		for (const MDagPath& camera : renderableCameras)
 		{
-			// Update the context to use the current camera.
-			MString cameraName = getCameraName(camera);
-			context.setCamera(camera, true);
-
-			// Get frame ranges.
-			int frameStart = static_cast<int>(settings.frameStart.value());
-			int frameEnd = static_cast<int>(settings.frameEnd.value());
-			int frameBy = static_cast<int>(settings.frameBy);
+			cameraNames.push_back(getCameraName(camera));
+		}
 
-			// Don't render multiple frames for single frame renders.
-			if (settings.namingScheme < 2)
-				frameEnd = frameStart;
+		// Get frame ranges.
+		int frameStart = static_cast<int>(settings.frameStart.value());
+		int frameEnd = static_cast<int>(settings.frameEnd.value());
+		int frameBy = static_cast<int>(settings.frameBy);
 
-			// Process each frame.
-			for (int frame = frameStart; frame <= frameEnd; frame += frameBy)
-			{
-				// Execute the pre-frame command if there is one.
-				MGlobal::executeCommand(settings.preRenderMel);
+		// Don't render multiple frames for single frame renders.
+		if (settings.namingScheme < 2)
+			frameEnd = frameStart;
 
-				// Move the animation to the next frame.
-				MTime time;
-				time.setValue(static_cast<double>(frame));
-				MAnimControl::setCurrentTime(time);
+		// Process each frame. Scene is synced once per frame and
+		// then rendered from each render-able camera, so only
+		// camera has to be updated when switching between them.
+		for (int frame = frameStart; frame <= frameEnd; frame += frameBy)
+		{
+			// Get the full paths to the output image files
+			// and create folders if necessary.
+			std::vector<MString> filePaths;
+			bool hasFramesToRender = false;
 
-				// Get the full path to the output image
-				// file and create folders if necessary.
+			for (const MString& cameraName : cameraNames)
+			{
 				MString filePath = getOutputFilePath(settings, frame, cameraName, false);
 
 				// Skip the current frame if required.
 				if (settings.skipExistingFrames && outputFileExists(filePath))
+					filePath.clear();
+				else
+					hasFramesToRender = true;
+
+				filePaths.push_back(filePath);
+			}
+
+			if (!hasFramesToRender)
+				continue;
+
+			// Execute the pre-frame command if there is one.
+			MGlobal::executeCommand(settings.preRenderMel);
+
+			// Move the animation to the next frame.
+			MTime time;
+			time.setValue(static_cast<double>(frame));
+			MAnimControl::setCurrentTime(time);
+
+			for (unsigned int cameraIdx = 0; cameraIdx < renderableCameras.length(); cameraIdx++)
+			{
+				const MString& filePath = filePaths[cameraIdx];
+				if (filePath.length() == 0)
 					continue;
 
-				// Refresh the context so it matches the
-				// current animation state and start the render.
+				// Update the context to use the current camera.
+				MDagPath camera = renderableCameras[cameraIdx];
+				context.setCamera(camera, true);
+
+				// Refresh the context so it matches the current animation state
+				// and camera and start the render. After the first camera of
+				// the frame only camera is refreshed here.
+				TimePoint syncStartTime = GetCurrentChronoTime();
+
 				context.Freshen();
 				context.setStartedRendering();
 
+				long syncTime = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), syncStartTime);
+				MGlobal::displayInfo(MString(string_format("Frame %d, camera %s: sync time %d ms", frame, cameraNames[cameraIdx].asChar(), (int) syncTime).c_str()));
+
 				// Track the last progress percent so a progress
 				// message is displayed only if the progress changes.
 				int lastProgress = 0;
@@ -530,10 +588,10 @@ MStatus FireRenderCmd::renderBatch(const MArgDatabase& args)
 
 				// Save the frame to file.
 				aovs.writeToFile(context, filePath, settings.imageFormat);
-
-				// Execute the post frame command if there is one.
-				MGlobal::executeCommand(settings.postRenderMel);
 			}
+
+			// Execute the post frame command if there is one.
+			MGlobal::executeCommand(settings.postRenderMel);
 		}
 
 		MGlobal::displayInfo(MString(devicesStr.c_str()));
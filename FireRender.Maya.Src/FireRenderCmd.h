@@ -52,6 +52,9 @@ public:
 	/** Clean up before plug-in shutdown. */
 	static void cleanUp();
 
+	/** Record how long the plug-in load took, returned by fireRender -pluginLoadTime. */
+	static void setPluginLoadTime(long milliseconds) { s_pluginLoadTimeMs = milliseconds; }
+
 
 private:
 
@@ -74,6 +77,9 @@ private:
 	 */
 	static bool s_waitForIt;
 
+	/** Duration of the last initializePlugin, in milliseconds. */
+	static long s_pluginLoadTimeMs;
+
 	/** The current IPR render if any, otherwise nullptr. */
 	static std::unique_ptr<FireRenderIpr> s_ipr;
 	static std::unique_ptr<FireRenderProduction> s_production;
@@ -181,4 +187,12 @@ private:
 #define kWaitForItTwoStepLong "-waitForItTwo"
 #define kExportsGLTF "-eg"
 #define kExportsGLTFLong "-exportsGLTF"
+#define kMLDenoiserSupportedCPU "-mds"
+#define kMLDenoiserSupportedCPULong "-mlDenoiserSupportedCPU"
+#define kVerifyTelemetryCounters "-vtc"
+#define kVerifyTelemetryCountersLong "-verifyTelemetryCounters"
+#define kTelemetryCountersMatched "-tcm"
+#define kTelemetryCountersMatchedLong "-telemetryCountersMatched"
+#define kPluginLoadTime "-plt"
+#define kPluginLoadTimeLong "-pluginLoadTime"
 
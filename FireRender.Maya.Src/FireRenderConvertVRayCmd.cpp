@@ -27,6 +27,8 @@ limitations under the License.
 #include "maya/MIntArray.h"
 #include "maya/MItDependencyGraph.h"
 #include "maya/MFnAmbientLight.h"
+#include "maya/MFnNumericAttribute.h"
+#include "maya/MFnNumericData.h"
 
 #include "FireRenderConvertVRayCmd.h"
 
@@ -254,27 +256,29 @@ void FireRenderConvertVRayCmd::VRayLightIESShapeConverter(MObject originalVRayOb
 	auto data = FireMaya::VRay::readVRayIESLightData(originalVRayObject);
 
 	MFnDagNode dagNodeOriginal(originalVRayObject);
+	// node names are only known when the script runs, so they are kept in MEL variables
 	MString cmd =
-		R"(createNode "transform" -n "t$name";
-createNode RPRIES -n "$name" -p "t$name";
-select -r "t$name";
-setAttr -type "string" "$name.iesFile" "$filePath";
-setAttr "$name.color" -type double3 $color.r $color.g $color.b;
-setAttr "$name.display" $display;
-setAttr "$name.intensity" $intensity;
-setAttr "t$name.translateX" $translate.x;
-setAttr "t$name.translateY" $translate.y;
-setAttr "t$name.translateZ" $translate.z;
-setAttr "t$name.rotateX" $rotate.x;
-setAttr "t$name.rotateY" $rotate.y;
-setAttr "t$name.rotateZ" $rotate.z;
-setAttr "t$name.scaleX" $scale.x;
-setAttr "t$name.scaleY" $scale.y;
-setAttr "t$name.scaleZ" $scale.z;
+		R"({
+string $rprTransform = `createNode "transform" -n "t$name"`;
+string $rprNode = `createNode RPRIES -n "$name" -p $rprTransform`;
+select -r $rprTransform;
+setAttr -type "string" ($rprNode + ".iesFile") "$filePath";
+setAttr ($rprNode + ".color") -type double3 $color.r $color.g $color.b;
+setAttr ($rprNode + ".display") $display;
+setAttr ($rprNode + ".intensity") $intensity;
+setAttr ($rprTransform + ".translateX") $translate.x;
+setAttr ($rprTransform + ".translateY") $translate.y;
+setAttr ($rprTransform + ".translateZ") $translate.z;
+setAttr ($rprTransform + ".rotateX") $rotate.x;
+setAttr ($rprTransform + ".rotateY") $rotate.y;
+setAttr ($rprTransform + ".rotateZ") $rotate.z;
+setAttr ($rprTransform + ".scaleX") $scale.x;
+setAttr ($rprTransform + ".scaleY") $scale.y;
+setAttr ($rprTransform + ".scaleZ") $scale.z;
 
 select -r "$originalName";
 doDelete;
-)";
+})";
 
 	auto name = "RPR"_ms + dagNodeOriginal.name();
 	cmd.substitute("$name", name);
@@ -303,7 +307,7 @@ doDelete;
 	cmd.substitute("$scale.y", toMString(scale[1] * 2));
 	cmd.substitute("$scale.z", toMString(scale[2]));
 
-	ExecuteCommand(cmd);
+	QueueCommand(m_nodeModifier, cmd);
 }
 
 void FireRenderConvertVRayCmd::VRayLightSphereConverter(MObject originalVRayObject)
@@ -311,37 +315,30 @@ void FireRenderConvertVRayCmd::VRayLightSphereConverter(MObject originalVRayObje
 	auto data = FireMaya::VRay::readVRayLightSphereData(originalVRayObject);
 
 	MFnDagNode dagNodeOriginal(originalVRayObject);
-	MString cmd = "sphere -r "_ms + data.radius + " -n RPR"_ms + dagNodeOriginal.name();
-	MStringArray arrNames = ExecuteCommandStringArrayResult(cmd);
-	if (arrNames.length() < 1)
-		throw std::runtime_error("Unexpected number of nodes selected after MEL sphere command!"s);
-	auto name = arrNames[0];
-
-	cmd = R"(shadingNode -asShader "RPRMaterial";)";
-	auto materialName = ExecuteCommandStringResult(cmd);
-	auto materialShaderGroupName = materialName + "SG";
-	cmd =
-		R"(sets -renderable true -noSurfaceShader true -empty -name("$materialShaderGroupName");
-connectAttr -f("$materialName.outColor") ("$materialShaderGroupName.surfaceShader");
-setAttr("$materialName.type") 6;
-select -r "$name";
-hyperShade -assign "$materialName";
-setAttr "$materialName.color" -type double3 $color.r $color.g $color.b;
-setAttr "$materialName.wattsPerSqm" $wattsPerSqm;
-setAttr "$name.translateX" $translate.x;
-setAttr "$name.translateY" $translate.y;
-setAttr "$name.translateZ" $translate.z;
-setAttr "$name.primaryVisibility" $display;
-setAttr "$nameShape.castsShadows" 0;
-setAttr "$nameShape.receiveShadows" 0;
+	MString cmd =
+		R"({
+string $rprCreated[] = `sphere -r $radius -n "$name"`;
+string $rprNode = $rprCreated[0];
+string $rprMaterial = `shadingNode -asShader "RPRMaterial"`;
+string $rprShadingGroup = `sets -renderable true -noSurfaceShader true -empty -name ($rprMaterial + "SG")`;
+connectAttr -f ($rprMaterial + ".outColor") ($rprShadingGroup + ".surfaceShader");
+setAttr ($rprMaterial + ".type") 6;
+sets -e -forceElement $rprShadingGroup $rprNode;
+setAttr ($rprMaterial + ".color") -type double3 $color.r $color.g $color.b;
+setAttr ($rprMaterial + ".wattsPerSqm") $wattsPerSqm;
+setAttr ($rprNode + ".translateX") $translate.x;
+setAttr ($rprNode + ".translateY") $translate.y;
+setAttr ($rprNode + ".translateZ") $translate.z;
+setAttr ($rprNode + ".primaryVisibility") $display;
+setAttr ($rprNode + "Shape.castsShadows") 0;
+setAttr ($rprNode + "Shape.receiveShadows") 0;
 
 select -r $originalName;
 doDelete;
-)";
-	cmd.substitute("$name", name);
+})";
+	cmd.substitute("$radius", toMString(data.radius));
+	cmd.substitute("$name", "RPR"_ms + dagNodeOriginal.name());
 	cmd.substitute("$originalName", dagNodeOriginal.name());
-	cmd.substitute("$materialName", materialName);
-	cmd.substitute("$materialShaderGroupName", materialShaderGroupName);
 	cmd.substitute("$color.r", toMString(data.color.r));
 	cmd.substitute("$color.g", toMString(data.color.g));
 	cmd.substitute("$color.b", toMString(data.color.b));
@@ -351,7 +348,7 @@ doDelete;
 	cmd.substitute("$translate.z", toMString(data.matrix(3, 2)));
 	cmd.substitute("$display", toMString(!data.invisible));
 
-	ExecuteCommand(cmd);
+	QueueCommand(m_nodeModifier, cmd);
 }
 
 void FireRenderConvertVRayCmd::VRayLightRectShapeConverter(MObject originalVRayObject)
@@ -359,43 +356,37 @@ void FireRenderConvertVRayCmd::VRayLightRectShapeConverter(MObject originalVRayO
 	auto data = FireMaya::VRay::readVRayLightRectData(originalVRayObject);
 
 	MFnDagNode dagNodeOriginal(originalVRayObject);
-	MString cmd = "polyPlane -w "_ms + data.uSize + " -h "_ms + data.vSize + " -sx 1 -sy 1 -ax 0 1 0 -cuv 2 -ch 1 -n \"RPR"_ms + dagNodeOriginal.name() + "\";"_ms;
-	MStringArray arrNames = ExecuteCommandStringArrayResult(cmd);
-	if (arrNames.length() < 1)
-		throw std::runtime_error("Unexpected number of nodes selected after MEL polyPlane command!"s);
-	auto name = arrNames[0];
-
-	cmd = R"(shadingNode -asShader "RPRMaterial";)";
-	auto materialName = MGlobal::executeCommandStringResult(cmd, false, true);
-	auto materialShaderGroupName = materialName + "SG";
-	cmd =
-		R"(sets -renderable true -noSurfaceShader true -empty -name("$materialShaderGroupName");
-connectAttr -f("$materialName.outColor") ("$materialShaderGroupName.surfaceShader");
-setAttr("$materialName.type") 6;
-select -r "$name";
-hyperShade -assign "$materialName";
-setAttr "$materialName.color" -type double3 $color.r $color.g $color.b;
-setAttr "$materialName.wattsPerSqm" $wattsPerSqm;
-setAttr "$name.translateX" $translate.x;
-setAttr "$name.translateY" $translate.y;
-setAttr "$name.translateZ" $translate.z;
-setAttr "$name.rotateX" $rotate.x;
-setAttr "$name.rotateY" $rotate.y;
-setAttr "$name.rotateZ" $rotate.z;
-setAttr "$name.scaleX" $scale.x;
-setAttr "$name.scaleY" $scale.y;
-setAttr "$name.scaleZ" $scale.z;
-setAttr "$name.primaryVisibility" $display;
-setAttr "$nameShape.castsShadows" 0;
-setAttr "$nameShape.receiveShadows" 0;
+	MString cmd =
+		R"({
+string $rprCreated[] = `polyPlane -w $uSize -h $vSize -sx 1 -sy 1 -ax 0 1 0 -cuv 2 -ch 1 -n "$name"`;
+string $rprNode = $rprCreated[0];
+string $rprMaterial = `shadingNode -asShader "RPRMaterial"`;
+string $rprShadingGroup = `sets -renderable true -noSurfaceShader true -empty -name ($rprMaterial + "SG")`;
+connectAttr -f ($rprMaterial + ".outColor") ($rprShadingGroup + ".surfaceShader");
+setAttr ($rprMaterial + ".type") 6;
+sets -e -forceElement $rprShadingGroup $rprNode;
+setAttr ($rprMaterial + ".color") -type double3 $color.r $color.g $color.b;
+setAttr ($rprMaterial + ".wattsPerSqm") $wattsPerSqm;
+setAttr ($rprNode + ".translateX") $translate.x;
+setAttr ($rprNode + ".translateY") $translate.y;
+setAttr ($rprNode + ".translateZ") $translate.z;
+setAttr ($rprNode + ".rotateX") $rotate.x;
+setAttr ($rprNode + ".rotateY") $rotate.y;
+setAttr ($rprNode + ".rotateZ") $rotate.z;
+setAttr ($rprNode + ".scaleX") $scale.x;
+setAttr ($rprNode + ".scaleY") $scale.y;
+setAttr ($rprNode + ".scaleZ") $scale.z;
+setAttr ($rprNode + ".primaryVisibility") $display;
+setAttr ($rprNode + "Shape.castsShadows") 0;
+setAttr ($rprNode + "Shape.receiveShadows") 0;
 
 select -r $originalName;
 doDelete;
-)";
-	cmd.substitute("$name", name);
+})";
+	cmd.substitute("$uSize", toMString(data.uSize));
+	cmd.substitute("$vSize", toMString(data.vSize));
+	cmd.substitute("$name", "RPR"_ms + dagNodeOriginal.name());
 	cmd.substitute("$originalName", dagNodeOriginal.name());
-	cmd.substitute("$materialName", materialName);
-	cmd.substitute("$materialShaderGroupName", materialShaderGroupName);
 	cmd.substitute("$color.r", toMString(data.color.r));
 	cmd.substitute("$color.g", toMString(data.color.g));
 	cmd.substitute("$color.b", toMString(data.color.b));
@@ -417,7 +408,7 @@ doDelete;
 	cmd.substitute("$scale.z", toMString(scale[1] * 2));
 	cmd.substitute("$display", toMString(!data.invisible));
 
-	ExecuteCommand(cmd);
+	QueueCommand(m_nodeModifier, cmd);
 }
 
 void FireRenderConvertVRayCmd::VRayLightDomeShapeConverter(MObject originalVRayObject)
@@ -428,39 +419,37 @@ void FireRenderConvertVRayCmd::VRayLightDomeShapeConverter(MObject originalVRayO
 
 	if (data.useDomeTexture && data.texutre.length())
 	{
-		ExecuteCommand("createIBLNodeRPR");
-		auto name = MGlobal::executeCommandStringResult("getIBLNodeRPR");
-
-		MString cmd = R"(select -r "$name";
-setAttr -type "string" "$name.filePath" "$texture";
-setAttr "$name.intensity" $intensity;
-setAttr "$name.display" $display;
+		MString cmd = R"({
+createIBLNodeRPR;
+string $rprNode = `getIBLNodeRPR`;
+select -r $rprNode;
+setAttr -type "string" ($rprNode + ".filePath") "$texture";
+setAttr ($rprNode + ".intensity") $intensity;
+setAttr ($rprNode + ".display") $display;
 
 select -r $originalName;
 doDelete;
-)";
-		cmd.substitute("$name", name);
+})";
 		cmd.substitute("$originalName", dagNodeOriginal.name());
 		cmd.substitute("$texture", data.texutre);
 		cmd.substitute("$intensity", toMString(data.intensity));
 		cmd.substitute("$display", toMString(data.visible));
 
-		ExecuteCommand(cmd);
+		QueueCommand(m_nodeModifier, cmd);
 	}
 	else
 	{
-		ExecuteCommand("createEnvLightNodeRPR");
-		auto name = MGlobal::executeCommandStringResult("getEnvLightNodeRPR");
-
-		MString cmd = R"(select -r "$name";
-setAttr "$name.color" -type double3 $color.r $color.g $color.b;
-setAttr "$name.intensity" $intensity;
-setAttr "$name.display" $display;
+		MString cmd = R"({
+createEnvLightNodeRPR;
+string $rprNode = `getEnvLightNodeRPR`;
+select -r $rprNode;
+setAttr ($rprNode + ".color") -type double3 $color.r $color.g $color.b;
+setAttr ($rprNode + ".intensity") $intensity;
+setAttr ($rprNode + ".display") $display;
 
 select -r $originalName;
 doDelete;
-)";
-		cmd.substitute("$name", name);
+})";
 		cmd.substitute("$originalName", dagNodeOriginal.name());
 		cmd.substitute("$color.r", toMString(data.color.r));
 		cmd.substitute("$color.g", toMString(data.color.g));
@@ -468,7 +457,7 @@ doDelete;
 		cmd.substitute("$intensity", toMString(data.intensity));
 		cmd.substitute("$display", toMString(data.visible));
 
-		ExecuteCommand(cmd);
+		QueueCommand(m_nodeModifier, cmd);
 	}
 }
 
@@ -504,7 +493,7 @@ doDelete;
 	cmd.substitute("$translate.y", toMString(data->position.y));
 	cmd.substitute("$translate.z", toMString(data->position.z));
 
-	ExecuteCommand(cmd);
+	QueueCommand(m_nodeModifier, cmd);
 
 	return true;
 }
@@ -622,7 +611,6 @@ bool FireRenderConvertVRayCmd::ConvertVRayShadersOn(MDagPath path)
 			return false;
 
 		bool materialAssignedToAnObject = materialCount == 1;
-		bool materialConverted = false;
 
 		for (int materialIndex = 0; materialIndex < oldMaterials.size(); materialIndex++)
 		{
@@ -633,13 +621,11 @@ bool FireRenderConvertVRayCmd::ConvertVRayShadersOn(MDagPath path)
 			{
 				MObject newShader;
 
-				MString newName;
-
 				auto oldName = shaderNode.name();
 				auto it = m_conversionObjectMap.find(oldName);
 				if (it != m_conversionObjectMap.end())
 				{
-					newName = it->second;
+					newShader = it->second;
 				}
 				else
 				{
@@ -647,21 +633,21 @@ bool FireRenderConvertVRayCmd::ConvertVRayShadersOn(MDagPath path)
 
 					if (!newShader.isNull())
 					{
-						newName = MFnDependencyNode(newShader).name();
-
-						m_conversionObjectMap[oldName] = newName;
+						m_conversionObjectMap[oldName] = newShader;
 					}
 				}
 
-				if (newName.length())
+				if (!newShader.isNull())
 				{
+					MaterialAssignment& assignment = m_assignments[oldName];
+					assignment.material = newShader;
+
 					if (materialAssignedToAnObject)
-						AssignMaterialToAnObject(fnDagNode, newName);
+						AssignMaterialToAnObject(fnDagNode, assignment.members);
 					else
-						AssignMaterialToFaces(fnDagNode, faceMaterialIndices, materialIndex, newName);
+						AssignMaterialToFaces(fnDagNode, faceMaterialIndices, materialIndex, assignment.members);
 
 					m_convertedVRayMaterials.append(oldMaterial);
-					materialConverted = true;
 				}
 
 				if (converted++)
@@ -671,23 +657,17 @@ bool FireRenderConvertVRayCmd::ConvertVRayShadersOn(MDagPath path)
 			}
 		}
 
-		if (materialConverted)
-		{
-			for (auto name : shadingGroups)
-				m_convertedVRayShadingGroups.append(name);
-		}
 	}
 
 	return ret;
 }
 
-void FireRenderConvertVRayCmd::AssignMaterialToAnObject(MFnDagNode &fnDagNode, MString material)
+void FireRenderConvertVRayCmd::AssignMaterialToAnObject(MFnDagNode &fnDagNode, MStringArray& members)
 {
-	ExecuteCommand("select -r "_ms + fnDagNode.fullPathName());
-	ExecuteCommand("hyperShade -assign "_ms + material);
+	members.append(fnDagNode.fullPathName());
 }
 
-void FireRenderConvertVRayCmd::AssignMaterialToFaces(MFnDagNode &fnDagNode, const MIntArray & faceMaterialIndices, int materialIndex, MString newMaterial)
+void FireRenderConvertVRayCmd::AssignMaterialToFaces(MFnDagNode &fnDagNode, const MIntArray & faceMaterialIndices, int materialIndex, MStringArray& members)
 {
 	auto path = fnDagNode.partialPathName();
 
@@ -720,8 +700,44 @@ void FireRenderConvertVRayCmd::AssignMaterialToFaces(MFnDagNode &fnDagNode, cons
 
 	for (auto pair : pairs)
 	{
-		ExecuteCommand("select -r "_ms + path + +".f[" + pair.first + ":" + pair.second + "]"_ms);
-		ExecuteCommand("hyperShade -assign "_ms + newMaterial);
+		members.append(path + ".f[" + pair.first + ":" + pair.second + "]"_ms);
+	}
+}
+
+void FireRenderConvertVRayCmd::PlanAssignments()
+{
+	// list created materials in Hypershade the way shadingNode -asShader does
+	for (const MObject& shader : m_createdShaders)
+	{
+		MString cmd = R"(connectAttr -na "$material.message" "defaultShaderList1.shaders";)";
+		cmd.substitute("$material", MFnDependencyNode(shader).name());
+
+		QueueCommand(m_assignModifier, cmd);
+	}
+
+	// one script per converted material, instead of a select and hyperShade call per object or face range
+	for (const auto& it : m_assignments)
+	{
+		const MaterialAssignment& assignment = it.second;
+		if (assignment.members.length() == 0)
+			continue;
+
+		MString materialName = MFnDependencyNode(assignment.material).name();
+
+		MString members;
+		for (const MString& member : assignment.members)
+			members += " \""_ms + member + "\""_ms;
+
+		MString cmd = R"({
+string $rprShadingGroup = `sets -renderable true -noSurfaceShader true -empty -name "$materialSG"`;
+connectAttr -f "$material.outColor" ($rprShadingGroup + ".surfaceShader");
+sets -e -forceElement $rprShadingGroup$members;
+})";
+		cmd.substitute("$materialSG", materialName + "SG");
+		cmd.substitute("$material", materialName);
+		cmd.substitute("$members", members);
+
+		QueueCommand(m_assignModifier, cmd);
 	}
 }
 
@@ -789,9 +805,7 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 
 	int converted = 0, failed = 0;
 
-	m_conversionObjectMap.clear();
-	m_convertedVRayMaterials.clear();
-	m_convertedVRayShadingGroups.clear();
+	TimePoint start = GetCurrentChronoTime();
 
 	if (numberOfSelectedObjects == 0)
 	{
@@ -815,10 +829,8 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 			// check for ambient light
 			if (ambientLight.isNull())
 			{
-				MFnAmbientLight light;
-				ambientLight = light.create(true);
-				light.setColor(vrayGIColor);
-				light.setIntensity(1.f);
+				QueueCommand(m_nodeModifier, "ambientLight -intensity 1 -rgb "_ms +
+					toMString(vrayGIColor.r) + " " + toMString(vrayGIColor.g) + " " + toMString(vrayGIColor.b));
 			}
 		}
 	}
@@ -845,7 +857,30 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 		}
 	}
 
-	/* auto vrayShadersDeleted = */ TryDeleteUnusedVRayMaterials();
+	TimePoint planned = GetCurrentChronoTime();
+
+	// apply the plan; material names are final only after the first modifier is done
+	status = m_nodeModifier.doIt();
+
+	if (status == MStatus::kSuccess)
+	{
+		PlanAssignments();
+		status = m_assignModifier.doIt();
+	}
+
+	if (status == MStatus::kSuccess)
+	{
+		/* auto vrayShadersDeleted = */ TryDeleteUnusedVRayMaterials();
+		status = m_cleanupModifier.doIt();
+	}
+
+	if (status != MStatus::kSuccess)
+	{
+		this->displayError("Failed to apply VRay conversion: "_ms + status.errorString());
+	}
+
+	LogPrint("VRay conversion: %d materials, plan %d ms, apply %d ms", (int) m_conversionObjectMap.size(),
+		(int) TimeDiffChrono<std::chrono::milliseconds>(planned, start), (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), planned));
 
 	MString message;
 
@@ -862,7 +897,31 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 
 	this->setResult(message);
 
-	m_conversionObjectMap.clear();
+	return status;
+}
+
+MStatus FireRenderConvertVRayCmd::redoIt()
+{
+	MStatus status = m_nodeModifier.doIt();
+
+	if (status == MStatus::kSuccess)
+		status = m_assignModifier.doIt();
+
+	if (status == MStatus::kSuccess)
+		status = m_cleanupModifier.doIt();
+
+	return status;
+}
+
+MStatus FireRenderConvertVRayCmd::undoIt()
+{
+	MStatus status = m_cleanupModifier.undoIt();
+
+	if (status == MStatus::kSuccess)
+		status = m_assignModifier.undoIt();
+
+	if (status == MStatus::kSuccess)
+		status = m_nodeModifier.undoIt();
 
 	return status;
 }
@@ -896,88 +955,75 @@ size_t FireRenderConvertVRayCmd::TryDeleteUnusedVRayMaterials()
 
 	auto uniqueConvertedMaterials = unique(m_convertedVRayMaterials);
 
-	std::vector<MString> namesToDelete;
 	for (auto vrayMaterial : uniqueConvertedMaterials)
 	{
 		MFnDependencyNode vrayDepNode(vrayMaterial);
 
-		if (!materialHasConnections(vrayDepNode))
-			namesToDelete.push_back(vrayDepNode.name());
-	}
+		if (materialHasConnections(vrayDepNode))
+			continue;
 
-	std::sort(namesToDelete.begin(), namesToDelete.end(), MStringComparison());
+		status = m_cleanupModifier.deleteNode(vrayMaterial);
 
-	for (auto name : namesToDelete)
-	{
-		try
-		{
-			ExecuteCommand("delete "_ms + name);
+		if (status == MStatus::kSuccess)
 			deleted++;
-		}
-		catch (std::exception & ex)
-		{
-			DebugPrint(("Failed to delete VRay material: "s + name.asUTF8() + " because of: "s + ex.what()).c_str());
-		}
+		else
+			DebugPrint("Failed to delete VRay material: %s because of: %s", vrayDepNode.name().asUTF8(), status.errorString().asUTF8());
 	}
 
 	return deleted;
 }
 
-void FireRenderConvertVRayCmd::ExecuteCommand(MString command)
+void FireRenderConvertVRayCmd::QueueCommand(MDGModifier& modifier, MString command)
 {
-	DebugPrint("ExecuteCommand: %s", command.asUTF8());
+	DebugPrint("QueueCommand: %s", command.asUTF8());
 
-	MStatus status = MGlobal::executeCommand(command, false, true);
+	MStatus status = modifier.commandToExecute(command);
 
 	if (status.error())
 		throw runtime_error(status.errorString().asUTF8());
 }
 
-MString FireRenderConvertVRayCmd::ExecuteCommandStringResult(MString command)
+MPlug FireRenderConvertVRayCmd::GetDeduplicatedTextureSource(const MPlug& source)
 {
-	DebugPrint("ExecuteCommandStringResult: %s", command.asUTF8());
+	MObject node = source.node();
+	if (!node.hasFn(MFn::kFileTexture))
+		return source;
 
-	MStatus status;
-	MString ret = MGlobal::executeCommandStringResult(command, false, true, &status);
+	// file nodes reading the same image with the same color space and placement are interchangeable
+	MFnDependencyNode fileNode(node);
 
-	if (status.error())
-		throw logic_error(status.errorString().asUTF8());
+	MString placement;
+	MPlugArray uvConnections;
+	MPlug uvPlug = fileNode.findPlug("uvCoord");
+	if (!uvPlug.isNull() && uvPlug.connectedTo(uvConnections, true, false) && uvConnections.length() > 0)
+		placement = MFnDependencyNode(uvConnections[0].node()).name();
 
-	DebugPrint("ExecuteCommandStringResult -> %s", ret.asUTF8());
+	std::string key = std::string(fileNode.findPlug("fileTextureName").asString().asUTF8()) + "|" +
+		fileNode.findPlug("colorSpace").asString().asUTF8() + "|" + placement.asUTF8();
 
-	return ret;
-}
-
-MStringArray FireRenderConvertVRayCmd::ExecuteCommandStringArrayResult(MString command)
-{
-	DebugPrint("ExecuteCommandStringArrayResult: %s", command.asUTF8());
-
-	MStatus status;
-	MStringArray ret;
-	status = MGlobal::executeCommand(command, ret, false, true);
+	auto it = m_textureNodes.find(key);
+	if (it == m_textureNodes.end())
+	{
+		m_textureNodes[key] = node;
+		return source;
+	}
 
-	if (status.error())
-		throw runtime_error(status.errorString().asUTF8());
+	if (it->second == node)
+		return source;
 
-	DebugPrint("ExecuteCommandStringArrayResult -> Count: %d", ret.length());
-	for (auto r : ret)
-		DebugPrint("%s", r.asUTF8());
+	MPlug shared = MFnDependencyNode(it->second).findPlug(source.attribute());
 
-	return ret;
+	return shared.isNull() ? source : shared;
 }
 
 MObject FireRenderConvertVRayCmd::CreateShader(MString type, MString oldName)
 {
-	auto command = "shadingNode -asShader "_ms + type;
-	if (oldName.length())
-		command += " -name "_ms + oldName + "_RPR"_ms;
+	MStatus status;
+	MObject shaderNode = m_nodeModifier.createNode(type, &status);
 
-	auto shaderName = this->ExecuteCommandStringResult(command);
+	if (status == MStatus::kSuccess && oldName.length())
+		m_nodeModifier.renameNode(shaderNode, oldName + "_RPR"_ms);
 
-	MSelectionList sList;
-	sList.add(shaderName);
-	MObject shaderNode;
-	sList.getDependNode(0, shaderNode);
 	if (shaderNode.isNull())
 	{
 		MGlobal::displayError("Unable to create standard shader");
@@ -985,23 +1031,30 @@ MObject FireRenderConvertVRayCmd::CreateShader(MString type, MString oldName)
 		throw logic_error(("Unable to create "_ms + type + " shader"_ms).asUTF8());
 	}
 
+	m_createdShaders.append(shaderNode);
+
 	return shaderNode;
 }
 
+// Reads from the VRay node directly and queues every write to the destination node into a modifier
 class MPlugValueHelper
 {
 	const MFnDependencyNode & m_source;
 	MFnDependencyNode m_destination;
+	MDGModifier & m_modifier;
+	std::function<MPlug(const MPlug&)> m_remapSource;
 
 public:
-	MPlugValueHelper(const MFnDependencyNode & source, MObject destination) :
+	MPlugValueHelper(const MFnDependencyNode & source, MObject destination, MDGModifier & modifier, std::function<MPlug(const MPlug&)> remapSource) :
 		m_source(source),
-		m_destination(destination)
+		m_destination(destination),
+		m_modifier(modifier),
+		m_remapSource(remapSource)
 	{
 	}
 
 public:
-	MDataHandle CopyPlugValue(const MString sourcePlugName, const MString destinationPlugName)
+	void CopyPlugValue(const MString sourcePlugName, const MString destinationPlugName)
 	{
 		MStatus status;
 		bool connection = false;
@@ -1027,14 +1080,7 @@ public:
 
 		if (!connection)
 		{
-			MDataHandle val;
-			status = sourcePlug.getValue(val);
-			if (status.error())
-				throw logic_error(("Failed to read: "_ms + sourcePlugName + ": "_ms + status.errorString()).asUTF8());
-
-			SetPlugValue(destinationPlugName, val);
-
-			return val;
+			SetPlugValue(destinationPlugName, [this, &sourcePlug](MPlug& plug) { return QueuePlugValue(sourcePlug, plug); });
 		}
 		else
 		{
@@ -1042,13 +1088,9 @@ public:
 			if (destPlug.isNull())
 				throw logic_error(("Destination plug can't be found: "_ms + destinationPlugName).asUTF8());
 
-			MDagModifier modifier;
-			modifier.connect(sourcePlug, destPlug);
-			status = modifier.doIt();
+			status = m_modifier.connect(m_remapSource(sourcePlug), destPlug);
 			if (status.error())
 				throw logic_error(("Failed to connect: "_ms + destinationPlugName + ": "_ms + status.errorString()).asUTF8());
-
-			return MDataHandle();
 		}
 	}
 
@@ -1111,24 +1153,50 @@ public:
 			throw logic_error(("Failed to write: "_ms + destinationPlugName + ": "_ms + status.errorString()).asUTF8());
 	}
 
-	void SetPlugValue(const MString destinationPlugName, MDataHandle data)
-	{
-		SetPlugValue(destinationPlugName, [&data](MPlug& plug) { return plug.setMDataHandle(data); });
-	}
-
 	void SetPlugValue(const MString destinationPlugName, bool value)
 	{
-		SetPlugValue(destinationPlugName, [value](MPlug& plug) { return plug.setBool(value); });
+		SetPlugValue(destinationPlugName, [this, value](MPlug& plug) { return m_modifier.newPlugValueBool(plug, value); });
 	}
 
 	void SetPlugValue(const MString destinationPlugName, float value)
 	{
-		SetPlugValue(destinationPlugName, [value](MPlug& plug) { return plug.setFloat(value); });
+		SetPlugValue(destinationPlugName, [this, value](MPlug& plug) { return m_modifier.newPlugValueFloat(plug, value); });
 	}
 
 	void SetPlugValue(const MString destinationPlugName, int value)
 	{
-		SetPlugValue(destinationPlugName, [value](MPlug& plug) { return plug.setInt(value); });
+		SetPlugValue(destinationPlugName, [this, value](MPlug& plug) { return m_modifier.newPlugValueInt(plug, value); });
+	}
+
+private:
+	MStatus QueuePlugValue(const MPlug& sourcePlug, MPlug& destPlug)
+	{
+		if (sourcePlug.isCompound())
+			return m_modifier.newPlugValue(destPlug, sourcePlug.asMObject());
+
+		MObject attribute = sourcePlug.attribute();
+
+		if (attribute.hasFn(MFn::kEnumAttribute))
+			return m_modifier.newPlugValueInt(destPlug, sourcePlug.asInt());
+
+		if (attribute.hasFn(MFn::kNumericAttribute))
+		{
+			switch (MFnNumericAttribute(attribute).unitType())
+			{
+			case MFnNumericData::kBoolean:
+				return m_modifier.newPlugValueBool(destPlug, sourcePlug.asBool());
+			case MFnNumericData::kShort:
+			case MFnNumericData::kInt:
+			case MFnNumericData::kLong:
+			case MFnNumericData::kByte:
+			case MFnNumericData::kChar:
+				return m_modifier.newPlugValueInt(destPlug, sourcePlug.asInt());
+			default:
+				break;
+			}
+		}
+
+		return m_modifier.newPlugValueDouble(destPlug, sourcePlug.asDouble());
 	}
 };
 
@@ -1157,7 +1225,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayMtlShader(const MFnDependencyNode &
 	MFnDependencyNode convertedShader(shaderNode);
 	if (!shaderNode.isNull())
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
+		MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 
 		helper.CopyPlugValue("dc", "diffuseColor");
 
@@ -1202,7 +1271,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayAISurfaceShader(const MFnDependency
 	MFnDependencyNode convertedShader(shaderNode);
 	if (!shaderNode.isNull())
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
+		MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 
 		helper.CopyPlugValue("diffuse", "diffuseColor");
 
@@ -1230,7 +1300,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayCarPaintShader(const MFnDependencyN
 	MFnDependencyNode convertedShader(shaderNode);
 	if (!shaderNode.isNull())
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
+		MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 
 		helper.CopyPlugValue("bcol", "diffuseColor");
 
@@ -1259,7 +1330,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayFastSSS2MtlShader(const MFnDependen
 	MFnDependencyNode convertedShader(shaderNode);
 	if (!shaderNode.isNull())
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
+		MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 
 		helper.CopyPlugValue("df", "surfaceColor");
 		helper.CopyPlugValue("dfa", "surfaceIntensity");
@@ -1283,7 +1355,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayLightMtlShader(const MFnDependencyN
 	MFnDependencyNode convertedShader(shaderNode);
 	if (!shaderNode.isNull())
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
+		MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 		helper.SetPlugValue("type", (int)FireMaya::Material::Type::kEmissive);
 
 		helper.CopyPlugValue("cl", "color");
@@ -1298,7 +1371,8 @@ MObject FireRenderConvertVRayCmd::ConvertVRayMtlWrapperShader(const MFnDependenc
 
 	MObject shaderNode;
 
-	MPlugValueHelper helper(originalVRayShader, shaderNode);
+	MPlugValueHelper helper(originalVRayShader, shaderNode, m_nodeModifier,
+			[this](const MPlug& source) { return GetDeduplicatedTextureSource(source); });
 
 	auto destination = helper.GetPlugDestination("bm");
 
@@ -21,6 +21,7 @@ limitations under the License.
 #include <maya/MSyntax.h>
 #include <maya/MArgDatabase.h>
 #include <maya/MFnDependencyNode.h>
+#include <maya/MDagModifier.h>
 
 #include "FireRenderUtils.h"
 
@@ -31,12 +32,38 @@ public:
 	virtual ~FireRenderConvertVRayCmd();
 
 private:
-	std::map<MString, MString, MStringComparison> m_conversionObjectMap;
+	struct MaterialAssignment
+	{
+		MObject material;
+		MStringArray members;	// whole shapes or face ranges
+	};
+
+	// VRay material name -> converted material
+	std::map<MString, MObject, MStringComparison> m_conversionObjectMap;
+	std::map<MString, MaterialAssignment, MStringComparison> m_assignments;
 	MObjectArray	m_convertedVRayMaterials;
-	MStringArray	m_convertedVRayShadingGroups;
+
+	// every material node created by the conversion, including blend layers and unassigned materials
+	MObjectArray	m_createdShaders;
+
+	// file texture nodes already referenced by converted materials, keyed by path, color space and placement
+	std::map<std::string, MObject> m_textureNodes;
+
+	/**
+		Conversion is planned first and applied in bulk, so the whole conversion is one undo step:
+		- m_nodeModifier: material creation, attribute values, connections and light scripts
+		- m_assignModifier: shading groups and material assignment, which need final node names
+		- m_cleanupModifier: deletion of VRay materials left without connections
+	*/
+	MDagModifier	m_nodeModifier;
+	MDagModifier	m_assignModifier;
+	MDagModifier	m_cleanupModifier;
 
 public:
 	MStatus doIt(const MArgList& args);
+	MStatus redoIt();
+	MStatus undoIt();
+	bool isUndoable() const { return true; }
 
 	static void* creator();
 
@@ -52,8 +79,9 @@ private:
 	bool ConvertVRayObject(MObject object);
 	bool ConvertVRayShadersOn(MDagPath path);
 
-	void AssignMaterialToAnObject(MFnDagNode &fnDagNode, MString newName);
-	void AssignMaterialToFaces(MFnDagNode &fnDagNode, const MIntArray & faceMaterialIndices, int materialIndex, MString newMaterial);
+	void AssignMaterialToAnObject(MFnDagNode &fnDagNode, MStringArray& members);
+	void AssignMaterialToFaces(MFnDagNode &fnDagNode, const MIntArray & faceMaterialIndices, int materialIndex, MStringArray& members);
+	void PlanAssignments();
 
 	MObject ConvertVRayShader(const MFnDependencyNode & shaderNode, MString originalName);
 
@@ -71,12 +99,10 @@ private:
 	MObject ConvertVRayMtlWrapperShader(const MFnDependencyNode & originalVRayObject, MString oldName);
 	MObject ConvertVRayBlendMtlShader(const MFnDependencyNode & originalVRayObject, MString oldName);
 
-	void ExecuteCommand(MString command);
-	MString ExecuteCommandStringResult(MString command);
-	MStringArray ExecuteCommandStringArrayResult(MString command);
+	void QueueCommand(MDGModifier& modifier, MString command);
+	MPlug GetDeduplicatedTextureSource(const MPlug& source);
 
 	MObject CreateShader(MString type, MString oldName = MString());
 	MObject tryFindAmbientLight();
 	size_t TryDeleteUnusedVRayMaterials();
 };
-
@@ -74,6 +74,7 @@ MSyntax FireRenderExportCmd::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kPadding, kPaddingLong, MSyntax::kString, MSyntax::kLong));
 	CHECK_MSTATUS(syntax.addFlag(kSelectedCamera, kSelectedCameraLong, MSyntax::kString));
 	CHECK_MSTATUS(syntax.addFlag(kLayerExportFlag, kLayerExportFlagLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kIncrementalLayersFlag, kIncrementalLayersFlagLong, MSyntax::kNoArg));
 
 	return syntax; 
 }
@@ -422,6 +423,9 @@ MStatus FireRenderExportCmd::doIt(const MArgList& args)
 
 	bool isAllLayersExportEnabled = argData.isFlagSet(kLayerExportFlag);
 
+	// keep one translated scene for all layers and only apply differences between them
+	bool isIncrementalLayersEnabled = isAllLayersExportEnabled && argData.isFlagSet(kIncrementalLayersFlag);
+
 	MString compressionOption = "None";
 	if (argData.isFlagSet(kCompressionFlag))
 	{
@@ -441,22 +445,37 @@ MStatus FireRenderExportCmd::doIt(const MArgList& args)
 			layers.append(existingRenderLayer); // will export only current layer
 		}
 
+		NorthStarContextPtr sharedContextPtr;
+
 		// process each layer
 		for (MObject layer : layers)
 		{
+			TimePoint layerStartTime = GetCurrentChronoTime();
+
 			// setup layer to export
 			MFnDependencyNode layerNodeFn(layer);
-			MGlobal::executeCommand("editRenderLayerGlobals -currentRenderLayer " + layerNodeFn.name(), false, true);
+			bool reuseContext = isIncrementalLayersEnabled && sharedContextPtr;
+
+			NorthStarContextPtr northStarContextPtr;
+			if (reuseContext)
+			{
+				northStarContextPtr = sharedContextPtr;
+				northStarContextPtr->SwitchRenderLayer(layer);
+			}
+			else
+			{
+				MGlobal::executeCommand("editRenderLayerGlobals -currentRenderLayer " + layerNodeFn.name(), false, true);
+
+				northStarContextPtr = ContextCreator::CreateNorthStarContext();
+				northStarContextPtr->SetRenderType(RenderType::ProductionRender);
+			}
 
 			// initialize
 			MCommonRenderSettingsData settings;
 			MRenderUtil::getCommonRenderSettings(settings);
 
-			NorthStarContextPtr northStarContextPtr = ContextCreator::CreateNorthStarContext();
 			AnimationExporter animationExporter(false);
 
-			northStarContextPtr->SetRenderType(RenderType::ProductionRender);
-
 			MDagPathArray cameras = GetSceneCameras();
 			unsigned int countCameras = cameras.length();
 
@@ -494,7 +513,16 @@ MStatus FireRenderExportCmd::doIt(const MArgList& args)
 				}
 			}
 
-			northStarContextPtr->buildScene(false, false, false);
+			if (!reuseContext)
+			{
+				northStarContextPtr->buildScene(false, false, false);
+
+				if (isIncrementalLayersEnabled)
+				{
+					sharedContextPtr = northStarContextPtr;
+				}
+			}
+
 			northStarContextPtr->setResolution(settings.width, settings.height, true);
 
 			// setup frame ranges
@@ -615,6 +643,10 @@ MStatus FireRenderExportCmd::doIt(const MArgList& args)
 					return MS::kFailure;
 				}
 			}
+
+			LogPrint("Layer %s exported in %d ms (%s)", layerNodeFn.name().asUTF8(),
+				(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), layerStartTime),
+				reuseContext ? "incremental" : "full translation");
 		}
 		// restore existing render layer
 		MFnDependencyNode existingLayerNodeFn(existingRenderLayer);
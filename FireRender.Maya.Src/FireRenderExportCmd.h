@@ -34,6 +34,8 @@ limitations under the License.
 #define kSelectedCameraLong "-camera"
 #define kLayerExportFlag "-l"
 #define kLayerExportFlagLong "-layers"
+#define kIncrementalLayersFlag "-il"
+#define kIncrementalLayersFlagLong "-incrementalLayers"
 
 
 class FireRenderExportCmd : public MPxCommand
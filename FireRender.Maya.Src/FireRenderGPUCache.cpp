@@ -77,6 +77,7 @@ bool FireRenderGPUCache::IsMeshVisible(const MDagPath& meshPath, const FireRende
 void FireRenderGPUCache::clear()
 {
 	m.elements.clear();
+	InvalidateAttributeSnapshot();
 	FireRenderObject::clear();
 }
 
@@ -307,6 +308,7 @@ void FireRenderGPUCache::ReloadMesh(const MDagPath& meshPath)
 
 	setVisibility(false);
 	m.elements.clear();
+	InvalidateAttributeSnapshot();
 
 	// node is not visible => skip
 	if (!IsMeshVisible(meshPath, this->context()))
@@ -188,6 +188,7 @@ namespace
         MObject tileRenderEnabled;
         MObject tileRenderX;
         MObject tileRenderY;
+        MObject tileRenderContexts;
     }
 
 	namespace ViewportRenderAttributes
@@ -202,6 +203,8 @@ namespace
 		MObject thumbnailIterCount;
 		MObject renderMode;
 		MObject motionBlur;
+		MObject halfFloatTexture;
+		MObject textureUploadStats;
 
 		// Other tabs
 		MObject completionCriteriaHours;
@@ -644,6 +647,14 @@ void FireRenderGlobals::createTileRenderAttributes()
 	nAttr.setSoftMax(tileDefaultSizeMax);
 
 	CHECK_MSTATUS(addAttribute(FinalRenderAttributes::tileRenderY));
+
+	// number of contexts rendering different tiles concurrently
+	FinalRenderAttributes::tileRenderContexts = nAttr.create("tileRenderContexts", "trc", MFnNumericData::kInt, 1, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(1);
+	nAttr.setSoftMax(8);
+
+	CHECK_MSTATUS(addAttribute(FinalRenderAttributes::tileRenderContexts));
 }
 
 void FireRenderGlobals::createCryptomatteAttributes()
@@ -1247,6 +1258,14 @@ void FireRenderGlobals::createViewportAttributes()
 	ViewportRenderAttributes::renderMode = createRenderModeAttr("renderModeViewport", "vrm", eAttr);
 	addAsGlobalAttribute(eAttr);
 
+	ViewportRenderAttributes::halfFloatTexture = nAttr.create("viewportHalfFloatTexture", "vhft", MFnNumericData::kBoolean, false, &status);
+	MAKE_INPUT(nAttr);
+	addAsGlobalAttribute(nAttr);
+
+	ViewportRenderAttributes::textureUploadStats = nAttr.create("viewportTextureUploadStats", "vtus", MFnNumericData::kBoolean, false, &status);
+	MAKE_INPUT(nAttr);
+	addAsGlobalAttribute(nAttr);
+
 	ViewportRenderAttributes::maxRayDepth = nAttr.create("maxRayDepthViewport", "mrdV", MFnNumericData::kInt, 8, &status);
 	MAKE_INPUT(nAttr);
 	nAttr.setMin(rayDepthParameterMin);
@@ -13,6 +13,7 @@ limitations under the License.
 #include "common.h"
 #include "frWrap.h"
 #include "FireRenderImageUtil.h"
+#include "AOVChannelInterleaver.h"
 #include <maya/MGlobal.h>
 #include <maya/MImage.h>
 #include <string>
@@ -148,8 +149,8 @@ void FireRenderImageUtil::saveMayaImage(MString filePath, unsigned int width, un
 bool FireRenderImageUtil::saveMultichannelAOVs(MString filePath,
 	unsigned int width, unsigned int height, unsigned int imageFormat, FireRenderAOVs& aovs)
 {
-	std::vector<int> aovs_component_count;
-	aovs_component_count.resize(RPR_AOV_MAX, 0);
+	// channel sources in the same order as channels are added to image spec
+	std::vector<AOVChannelSource> channelSources;
 
 	auto outImage = OIIO::ImageOutput::create(filePath.asUTF8());
 	if (!outImage)
@@ -214,38 +215,17 @@ bool FireRenderImageUtil::saveMultichannelAOVs(MString filePath,
 			imgSpec.channelformats.push_back(channelFormat);
 		}
 
-		aovs_component_count[aov.id] = aov_component_count;
+		if (aov_component_count > 0)
+		{
+			channelSources.push_back({ &aov.pixels.get()->r, (unsigned int) (sizeof(RV_PIXEL) / sizeof(float)), (unsigned int) aov_component_count });
+		}
 	});
 
 	size_t pixel_size = imgSpec.nchannels;
 	std::vector<float> pixels_for_oiio;
 	pixels_for_oiio.resize(imgSpec.image_pixels() * pixel_size);
 
-	//interleave aov components for OIIO(each pixel contains all channels data)
-	for (unsigned int y = 0; y < height; ++y)
-	{
-		for (unsigned int x = 0; x < width; ++x)
-		{
-			unsigned int pixel_index = x + y * width;
-
-			float* pixel = pixels_for_oiio.data() + pixel_size * pixel_index;
-
-			aovs.ForEachActiveAOV([&](FireRenderAOV& aov)
-			{
-				if (aov.id == RPR_AOV_DEEP_COLOR)
-				{
-					return;
-				}
-
-				int aov_component_count = aovs_component_count[aov.id];
-				if (aov_component_count)
-				{
-					auto aov_pixel = aov.pixels.get()[pixel_index];
-					pixel = std::copy(&aov_pixel.r, (&aov_pixel.r) + aov_component_count, pixel);
-				}
-			});
-		}
-	}
+	InterleaveAOVChannels(channelSources, width, height, pixel_size, pixels_for_oiio.data());
 
 	if (outImage->open(filePath.asUTF8(), imgSpec))
 	{
@@ -58,7 +58,10 @@ FireRenderIpr::~FireRenderIpr()
 	stop();
 	if (m_contextPtr)
 	{
-		m_contextPtr->cleanScene();
+		FireRenderContextPtr refToKeepAlive = m_contextPtr;
+		m_contextPtr.reset();
+
+		refToKeepAlive->cleanSceneAsync(refToKeepAlive);
 	}
 	m_previousSelectionList.clear();
 }
@@ -335,7 +338,7 @@ bool FireRenderIpr::stop()
 void FireRenderIpr::OnBufferAvailableCallback(float progress)
 {
 	{
-		AutoMutexLock pixelsLock(m_pixelsLock);
+		AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 		readFrameBuffer();
 	}
@@ -382,12 +385,12 @@ bool FireRenderIpr::RunOnViewportThread()
 				m_finishedFrame = false;
 
 				// Render.
-				AutoMutexLock contextLock(m_contextLock);
+				AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 				m_contextPtr->render(false);
 
 				// Read the frame buffer.
 				{
-					AutoMutexLock pixelsLock(m_pixelsLock);
+					AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 					readFrameBuffer();
 				}
 
@@ -492,7 +495,7 @@ void FireRenderIpr::CheckSelection()
 	{
 		FireRenderThread::RunOnceProcAndWait([&]()
 		{
-			AutoMutexLock contextLock(m_contextLock);
+			AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 
 			for (MItSelectionList it(currSelectionList); !it.isDone(); it.next())
 			{
@@ -551,7 +554,7 @@ void FireRenderIpr::updateRenderView()
 
 	{
 		// Acquire the pixels lock.
-		AutoMutexLock pixelsLock(m_pixelsLock);
+		AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 		RenderViewUpdater::UpdateAndRefreshRegion(m_pixels.data(), m_region.getWidth(), m_region.getHeight(), m_region);
 
@@ -649,15 +652,15 @@ void FireRenderIpr::refreshContext()
 
 	FireRenderThread::RunOnceProcAndWait([this]()
 	{
-		AutoMutexLock contextLock(m_contextLock);
+		AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 		m_contextPtr->Freshen(false);
 	});
 }
 
 void FireRenderIpr::SwitchCurrentAOVToBeDisplayed(int newAOV)
 {
-	AutoMutexLock contextLock(m_contextLock);
-	AutoMutexLock pixelsLock(m_pixelsLock);
+	AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
+	AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 	if (ShouldOldAOVBeDisabled(m_currentAOVToDisplay))
 	{
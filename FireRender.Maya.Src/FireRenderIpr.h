@@ -165,12 +165,12 @@ private:
 	std::atomic<bool> m_renderViewUpdateScheduled;
 
 	/** A lock to control access to the system memory frame buffer pixels. */
-	std::mutex m_pixelsLock;
+	RPR::ProfiledMutex m_pixelsLock{ "Ipr::pixels" };
 
 	std::mutex m_refreshLock;
 
 	/** A lock to control access to the RPR context. */
-	std::mutex m_contextLock;
+	RPR::ProfiledMutex m_contextLock{ "Ipr::context" };
 
 	/** Error handler. */
 	FireRenderError m_error;
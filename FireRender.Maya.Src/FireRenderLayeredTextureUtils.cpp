@@ -12,6 +12,102 @@ limitations under the License.
 ********************************************************************/
 #pragma once
 #include <FireRenderLayeredTextureUtils.h>
+#include "MayaStandardNodesSupport/FileNodeConverter.h"
+
+#include <maya/MImage.h>
+#include <maya/MPlugArray.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <thread>
+
+namespace
+{
+	// Backdoor to enable flattening of eligible layered textures into a single image
+	bool IsLayeredTextureBakingEnabled()
+	{
+		char* result = std::getenv("RPR_MAYA_BAKE_LAYERED_TEXTURES");
+
+		return result != nullptr && std::string(result) == "1";
+	}
+
+	float Luminance(const float* rgb)
+	{
+		// same weights as MaterialSystem::ValueConvertToLuminance
+		return rgb[0] * 0.3f + rgb[1] * 0.59f + rgb[2] * 0.11f;
+	}
+
+	// Linear rgba pixels of a file texture, alpha already resolved the way FileNodeConverter does it
+	struct BakeSourceImage
+	{
+		std::vector<float> pixels;
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+		bool Load(const MFnDependencyNode& fileNode)
+		{
+			MString path = fileNode.findPlug("computedFileTextureNamePattern").asString();
+
+			MImage image;
+			if (image.readFromFile(path, MImage::kFloat) != MStatus::kSuccess)
+				return false;
+
+			image.getSize(width, height);
+			const float* source = image.floatPixels();
+			if (width == 0 || height == 0 || source == nullptr)
+				return false;
+
+			float gamma = MayaStandardNodeConverters::FileNodeConverter::ColorSpace2Gamma(fileNode.findPlug("colorSpace").asString());
+			bool alphaIsLuminance = fileNode.findPlug("alphaIsLuminance").asBool() || !fileNode.findPlug("fileHasAlpha").asBool();
+
+			pixels.resize(width * height * 4);
+			for (size_t index = 0; index < pixels.size(); index += 4)
+			{
+				for (size_t channel = 0; channel < 3; channel++)
+					pixels[index + channel] = std::pow(std::max(source[index + channel], 0.0f), gamma);
+
+				pixels[index + 3] = alphaIsLuminance ? Luminance(&pixels[index]) : source[index + 3];
+			}
+
+			return true;
+		}
+
+		// bilinear, u and v are in [0, 1]
+		void Sample(float u, float v, float* rgba) const
+		{
+			float x = std::max(u * width - 0.5f, 0.0f);
+			float y = std::max(v * height - 0.5f, 0.0f);
+
+			unsigned int x0 = std::min((unsigned int) x, width - 1);
+			unsigned int y0 = std::min((unsigned int) y, height - 1);
+			unsigned int x1 = std::min(x0 + 1, width - 1);
+			unsigned int y1 = std::min(y0 + 1, height - 1);
+
+			float fx = x - x0;
+			float fy = y - y0;
+
+			const float* p00 = &pixels[(y0 * width + x0) * 4];
+			const float* p10 = &pixels[(y0 * width + x1) * 4];
+			const float* p01 = &pixels[(y1 * width + x0) * 4];
+			const float* p11 = &pixels[(y1 * width + x1) * 4];
+
+			for (unsigned int channel = 0; channel < 4; channel++)
+			{
+				float top = p00[channel] + (p10[channel] - p00[channel]) * fx;
+				float bottom = p01[channel] + (p11[channel] - p01[channel]) * fx;
+				rgba[channel] = top + (bottom - top) * fy;
+			}
+		}
+	};
+
+	struct BakeChannel
+	{
+		int image = -1;		// index of the source image, constant value when negative
+		float value[3] = { 0.0f, 0.0f, 0.0f };
+	};
+}
 
 MayaStandardNodeConverters::LayeredTextureConverter::LayeredTextureConverter(const MayaStandardNodeConverters::ConverterParams& params) : BaseConverter(params)
 {
@@ -56,6 +152,341 @@ frw::Value MayaStandardNodeConverters::LayeredTextureConverter::ProcessLayers(co
 	}
 }
 
+void MayaStandardNodeConverters::LayeredTextureConverter::PruneLayers(std::vector<LayerInfoType>& layers) const
+{
+	// Layers are ordered top to bottom. Nothing under a replacing layer is visible
+	for (size_t index = 0; index < layers.size(); index++)
+	{
+		const LayerInfoType& layer = layers[index];
+
+		bool isOpaque = layer.alpha.IsFloat() && layer.alpha.GetX() >= 1.0f;
+
+		if (layer.mode == MayaLayeredTextureBlendMode::None ||
+			(layer.mode == MayaLayeredTextureBlendMode::Over && isOpaque))
+		{
+			layers.resize(index + 1);
+			break;
+		}
+	}
+
+	// Fully transparent layers leave both color and alpha untouched in every mode but None and In.
+	// The last layer is kept so that the result is still blended with the default background
+	for (auto layer = layers.begin(); layer != layers.end() && layers.size() > 1; )
+	{
+		bool isTransparent = layer->alpha.IsFloat() && layer->alpha.GetX() <= 0.0f;
+
+		if (isTransparent &&
+			layer->mode != MayaLayeredTextureBlendMode::None &&
+			layer->mode != MayaLayeredTextureBlendMode::In)
+		{
+			layer = layers.erase(layer);
+		}
+		else
+		{
+			layer++;
+		}
+	}
+}
+
+frw::Value MayaStandardNodeConverters::LayeredTextureConverter::BakeLayers(const std::vector<LayerInfoType>& layers, bool alphaIsLuminance) const
+{
+	if (!IsLayeredTextureBakingEnabled() || layers.size() < 2 || m_params.scope.GetIContextInfo()->IsGLTFExport())
+		return nullptr;
+
+	bool isColorOutput = m_params.outPlugName == OUTPUT_COLOR_ATTRIBUTE_NAME;
+	bool isAlphaOutput = m_params.outPlugName == OUTPUT_ALPHA_ATTRIBUTE_NAME;
+	if (!isColorOutput && !isAlphaOutput)
+		return nullptr;
+
+	// Same rules as GetLayerInfo: alpha output with alphaIsLuminance takes layer alpha from its color
+	bool needColor = isColorOutput || alphaIsLuminance;
+	bool alphaFromColor = isAlphaOutput && alphaIsLuminance;
+
+	std::vector<MObject> fileNodes;
+	MObject uvSourceNode;
+	std::string key = m_params.outPlugName.asUTF8();
+
+	// Layer inputs are either unconnected constants or file textures sampled with the same UV source
+	auto resolveChannel = [&](const MPlug& plug, bool isColor, BakeChannel& channel) -> bool
+	{
+		MPlugArray connections;
+		plug.connectedTo(connections, true, false);
+
+		if (connections.length() == 0)
+		{
+			for (unsigned int component = 0; component < 3; component++)
+			{
+				channel.value[component] = isColor ? plug.child(component).asFloat() : plug.asFloat();
+				key += "|" + std::to_string(channel.value[component]);
+			}
+
+			return true;
+		}
+
+		MObject sourceNode = connections[0].node();
+		if (!sourceNode.hasFn(MFn::kFileTexture))
+			return false;
+
+		MString sourceAttribute = MFnAttribute(connections[0].attribute()).name();
+		if (sourceAttribute != (isColor ? "outColor" : "outAlpha"))
+			return false;
+
+		// UDIMs and image sequences can't be flattened into one image
+		const int fileNodeUdimMode = 3;
+		MFnDependencyNode fileNode(sourceNode);
+		if (fileNode.findPlug("uvTilingMode").asInt() == fileNodeUdimMode || fileNode.findPlug("useFrameExtension").asBool())
+			return false;
+
+		MObject uvSource = FireMaya::GetConnectedNode(fileNode.findPlug("uvCoord"));
+		if (fileNodes.empty())
+			uvSourceNode = uvSource;
+		else if (uvSource != uvSourceNode)
+			return false;
+
+		auto it = std::find(fileNodes.begin(), fileNodes.end(), sourceNode);
+		channel.image = (int) std::distance(fileNodes.begin(), it);
+		if (it == fileNodes.end())
+			fileNodes.push_back(sourceNode);
+
+		key += "|" + std::string(fileNode.findPlug("computedFileTextureNamePattern").asString().asUTF8()) +
+			":" + fileNode.findPlug("colorSpace").asString().asUTF8() +
+			":" + std::to_string(fileNode.findPlug("alphaIsLuminance").asBool()) +
+			":" + std::to_string(fileNode.findPlug("fileHasAlpha").asBool());
+
+		return true;
+	};
+
+	struct BakeLayer
+	{
+		MayaLayeredTextureBlendMode mode;
+		BakeChannel color;
+		BakeChannel alpha;
+	};
+
+	std::vector<BakeLayer> bakeLayers;
+	bakeLayers.reserve(layers.size());
+
+	for (const LayerInfoType& layer : layers)
+	{
+		BakeLayer bakeLayer;
+		bakeLayer.mode = layer.mode;
+		key += "|" + std::to_string((int) layer.mode);
+
+		if (needColor && !resolveChannel(layer.colorPlug, true, bakeLayer.color))
+			return nullptr;
+
+		if (!alphaFromColor && !resolveChannel(layer.alphaPlug, false, bakeLayer.alpha))
+			return nullptr;
+
+		bakeLayers.push_back(bakeLayer);
+	}
+
+	// Procedural layers stay analytic
+	if (fileNodes.empty())
+		return nullptr;
+
+	if (!uvSourceNode.isNull())
+		key += "|" + std::string(MFnDependencyNode(uvSourceNode).name().asUTF8());
+
+	MString cacheKey = MString("layeredTexture:") + std::to_string(std::hash<std::string>()(key)).c_str();
+
+	frw::Image image = m_params.scope.GetCachedImage(cacheKey);
+
+	if (!image.IsValid())
+	{
+		std::vector<BakeSourceImage> sourceImages(fileNodes.size());
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+		for (size_t index = 0; index < fileNodes.size(); index++)
+		{
+			if (!sourceImages[index].Load(MFnDependencyNode(fileNodes[index])))
+				return nullptr;
+
+			width = std::max(width, sourceImages[index].width);
+			height = std::max(height, sourceImages[index].height);
+		}
+
+		std::vector<float> pixels(width * height * 3);
+
+		auto blendRows = [&](unsigned int firstRow, unsigned int lastRow)
+		{
+			float foreground[4];
+			float background[4];
+			float sample[4];
+
+			for (unsigned int y = firstRow; y < lastRow; y++)
+			{
+				// MImage rows go bottom to top, rpr images top to bottom
+				float* destination = &pixels[(height - y - 1) * width * 3];
+
+				for (unsigned int x = 0; x < width; x++)
+				{
+					float u = (x + 0.5f) / width;
+					float v = (y + 0.5f) / height;
+
+					background[0] = background[1] = background[2] = 0.0f;
+					background[3] = 1.0f;
+
+					// Reverse order because layers calculated right to left
+					for (auto layer = bakeLayers.rbegin(); layer != bakeLayers.rend(); layer++)
+					{
+						if (layer->color.image >= 0)
+						{
+							sourceImages[layer->color.image].Sample(u, v, sample);
+							std::copy(sample, sample + 3, foreground);
+						}
+						else
+						{
+							std::copy(layer->color.value, layer->color.value + 3, foreground);
+						}
+
+						if (alphaFromColor)
+						{
+							foreground[3] = Luminance(foreground);
+						}
+						else if (layer->alpha.image >= 0)
+						{
+							sourceImages[layer->alpha.image].Sample(u, v, sample);
+							foreground[3] = sample[3];
+						}
+						else
+						{
+							foreground[3] = layer->alpha.value[0];
+						}
+
+						BlendPixelWithLayer(layer->mode, foreground, background);
+					}
+
+					for (unsigned int channel = 0; channel < 3; channel++)
+					{
+						destination[x * 3 + channel] = isColorOutput ?
+							std::min(std::max(background[channel], 0.0f), 1.0f) : background[3];
+					}
+				}
+			}
+		};
+
+		// Blend bands of rows in parallel
+		unsigned int taskCount = std::max(std::thread::hardware_concurrency(), 1u);
+		unsigned int rowsPerTask = (height + taskCount - 1) / taskCount;
+
+		std::vector<std::future<void>> tasks;
+		for (unsigned int firstRow = 0; firstRow < height; firstRow += rowsPerTask)
+		{
+			tasks.push_back(std::async(std::launch::async, blendRows, firstRow, std::min(firstRow + rowsPerTask, height)));
+		}
+
+		for (auto& task : tasks)
+			task.get();
+
+		rpr_image_format format = { 3, RPR_COMPONENT_TYPE_FLOAT32 };
+
+		rpr_image_desc desc = {};
+		desc.image_width = width;
+		desc.image_height = height;
+		desc.image_row_pitch = width * 3 * sizeof(float);
+
+		image = frw::Image(m_params.scope.Context(), format, desc, pixels.data());
+		if (!image.IsValid())
+			return nullptr;
+
+		image.SetName(cacheKey.asUTF8());
+		m_params.scope.SetCachedImage(cacheKey, image);
+
+		DebugPrint("LayeredTexture: %s flattened %d layers into %ux%u image", m_params.shaderNode.name().asUTF8(), (int) bakeLayers.size(), width, height);
+	}
+
+	frw::ImageNode imageNode(m_params.scope.MaterialSystem());
+	imageNode.SetMap(image);
+
+	frw::Value uvValue = m_params.scope.GetConnectedValue(MFnDependencyNode(fileNodes[0]).findPlug("uvCoord"));
+	if (!uvValue.IsNull())
+		imageNode.SetValue(RPR_MATERIAL_INPUT_UV, uvValue);
+
+	if (isColorOutput)
+		return imageNode;
+
+	return frw::Value(imageNode).SelectX();
+}
+
+void MayaStandardNodeConverters::LayeredTextureConverter::BlendPixelWithLayer(MayaLayeredTextureBlendMode mode, const float* foreground, float* background)
+{
+	float alpha = foreground[3];
+
+	for (unsigned int channel = 0; channel < 3; channel++)
+	{
+		float fg = foreground[channel];
+		float bg = background[channel];
+
+		switch (mode)
+		{
+		case MayaLayeredTextureBlendMode::None:
+			bg = fg;
+			break;
+		case MayaLayeredTextureBlendMode::Over:
+			bg = bg + (fg - bg) * alpha;
+			break;
+		case MayaLayeredTextureBlendMode::In:
+			bg = bg * alpha;
+			break;
+		case MayaLayeredTextureBlendMode::Out:
+			bg = bg * (1.0f - alpha);
+			break;
+		case MayaLayeredTextureBlendMode::Add:
+			bg = bg + fg * alpha;
+			break;
+		case MayaLayeredTextureBlendMode::Subtract:
+			bg = bg - fg * alpha;
+			break;
+		case MayaLayeredTextureBlendMode::Multiply:
+			bg = (fg * alpha + 1.0f - alpha) * bg;
+			break;
+		case MayaLayeredTextureBlendMode::Difference:
+			bg = std::abs(fg - bg) * alpha + bg * (1.0f - alpha);
+			break;
+		case MayaLayeredTextureBlendMode::Lighten:
+			bg = std::max(fg, bg) * alpha + (1.0f - alpha) * bg;
+			break;
+		case MayaLayeredTextureBlendMode::Darken:
+			bg = std::min(fg, bg) * alpha + (1.0f - alpha) * bg;
+			break;
+		case MayaLayeredTextureBlendMode::Saturate:
+			bg = bg * (1.0f + fg * alpha);
+			break;
+		case MayaLayeredTextureBlendMode::Desatureate:
+			bg = bg * (1.0f - fg * alpha);
+			break;
+		case MayaLayeredTextureBlendMode::Illuminate:
+			bg = bg * (2.0f * fg * alpha + 1.0f - alpha);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		background[channel] = bg;
+	}
+
+	switch (mode)
+	{
+	case MayaLayeredTextureBlendMode::None:
+		background[3] = alpha;
+		break;
+	case MayaLayeredTextureBlendMode::Over:
+		background[3] = background[3] + alpha - background[3] * alpha;
+		break;
+	case MayaLayeredTextureBlendMode::In:
+		background[3] = background[3] * alpha;
+		break;
+	case MayaLayeredTextureBlendMode::Out:
+		background[3] = background[3] * (1.0f - alpha);
+		break;
+	default:
+		break;
+	}
+}
+
 frw::Value MayaStandardNodeConverters::LayeredTextureConverter::BlendColorValueWithLayer(const frw::Value& backgroundValue, const LayerInfoType& foregroundLayer) const
 {
 	switch (foregroundLayer.mode)
@@ -195,10 +626,12 @@ frw::Value MayaStandardNodeConverters::LayeredTextureConverter::BlendAlphaValueW
 
 MayaStandardNodeConverters::LayeredTextureConverter::LayerInfoType MayaStandardNodeConverters::LayeredTextureConverter::GetLayerInfo(const MPlug& inputsPlug, bool alphaIsLuminance) const
 {
-	MayaLayeredTextureBlendMode blendMode;
+	MayaLayeredTextureBlendMode blendMode = MayaLayeredTextureBlendMode::None;
 	frw::Value color;
 	frw::Value alpha;
-	bool isVisible;
+	bool isVisible = false;
+	MPlug colorPlug;
+	MPlug alphaPlug;
 
 	// Parse attibutes
 	for (unsigned childIndex = 0; childIndex < inputsPlug.numChildren(); childIndex++)
@@ -217,6 +650,8 @@ MayaStandardNodeConverters::LayeredTextureConverter::LayerInfoType MayaStandardN
 		}
 		else if (attrName == COLOR_ATTRIBUTE_NAME)
 		{
+			colorPlug = childPlug;
+
 			// Color should be parsed when alphaIsLuminance too
 			if (m_params.outPlugName == OUTPUT_COLOR_ATTRIBUTE_NAME || alphaIsLuminance)
 			{
@@ -225,6 +660,8 @@ MayaStandardNodeConverters::LayeredTextureConverter::LayerInfoType MayaStandardN
 		}
 		else if (attrName == ALPHA_ATTRIBUTE_NAME)
 		{
+			alphaPlug = childPlug;
+
 			if (m_params.outPlugName == OUTPUT_ALPHA_ATTRIBUTE_NAME && alphaIsLuminance)
 			{
 				// Color parsed before alpha, so we must have valid value
@@ -243,7 +680,7 @@ MayaStandardNodeConverters::LayeredTextureConverter::LayerInfoType MayaStandardN
 		}
 	}
 
-	return { blendMode, color, alpha, isVisible };
+	return { blendMode, color, alpha, isVisible, colorPlug, alphaPlug };
 }
 
 frw::Value MayaStandardNodeConverters::LayeredTextureConverter::Convert() const
@@ -267,5 +704,11 @@ frw::Value MayaStandardNodeConverters::LayeredTextureConverter::Convert() const
 		}
 	}
 
+	PruneLayers(layers);
+
+	frw::Value bakedValue = BakeLayers(layers, alphaIsLuminance);
+	if (!bakedValue.IsNull())
+		return bakedValue;
+
 	return ProcessLayers(layers);
 }
@@ -43,6 +43,8 @@ namespace MayaStandardNodeConverters
 			frw::Value color;
 			frw::Value alpha;
 			bool isVisible;
+			MPlug colorPlug;
+			MPlug alphaPlug;
 		};
 
 		// Output attributes
@@ -69,6 +71,18 @@ namespace MayaStandardNodeConverters
 		/** Iterates through array of LayerInfoType and blends them */
 		frw::Value ProcessLayers(const std::vector<LayerInfoType>& layers) const;
 
+		/** Drops layers that can't change the result: fully transparent ones and everything under an opaque layer */
+		void PruneLayers(std::vector<LayerInfoType>& layers) const;
+
+		/**
+			Optional pre-bake of layers made only of constants and file textures sharing one UV source.
+			Composites them on the CPU into a single image, returns null value if layers aren't eligible
+		*/
+		frw::Value BakeLayers(const std::vector<LayerInfoType>& layers, bool alphaIsLuminance) const;
+
+		/** CPU counterpart of BlendColorValueWithLayer and BlendAlphaValueWithLayer, rgba blended in place */
+		static void BlendPixelWithLayer(MayaLayeredTextureBlendMode mode, const float* foreground, float* background);
+
 		/**
 			Blends layer with previous calculated value
 			Ignores background alpha value
@@ -65,6 +65,8 @@ bool FireRenderMaterialSwatchRender::doIteration()
 
 		if (IsFRNode())
 		{
+			m_requestTime = GetCurrentChronoTime();
+
 			if (!setupFRNode())
 			{
 				return true;
@@ -108,8 +110,10 @@ bool FireRenderMaterialSwatchRender::setupFRNode()
 	{
 		FireRenderSwatchInstance& swatchInstance = getSwatchInstance();
 
-		m_shader = swatchInstance.getContext().GetShader(mnode);
-		m_volumeShader = swatchInstance.getContext().GetVolumeShader(mnode);
+		// The swatch scene stays resident and has no dirty callbacks, so the material itself is always
+		// parsed again. Textures are still picked up from the image cache
+		m_shader = swatchInstance.getContext().GetShader(mnode, MObject(), nullptr, true);
+		m_volumeShader = swatchInstance.getContext().GetVolumeShader(mnode, true);
 
 		m_resolution = resolution();
 
@@ -192,6 +196,8 @@ bool FireRenderMaterialSwatchRender::finalizeRendering()
 
 	finishParallelRender();
 
+	LogPrint("Swatch rendered in %d ms", (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_requestTime));
+
 	return true;
 }
 
@@ -262,7 +268,7 @@ void FireRenderMaterialSwatchRender::cancelParallelRendering()
 {
 	DebugPrint("FireRenderMaterialSwatchRender::cancelParallelRendering()");
 
-	getSwatchInstance().removeFromQueue(this);
+	FireRenderSwatchInstance::RemoveFromQueue(this);
 
 	m_cancelAsyncRender = true;
 
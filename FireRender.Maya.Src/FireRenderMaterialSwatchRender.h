@@ -69,6 +69,9 @@ private:
 
 	int m_resolution;
 
+	// request to image latency
+	TimePoint m_requestTime;
+
 	// for cancelation synchronization
 	std::mutex m_cancellationMutex;
 	std::condition_variable m_cancellationCondVar;
@@ -434,6 +434,11 @@ void FireRenderObject::ClearCallbacks()
 	m.callbackId.clear();
 }
 
+void FireRenderObject::DetachFromMaya()
+{
+	ClearCallbacks();
+}
+
 void FireRenderObject::OnNodeDirty()
 {
 	setDirty();
@@ -581,6 +586,14 @@ void FireRenderNode::RecordPortalState(MObject node)
 	m_visiblePortals.push_back(std::make_pair(node, castsShadows));
 }
 
+void FireRenderNode::DetachFromMaya()
+{
+	FireRenderObject::DetachFromMaya();
+
+	// portal meshes had castsShadows changed while attached
+	RestorePortalStates();
+}
+
 void FireRenderNode::RestorePortalStates()
 {
 	for (auto portal : m_visiblePortals)
@@ -826,6 +839,7 @@ void FireRenderMesh::buildSphere()
 		polyCountArray, 400))
 	{
 		m.elements.push_back( FrElement{ sphere } );
+		InvalidateAttributeSnapshot();
 	}
 }
 
@@ -837,58 +851,47 @@ void FireRenderMesh::SetReloadedSafe()
 	}
 }
 
-void FireRenderMeshCommon::setRenderStats(MDagPath dagPath)
+bool FireRenderMeshCommon::UpdateAttributeSnapshot(const MDagPath& dagPath)
 {
-	MFnDependencyNode depNode(dagPath.node());
+	MeshAttributeSnapshot snapshot;
+	MeshAttributeDescriptor::Get(dagPath).Read(dagPath, snapshot);
 
-	MPlug visibleInReflectionsPlug = depNode.findPlug("visibleInReflections");
-	bool visibleInReflections;
-	visibleInReflectionsPlug.getValue(visibleInReflections);
+	bool changed = !m_attributes.valid || (snapshot != m_attributes.snapshot);
 
-	MPlug visibleInRefractionsPlug = depNode.findPlug("visibleInRefractions");
-	bool visibleInRefractions;
-	visibleInRefractionsPlug.getValue(visibleInRefractions);
+	m_attributes.snapshot = snapshot;
+	m_attributes.valid = true;
+	m_attributes.changed = changed;
 
-	MPlug castsShadowsPlug = depNode.findPlug("castsShadows");
-	bool castsShadows;
-	castsShadowsPlug.getValue(castsShadows);
-
-	MPlug receivesShadowsPlug = depNode.findPlug("receiveShadows");
-	bool receiveShadows;
-	receivesShadowsPlug.getValue(receiveShadows);
-
-	MPlug primaryVisibilityPlug = depNode.findPlug("primaryVisibility");
-	bool primaryVisibility;
-	primaryVisibilityPlug.getValue(primaryVisibility);
+	return changed;
+}
 
+void FireRenderMeshCommon::setRenderStats(MDagPath dagPath)
+{
 	bool isVisisble = IsMeshVisible(dagPath, context());
 
 	setVisibility(isVisisble);
 
-	MFnDagNode mdag(dagPath.node());
-	MFnDependencyNode parentTransform(mdag.parent(0));
-	MPlug contourVisibilityPlug = parentTransform.findPlug("RPRContourVisibility");
-	bool isVisibleInContour = false;
-	if (!contourVisibilityPlug.isNull())
+	if (!UpdateAttributeSnapshot(dagPath))
 	{
-		MStatus res = contourVisibilityPlug.getValue(isVisibleInContour);
-		CHECK_MSTATUS(res);
+		return;
 	}
 
-	setPrimaryVisibility(primaryVisibility);
+	const MeshAttributeSnapshot& snapshot = m_attributes.snapshot;
+
+	setPrimaryVisibility(snapshot.primaryVisibility);
 
-	setReflectionVisibility(visibleInReflections);
+	setReflectionVisibility(snapshot.visibleInReflections);
 
-	setRefractionVisibility(visibleInRefractions);
+	setRefractionVisibility(snapshot.visibleInRefractions);
 
 	if (context()->IsContourModeSupported())
 	{
-		setContourVisibility(isVisibleInContour);
+		setContourVisibility(snapshot.contourVisibility);
 	}
 
-	setCastShadows(castsShadows);
+	setCastShadows(snapshot.castsShadows);
 
-	setReceiveShadows(receiveShadows);
+	setReceiveShadows(snapshot.receiveShadows);
 }
 
 bool FireRenderMesh::IsSelected(const MDagPath& dagPath) const
@@ -1196,6 +1199,7 @@ void FireRenderMesh::ReinitializeMesh(const MDagPath& meshPath)
 	setVisibility(false);
 
 	m.elements.clear();
+	InvalidateAttributeSnapshot();
 
 	// node is not visible => skip
 	if (IsMeshVisible(meshPath, this->context()))
@@ -1576,7 +1580,11 @@ void FireRenderMesh::Rebuild()
 		ProcessSkyLight();
 	}
 
-	SetupObjectId(meshPath.transform());
+	if (m_attributes.changed)
+	{
+		SetupObjectId();
+	}
+
 	if (context->IsShadowColorSupported())
 	{
 		SetupShadowColor();
@@ -1587,18 +1595,10 @@ void FireRenderMesh::Rebuild()
 	m.changed.shader = false;
 }
 
-void FireRenderMesh::SetupObjectId(MObject parentTransformObject)
+void FireRenderMesh::SetupObjectId()
 {
-	MObject node = Object();
-	MFnDependencyNode parentTransform(parentTransformObject);
-
-	MPlug plug = parentTransform.findPlug("RPRObjectId");
-
-	rpr_uint objectId = 0;
-	if (!plug.isNull())
-	{
-		objectId = plug.asInt();
-	}
+	// object id is read from the parent transform together with the other render stats
+	rpr_uint objectId = m_attributes.snapshot.objectId;
 
 	for (auto& element : m.elements)
 	{
@@ -1615,13 +1615,15 @@ void FireRenderMesh::SetupObjectId(MObject parentTransformObject)
 void FireRenderMesh::SetupShadowColor()
 {
 	MObject node = Object();
-	MPlug plug = MFnDependencyNode(node).findPlug("RPRShadowColor");
+	MObject shadowColorAttribute = MeshAttributeDescriptor::Get(node, MObject::kNullObj).ShadowColorAttribute();
 
-	if (plug.isNull())
+	if (shadowColorAttribute.isNull())
 	{
 		return;
 	}
 
+	MPlug plug(node, shadowColorAttribute);
+
 	frw::Value colorValue = Scope().GetValue(plug);
 
 	for (FrElement element : m.elements)
@@ -1773,10 +1775,27 @@ bool FireRenderMesh::TranslateMeshWrapped(const MDagPath& dagPath, frw::Shape& o
 		MString name = dagNode.fullPathName();
 		assert(m_meshData.IsInitialized());
 
-		outShape = FireMaya::MeshTranslator::TranslateMesh(m_meshData, context->GetContext(), Object(), m.faceMaterialIndices, motionSamplesCount, dagPath.fullPathName());
+		TimePoint startTime = GetCurrentChronoTime();
+
+		if (m_reuseTopology)
+		{
+			outShape = FireMaya::MeshTranslator::TranslateDeformedMesh(m_meshData, context->GetContext(), Object(), m_topologyCache, m.faceMaterialIndices);
+		}
+		else
+		{
+			// mesh changed after it was created, it is likely deforming, so keep its topology for next updates
+			FireMaya::MeshTranslator::TopologyCache* topologyCache = m.changed.mesh ? &m_topologyCache : nullptr;
+
+			outShape = FireMaya::MeshTranslator::TranslateMesh(m_meshData, context->GetContext(), Object(), m.faceMaterialIndices, motionSamplesCount, dagPath.fullPathName(), topologyCache);
+		}
+
+		DebugPrint("FireRenderMesh: %s translated in %ld ms (%s)", name.asUTF8(),
+			TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), startTime),
+			m_reuseTopology ? "points and normals only" : "full");
 	}
 
 	m.isPreProcessed = false;
+	m_reuseTopology = false;
 
 	return true;
 }
@@ -1856,13 +1875,7 @@ void FireRenderMeshCommon::AssignShadingEngines(const MObjectArray& shadingEngin
 bool FireRenderMeshCommon::IsMotionBlurEnabled(const MFnDagNode& meshFn)
 {
 	// Checking of MotionBlur parameter in RenderStats group of mesh
-	bool objectMotionBlur = true;
-	MPlug objectMBPlug = meshFn.findPlug("motionBlur");
-
-	if (!objectMBPlug.isNull())
-	{
-		objectMotionBlur = objectMBPlug.asBool();
-	}
+	bool objectMotionBlur = MeshAttributeDescriptor::Get(meshFn.object(), MObject::kNullObj).ReadMotionBlur(meshFn.object());
 
 	return (context()->motionBlur() && objectMotionBlur);
 }
@@ -2039,8 +2052,19 @@ bool FireRenderMesh::ReloadMesh(unsigned int sampleIdx /*= 0*/)
 	{
 		ContextSetDirtyObjectAutoLocker locker(*context);
 
-		success = FireMaya::MeshTranslator::PreProcessMesh(m_meshData, context->GetContext(), Object(), motionSamplesCount, sampleIdx, dagPath.fullPathName());
-		ProccessSmoothCallbackWorkaroundIfNeeds();
+		// deformed mesh with unchanged topology: read only points and normals
+		m_reuseTopology = m.changed.mesh && (motionSamplesCount == 0) &&
+			FireMaya::MeshTranslator::PreProcessDeformedMesh(m_meshData, Object(), m_topologyCache);
+
+		if (m_reuseTopology)
+		{
+			success = true;
+		}
+		else
+		{
+			success = FireMaya::MeshTranslator::PreProcessMesh(m_meshData, context->GetContext(), Object(), motionSamplesCount, sampleIdx, dagPath.fullPathName());
+			ProccessSmoothCallbackWorkaroundIfNeeds();
+		}
 	}
 
 	if (!success)
@@ -2307,6 +2331,7 @@ void FireRenderEnvLight::clear()
 	m.light.Reset();
 	m.image.Reset();
 	m.bgOverride.Reset();
+	m_buildStateValid = false;
 
 	FireRenderObject::clear();
 }
@@ -2412,7 +2437,158 @@ void setPortal_IBL(MObject transformObject, FireRenderEnvLight *light) {
 	}
 }
 
-void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
+void collectPortals_IBL(MObject transformObject, FireRenderContext* context, std::vector<MObject>& portals, std::vector<void*>& portalShapes)
+{
+	// same traversal as setPortal_IBL, but without touching the portal meshes
+	MFnTransform transform(transformObject);
+
+	auto childCount = transform.childCount();
+	for (auto i = 0u; i < childCount; i++)
+	{
+		MObject child = transform.child(i);
+		MFnTransform childTransform(child);
+		auto childChildCount = childTransform.childCount();
+
+		for (auto j = 0u; j < childChildCount; j++)
+		{
+			MObject portal = childTransform.child(j);
+
+			if (auto ob = context->getRenderObject<FireRenderMesh>(portal))
+			{
+				portals.push_back(portal);
+
+				for (auto& element : ob->Elements())
+				{
+					portalShapes.push_back(element.shape.Handle());
+				}
+			}
+		}
+
+		if (child.hasFn(MFn::kTransform))
+		{
+			collectPortals_IBL(child, context, portals, portalShapes);
+		}
+	}
+}
+
+bool FireRenderEnvLight::ReadBuildState(BuildState& outState)
+{
+	auto dagPath = DagPath();
+
+	if (!dagPath.isValid())
+	{
+		return false;
+	}
+
+	MFnDagNode dagNode(Object());
+
+	outState.typeId = dagNode.typeId().id();
+
+	MPlug filePathPlug = dagNode.findPlug("filePath");
+	if (!filePathPlug.isNull())
+	{
+		filePathPlug.getValue(outState.filePath);
+	}
+
+	auto colorSpacePlug = dagNode.findPlug("colorSpace");
+	if (!colorSpacePlug.isNull())
+	{
+		outState.colorSpace = colorSpacePlug.asString();
+	}
+
+	collectPortals_IBL(dagPath.transform(), context(), outState.portals, outState.portalShapes);
+
+	return true;
+}
+
+bool FireRenderEnvLight::UpdateInPlace()
+{
+	if (!m.light || !m_buildStateValid || m_buildState.typeId != FireMaya::TypeId::FireRenderIBL)
+	{
+		return false;
+	}
+
+	BuildState state;
+	if (!ReadBuildState(state) || state != m_buildState)
+	{
+		return false;
+	}
+
+	auto node = Object();
+	auto dagPath = DagPath();
+	MFnDagNode dagNode(node);
+
+	// Check node visibility without checking current render layer.
+	// We should render env light on all render layers.
+	if (!isVisible(dagNode, MFn::kInvalid))
+	{
+		detachFromScene();
+
+		// as after a rebuild, a hidden light is not the scene IBL
+		context()->iblLight = nullptr;
+		context()->iblTransformObject = MObject();
+
+		return true;
+	}
+
+	if (m.image)
+	{
+		// the image stays bound to the light, so environment sampling data is not rebuilt
+		float intensity = GetPlugValue("intensity", 1.0f);
+		FireMaya::setEnvironmentIBL(m.light, Context(), frw::Image(), intensity, dagPath.inclusiveMatrix(), true);
+	}
+	else
+	{
+		bool update = true;
+		auto scope = this->Scope();
+		FireMaya::translateEnvLight(m.light, m.image, Context(), scope, node, dagPath.inclusiveMatrix(), update);
+	}
+
+	bool needsBackgroundOverride = !GetPlugValue("display", true) || m.light.IsAmbientLight();
+	if (needsBackgroundOverride != (bool) m.bgOverride)
+	{
+		// background override is bound when the light is attached
+		detachFromScene();
+
+		if (needsBackgroundOverride)
+		{
+			m.bgOverride = Context().CreateEnvironmentLight();
+			m.bgOverride.SetImage(frw::Image(Context(), 0, 0, 0));
+		}
+		else
+		{
+			m.bgOverride.Reset();
+		}
+	}
+
+	// set again in case the light was hidden before
+	context()->iblLight = this;
+	context()->iblTransformObject = dagPath.transform();
+
+	attachToScene();
+
+	LinkShaders();
+
+	return true;
+}
+
+void FireRenderEnvLight::LinkShaders()
+{
+	auto scope = this->Scope();
+
+	std::string lightId = getNodeUUid(Object());
+	auto shaderIds = scope.GetCachedShaderIds(lightId);
+	for (auto it = shaderIds.first; it != shaderIds.second; ++it)
+	{
+		frw::Shader linkedShader = scope.GetCachedShader(it->second);
+		if (!linkedShader.IsValid())
+			continue;
+
+		linkedShader.LinkLight(getLight());
+	}
+}
+
+void FireRenderEnvLight::Rebuild()
 {
 	RestorePortalStates(true);
 
@@ -2420,6 +2596,7 @@ void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
 	m.light.Reset();
 	m.image.Reset();
 	m.bgOverride.Reset();
+	m_buildStateValid = false;
 
 	context()->iblLight = nullptr;
 	context()->iblTransformObject = MObject();
@@ -2471,20 +2648,29 @@ void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
 			}
 
 			attachToScene();	// normal!
+
+			// portal shapes are read after setPortal_IBL made sure they exist
+			m_buildStateValid = ReadBuildState(m_buildState);
 		}
 
-		std::string lightId = getNodeUUid(Object());
-		auto shaderIds = scope.GetCachedShaderIds(lightId);
-		for (auto it = shaderIds.first; it != shaderIds.second; ++it)
-		{
-			frw::Shader linkedShader = scope.GetCachedShader(it->second);
-			if (!linkedShader.IsValid())
-				continue;
+		LinkShaders();
+	}
+}
 
-			linkedShader.LinkLight(getLight());
-		}
+void FireRenderEnvLight::Freshen(bool shouldCalculateHash)
+{
+	TimePoint start = GetCurrentChronoTime();
+
+	bool updatedInPlace = UpdateInPlace();
+
+	if (!updatedInPlace)
+	{
+		Rebuild();
 	}
 
+	DebugPrint("Env light %s: %d ms", updatedInPlace ? "updated in place" : "rebuilt",
+		(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), start));
+
 	FireRenderNode::Freshen(shouldCalculateHash);
 }
 
@@ -23,6 +23,7 @@ limitations under the License.
 #include "FireMaya.h"
 
 #include "PhysicalLightData.h"
+#include "MeshAttributeSnapshot.h"
 
 // Forward declarations
 class FireRenderContext;
@@ -144,6 +145,9 @@ public:
 	void ClearCallbacks();
 	virtual void RegisterCallbacks();
 
+	// Remove callbacks and undo changes made to Maya nodes, after that the object may be released off the main thread
+	virtual void DetachFromMaya();
+
 	template <class T>
 	static T GetPlugValue(const MObject& ob, const char* name, T defaultValue)
 	{
@@ -220,6 +224,8 @@ public:
 
 	std::vector<frw::Shape> GetVisiblePortals();
 
+	void DetachFromMaya() override;
+
 	MDagPath DagPath();
 	unsigned int Instance() const { return m.instance; }
 
@@ -325,6 +331,12 @@ protected:
 
 	bool IsMotionBlurEnabled(const MFnDagNode& meshFn);
 
+	// reads render stats of the shape and its transform; returns true if they should be (re)applied to rpr shapes
+	bool UpdateAttributeSnapshot(const MDagPath& dagPath);
+
+	// render stats are stored in rpr shapes, so they have to be re-applied whenever the shapes are re-created
+	void InvalidateAttributeSnapshot() { m_attributes.valid = false; }
+
 
 protected:
 
@@ -352,6 +364,14 @@ protected:
 	// this is the limitation of Maya's relationship editor
 	// thus, it is correct to match filename with UV map index
 	std::unordered_map<std::string /*texture file name*/, unsigned int /*UV map index*/ > m_uvSetCachedMappingData;
+
+	// last render stats applied to rpr shapes
+	struct
+	{
+		MeshAttributeSnapshot snapshot;
+		bool valid = false;	// false after rpr shapes were re-created
+		bool changed = true;
+	} m_attributes;
 };
 
 // Fire render mesh
@@ -419,7 +439,7 @@ public:
 protected:
 	void SaveUsedUV(const MObject& meshNode);
 
-	void SetupObjectId(MObject parentTransform);
+	void SetupObjectId();
 
 	void SetupShadowColor();
 
@@ -428,6 +448,12 @@ protected:
 protected:
 	FireMaya::MeshTranslator::MeshPolygonData m_meshData;
 
+	// topology of deforming mesh; filled when mesh is re-translated after a change
+	FireMaya::MeshTranslator::TopologyCache m_topologyCache;
+
+	// m_meshData holds only points and normals, the rest is taken from m_topologyCache
+	bool m_reuseTopology = false;
+
 private:
 	void GetShapes(frw::Shape& outShape);
 	
@@ -545,11 +571,44 @@ protected:
 	virtual void attachToSceneInternal();
 	virtual void detachFromSceneInternal();
 
+private:
+	// attributes that require the light to be re-created and its image re-bound when changed
+	struct BuildState
+	{
+		unsigned int typeId = 0;
+		MString filePath;
+		MString colorSpace;
+		std::vector<MObject> portals;
+		std::vector<void*> portalShapes;
+
+		bool operator==(const BuildState& other) const
+		{
+			return typeId == other.typeId &&
+				filePath == other.filePath &&
+				colorSpace == other.colorSpace &&
+				portals == other.portals &&
+				portalShapes == other.portalShapes;
+		}
+
+		bool operator!=(const BuildState& other) const { return !(*this == other); }
+	};
+
+	bool ReadBuildState(BuildState& outState);
+
+	// updates transform, intensity, visibility and background override of the existing light
+	// returns false if the light has to be rebuilt
+	bool UpdateInPlace();
+	void Rebuild();
+	void LinkShaders();
+
 private:
 
 	// Transform matrix
 	MMatrix m_matrix;
 
+	BuildState m_buildState;
+	bool m_buildStateValid = false;
+
 public:
 	struct
 	{
@@ -40,6 +40,8 @@ limitations under the License.
 #include <clocale>
 #include <chrono>
 #include <ctime>
+#include <future>
+#include <atomic>
 
 #include "common.h"
 
@@ -120,7 +122,7 @@ void FireRenderProduction::updateRegion()
 	{
 		FireRenderThread::RunOnceProcAndWait([this]()
 		{
-			// was causing deadlock: AutoMutexLock contextLock(m_contextLock);
+			// was causing deadlock: AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 			m_isRegion = m_contextPtr->setUseRegion(m_isRegion);
 
 			if (m_isRegion)
@@ -287,6 +289,11 @@ bool FireRenderProduction::Init(int contextWidth, int contextHeight, RenderRegio
 	if (m_width == 0 || m_height == 0)
 		return false;
 
+	if (m_globals.tileRenderingEnabled && m_globals.tileRenderContextCount > 1)
+	{
+		m_contextPtr->SetCPUThreadShareCount(m_globals.tileRenderContextCount);
+	}
+
 	m_contextPtr->setCallbackCreationDisabled(true);
 	if (!m_contextPtr->buildScene(false, false, false))
 	{
@@ -365,6 +372,8 @@ bool FireRenderProduction::startTileRender()
 	RenderRegion region = RenderRegion(contextWidth, contextHeight);
 
 	Init(contextWidth, contextHeight, region);
+	CreateTileWorkerContexts(contextWidth, contextHeight);
+
 	FireRenderThread::KeepRunning([this]()
 	{
 		try
@@ -422,7 +431,7 @@ bool FireRenderProduction::startFullFrameRender()
 
 void FireRenderProduction::OnBufferAvailableCallback(float progress)
 {
-	AutoMutexLock pixelsLock(m_pixelsLock);
+	AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 	bool frameFinished = fabs(1.0f - progress) <= FLT_EPSILON;
 	bool shouldUpdateRenderView = !m_contextPtr->IsDenoiserCreated() || (m_contextPtr->IsDenoiserCreated() && frameFinished);
@@ -513,9 +522,12 @@ bool FireRenderProduction::stop()
 				FireRenderThread::RunItemsQueuedForTheMainThread();
 			}
 
-			m_contextPtr->cleanScene();
+			std::shared_ptr<FireRenderContext> refToKeepAlive = m_contextPtr;
+			m_contextPtr.reset();
 
 			m_contextLock.unlock();
+
+			refToKeepAlive->cleanSceneAsync(refToKeepAlive);
 		}
 		else
 		{
@@ -526,6 +538,8 @@ bool FireRenderProduction::stop()
 		}
 	}
 
+	ReleaseTileWorkerContexts();
+
 	return true;
 }
 
@@ -576,172 +590,317 @@ int getNumCPUCores()
 }
 #endif
 
-void FireRenderProduction::UploadAthenaData()
+namespace
 {
-	// We drop support for all Mayas older then 2022 since they have old Python 2.7
-#if MAYA_API_VERSION < 20220000
-	return;
-#endif
+	// Render-specific telemetry values, read on the render-completion path
+	struct AthenaRenderData
+	{
+		double secondsSpentOnRender = 0.0;
+		std::vector<HardwareResources::Device> allDevices;
+		int renderDevice = 0;
+		std::vector<bool> gpusUsed;
+		size_t polygonCount = 0;
+		std::vector<unsigned int> resolution;
+		std::string endStatus;
+		std::string locale;
+		int lightsCount = 0;
+		std::time_t startTime = 0;
+		std::time_t stopTime = 0;
+		std::vector<std::string> aovsUsed;
+		int samples = 0;
+		size_t texturesCount = 0;
+		long long texturesSize = 0;
+		int maxRayDepth = 0;
+		int maxRayDepthDiffuse = 0;
+		int maxRayDepthGlossy = 0;
+		int maxRayDepthRefraction = 0;
+		int maxRayDepthShadow = 0;
+		std::string mayaVersion;
+		std::string denoiser;
+		std::string quality;
+	};
+
+	// Only one upload is in flight at a time, the Athena file is shared
+	std::future<void> s_athenaUpload;
+
+	// Python calls queued by the worker which have not run on the main thread yet
+	std::atomic<int> s_pendingAthenaPythonCalls { 0 };
 
-	AthenaWrapper::GetAthenaWrapper()->StartNewFile();
+	// The upload runs on a worker thread, the Python call itself has to be queued to the main thread
+	int pythonCallFromWorker(std::string arg)
+	{
+		s_pendingAthenaPythonCalls++;
+
+		FireRenderThread::KeepRunningOnMainThread([arg]() -> bool
+		{
+			try
+			{
+				pythonCallWrap(arg);
+			}
+			catch (...)
+			{
+				DebugPrint("Athena: upload call failed");
+			}
 
-	// operating system
+			s_pendingAthenaPythonCalls--;
+			return false;
+		});
+
+		return 0;
+	}
+
+	// Full recounts are expensive, they are done only for a render requested by fireRender -verifyTelemetryCounters
+	std::atomic<bool> s_verifyTelemetryCounters { false };
+	std::atomic<bool> s_telemetryCountersMatched { true };
+
+	// Waits for the upload and the Python call it queued; the main thread keeps running queued items meanwhile
+	void WaitForUploadToFinish(std::future<void>& upload)
+	{
+		bool onMainThread = FireRenderThread::AreWeOnMainThread();
+
+		while (upload.valid() && (upload.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready))
+		{
+			if (onMainThread)
+			{
+				FireRenderThread::RunItemsQueuedForTheMainThread();
+			}
+		}
+
+		while (s_pendingAthenaPythonCalls > 0)
+		{
+			if (onMainThread)
+			{
+				FireRenderThread::RunItemsQueuedForTheMainThread();
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	void SendAthenaRenderData(const AthenaRenderData& renderData)
+	{
+		AthenaWrapper::GetAthenaWrapper()->StartNewFile();
+
+		// operating system
 #if defined(_WIN32)
-	std::string osName;
-	std::string osVersion;
-	getOSName(osName, osVersion);
-	WriteAthenaField("OS Name", osName);
-	WriteAthenaField("OS Version", osVersion);
+		std::string osName;
+		std::string osVersion;
+		getOSName(osName, osVersion);
+		WriteAthenaField("OS Name", osName);
+		WriteAthenaField("OS Version", osVersion);
 
-	// - Get the timezone info.
-	std::string timezoneName;
-	getTimeZone(timezoneName);
-	WriteAthenaField("OS TZ", timezoneName);
+		// - Get the timezone info.
+		std::string timezoneName;
+		getTimeZone(timezoneName);
+		WriteAthenaField("OS TZ", timezoneName);
 
 #elif defined(__APPLE__)
-    char buffer[1024];
+		char buffer[1024];
 
-    getTimeZone(buffer, sizeof(buffer)/sizeof(buffer[0]));
-    WriteAthenaField("OS TZ", buffer);
+		getTimeZone(buffer, sizeof(buffer)/sizeof(buffer[0]));
+		WriteAthenaField("OS TZ", buffer);
 
-    getOSName(buffer, sizeof(buffer)/sizeof(buffer[0]));
-    WriteAthenaField("OS Name", buffer);
+		getOSName(buffer, sizeof(buffer)/sizeof(buffer[0]));
+		WriteAthenaField("OS Name", buffer);
 
-    getOSVersion(buffer, sizeof(buffer)/sizeof(buffer[0]));
-    WriteAthenaField("OS Version", buffer);
+		getOSVersion(buffer, sizeof(buffer)/sizeof(buffer[0]));
+		WriteAthenaField("OS Version", buffer);
 #elif defined(__linux__)
-	WriteAthenaField("OS Name", "Linux");
+		WriteAthenaField("OS Name", "Linux");
 #endif
 
-	// os arch
-	WriteAthenaField("OS Arch", "64bit");
+		// os arch
+		WriteAthenaField("OS Arch", "64bit");
 
-	// plug-in version
-	WriteAthenaFieldAsString("ProRender Plugin Version", PLUGIN_VERSION);
+		// plug-in version
+		WriteAthenaFieldAsString("ProRender Plugin Version", PLUGIN_VERSION);
 
-	// core version
+		// core version
 #ifdef RPR_VERSION_MAJOR_MINOR_REVISION
-	std::ostringstream oss;
-	oss << RPR_VERSION_MAJOR << "." << RPR_VERSION_MINOR << RPR_VERSION_REVISION;
+		std::ostringstream oss;
+		oss << RPR_VERSION_MAJOR << "." << RPR_VERSION_MINOR << RPR_VERSION_REVISION;
 #else
-	int mj = (RPR_API_VERSION & 0xFFFF00000) >> 28;
-	int mn = (RPR_API_VERSION & 0xFFFFF) >> 8;
+		int mj = (RPR_API_VERSION & 0xFFFF00000) >> 28;
+		int mn = (RPR_API_VERSION & 0xFFFFF) >> 8;
 
-	std::ostringstream oss;
-	oss << std::hex << mj << "." << mn;
+		std::ostringstream oss;
+		oss << std::hex << mj << "." << mn;
 #endif
 
-	WriteAthenaField("ProRender Core Version", oss.str());
-
-	// host application
-	WriteAthenaField("Host App", "Maya");
-
-	// render time
-	WriteAthenaField("Seconds spent on render", m_contextPtr->m_secondsSpentOnLastRender);
+		WriteAthenaField("ProRender Core Version", oss.str());
 
-	// device used
-	// - CPU Name
-	std::string CPUName = RenderStampUtils::GetCPUNameString();
-	WriteAthenaField("CPU Name", CPUName);
+		// host application
+		WriteAthenaField("Host App", "Maya");
 
-	// - CPU Cores
-	int numCPU = getNumCPUCores();
-	WriteAthenaField("CPU Cores", numCPU);
+		// render time
+		WriteAthenaField("Seconds spent on render", renderData.secondsSpentOnRender);
 
-	// - GPU0 Name
-	std::vector<HardwareResources::Device> allDevices = HardwareResources::GetAllDevices();
-	if (allDevices.size() > 0)
-	{
-		std::string GPU0Name = allDevices[0].name;
-		WriteAthenaField("GPU0 Name", GPU0Name);
-	}
+		// device used
+		// - CPU Name
+		std::string CPUName = RenderStampUtils::GetCPUNameString();
+		WriteAthenaField("CPU Name", CPUName);
 
-	// - GPU1 Name
-	std::vector<std::string> GPU1Name; // list GPU 0-15
-	GPU1Name.reserve(allDevices.size());
-	for (HardwareResources::Device& device : allDevices)
-		GPU1Name.push_back(device.name);
-	WriteAthenaField("GPU1 Name", GPU1Name);
+		// - CPU Cores
+		int numCPU = getNumCPUCores();
+		WriteAthenaField("CPU Cores", numCPU);
 
-	// - device used
-	int renderDevice = RenderStampUtils::GetRenderDevice();
-	switch (renderDevice)
-	{
-		case RenderStampUtils::RPR_RENDERDEVICE_CPUONLY:
+		// - GPU0 Name
+		if (renderData.allDevices.size() > 0)
 		{
-			WriteAthenaField("CPU Enabled", true);
-			WriteAthenaField("GPU0 Enabled", false);
-			break;
+			std::string GPU0Name = renderData.allDevices[0].name;
+			WriteAthenaField("GPU0 Name", GPU0Name);
 		}
 
-		case RenderStampUtils::RPR_RENDERDEVICE_GPUONLY:
+		// - GPU1 Name
+		std::vector<std::string> GPU1Name; // list GPU 0-15
+		GPU1Name.reserve(renderData.allDevices.size());
+		for (const HardwareResources::Device& device : renderData.allDevices)
+			GPU1Name.push_back(device.name);
+		WriteAthenaField("GPU1 Name", GPU1Name);
+
+		// - device used
+		switch (renderData.renderDevice)
 		{
-			WriteAthenaField("CPU Enabled", false);
-			WriteAthenaField("GPU0 Enabled", true);
-			break;
+			case RenderStampUtils::RPR_RENDERDEVICE_CPUONLY:
+			{
+				WriteAthenaField("CPU Enabled", true);
+				WriteAthenaField("GPU0 Enabled", false);
+				break;
+			}
+
+			case RenderStampUtils::RPR_RENDERDEVICE_GPUONLY:
+			{
+				WriteAthenaField("CPU Enabled", false);
+				WriteAthenaField("GPU0 Enabled", true);
+				break;
+			}
+
+			default: // CPU+GPU
+				WriteAthenaField("CPU Enabled", true);
+				WriteAthenaField("GPU0 Enabled", true);
 		}
 
-		default: // CPU+GPU
-			WriteAthenaField("CPU Enabled", true);
-			WriteAthenaField("GPU0 Enabled", true);
+		WriteAthenaField("GPU1 Enabled", renderData.gpusUsed);
+
+		// polygon count
+		WriteAthenaField("Num Polygons", renderData.polygonCount);
+
+		// render resolution
+		WriteAthenaField("Resolution", renderData.resolution);
+
+		// render result
+		WriteAthenaField("End status", renderData.endStatus);
+
+		// locale
+		WriteAthenaFieldAsString("OS Locale", renderData.locale);
+
+		// lights
+		WriteAthenaField("Lights Count", renderData.lightsCount);
+
+		// time and date
+		WriteAthenaField("Stop Time", std::string(std::ctime(&renderData.stopTime)) );
+		WriteAthenaField("Start Time", std::string(std::ctime(&renderData.startTime)) );
+
+		// aov's
+		WriteAthenaField("AOVs Enabled", renderData.aovsUsed);
+
+		// completed iterations
+		WriteAthenaField("Samples", renderData.samples);
+
+		// textures
+		WriteAthenaField("Num Textures", renderData.texturesCount);
+		WriteAthenaField("Textures Size", renderData.texturesSize/1000);
+
+		// ray depth
+		WriteAthenaField("Ray Depth", renderData.maxRayDepth);
+		WriteAthenaField("Diffuse Ray Depth", renderData.maxRayDepthDiffuse);
+		WriteAthenaField("Reflection Ray Depth", renderData.maxRayDepthGlossy);
+		WriteAthenaField("Refraction Ray Depth", renderData.maxRayDepthRefraction);
+		WriteAthenaField("Shadow Ray Depth", renderData.maxRayDepthShadow);
+
+		// maya version
+		WriteAthenaFieldAsString("App Version", renderData.mayaVersion);
+
+		// denoiser
+		WriteAthenaField("RIF Type", renderData.denoiser);
+
+		WriteAthenaField("Quality", renderData.quality);
+
+		AthenaWrapper::GetAthenaWrapper()->AthenaSendFile(pythonCallFromWorker);
 	}
+}
+
+void FireRenderProduction::UploadAthenaData()
+{
+	if (s_verifyTelemetryCounters.exchange(false))
+	{
+		size_t texturesCount = 0;
+		long long texturesSize = 0;
+		std::tie(texturesCount, texturesSize) = GeSceneTexturesCountAndSize();
+
+		s_telemetryCountersMatched = VerifyAthenaCounters(GetScenePolyCount(), texturesCount, texturesSize);
+	}
+
+	// We drop support for all Mayas older then 2022 since they have old Python 2.7
+#if MAYA_API_VERSION < 20220000
+	return;
+#endif
+
+	// Only values tied to this render are read here, system info and file output are handled on a worker thread
+	AthenaRenderData renderData;
+
+	renderData.secondsSpentOnRender = m_contextPtr->m_secondsSpentOnLastRender;
+	renderData.allDevices = HardwareResources::GetAllDevices();
+	renderData.renderDevice = RenderStampUtils::GetRenderDevice();
 
-	std::vector<bool> gpusUsed;
 	MIntArray devicesUsing;
 	MGlobal::executeCommand("optionVar -q RPR_DevicesSelected", devicesUsing);
-	size_t numDevices = std::min<size_t>(devicesUsing.length(), allDevices.size());
+	size_t numDevices = std::min<size_t>(devicesUsing.length(), renderData.allDevices.size());
 
 	for (size_t idx = 0; idx < numDevices; ++idx)
-		gpusUsed.push_back(devicesUsing[(unsigned int)idx] != 0);
+		renderData.gpusUsed.push_back(devicesUsing[(unsigned int)idx] != 0);
 
-	WriteAthenaField("GPU1 Enabled", gpusUsed);
+	// counters are maintained as shapes are attached and images are created, no scene walk is needed here
+	renderData.polygonCount = GetScenePolyCount();
+	std::tie(renderData.texturesCount, renderData.texturesSize) = GeSceneTexturesCountAndSize();
 
-	// polygon count
-	WriteAthenaField("Num Polygons", GetScenePolyCount());
-
-	// render resolution
-	std::vector<unsigned int> imgRes = { m_width, m_height };
-	WriteAthenaField("Resolution", imgRes);
+	renderData.resolution = { m_width, m_height };
 
 	// render result
 	switch (m_contextPtr->m_lastRenderResultState)
 	{
 		case FireRenderContext::COMPLETED:
 		{
-			WriteAthenaField("End status", "successfull | completed");
+			renderData.endStatus = "successfull | completed";
 			break;
 		}
 
 		case FireRenderContext::CANCELED:
 		{
-			WriteAthenaField("End status", "successfull | cancelled");
+			renderData.endStatus = "successfull | cancelled";
 			break;
 		}
 
 		case FireRenderContext::CRASHED:
 		{
-			WriteAthenaField("End status", "failed | crashed");
+			renderData.endStatus = "failed | crashed";
 			break;
 		}
 
 		default:
-			WriteAthenaField("End status", "failed | error!");
+			renderData.endStatus = "failed | error!";
 	}
 
 	// locale
 	const char* currLocale = std::setlocale(LC_NUMERIC, "");
-	WriteAthenaFieldAsString("OS Locale", currLocale);
+	renderData.locale = currLocale ? currLocale : "";
 
 	// lights
-	WriteAthenaField("Lights Count", m_contextPtr->GetScene().LightObjectCount());
+	renderData.lightsCount = m_contextPtr->GetScene().LightObjectCount();
 
 	// time and date
-	auto curr = std::chrono::system_clock::now();
-	std::time_t currTime = std::chrono::system_clock::to_time_t(curr);
-	WriteAthenaField("Stop Time", std::string(std::ctime(&currTime)) );
-
-	std::time_t renderStartTime = std::chrono::system_clock::to_time_t(m_contextPtr->m_lastRenderStartTime);
-	WriteAthenaField("Start Time", std::string(std::ctime(&renderStartTime)) );
+	renderData.stopTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	renderData.startTime = std::chrono::system_clock::to_time_t(m_contextPtr->m_lastRenderStartTime);
 
 	// aov's
 	static std::map<unsigned int, std::string> aovNames =
@@ -780,35 +939,24 @@ void FireRenderProduction::UploadAthenaData()
 		,{RPR_AOV_MAX, "RPR_AOV_MAX" }
 	};
 
-	std::vector<std::string> aovsUsed;
-	aovsUsed.reserve(aovNames.size());
+	renderData.aovsUsed.reserve(aovNames.size());
 
 	for (int aovID = 0; aovID < RPR_AOV_MAX; aovID++)
 		if (m_contextPtr->isAOVEnabled(aovID))
-			aovsUsed.push_back(aovNames[aovID]);
-
-	WriteAthenaField("AOVs Enabled", aovsUsed);
+			renderData.aovsUsed.push_back(aovNames[aovID]);
 
 	// completed iterations
-	WriteAthenaField("Samples", m_contextPtr->m_currentIteration);
-
-	// textures
-	size_t countTextures = 0;
-	long long texturesSize = 0;
-	std::tie(countTextures, texturesSize) = GeSceneTexturesCountAndSize();
-	WriteAthenaField("Num Textures", countTextures);
-	WriteAthenaField("Textures Size", texturesSize/1000);
+	renderData.samples = m_contextPtr->m_currentIteration;
 
 	// ray depth
-	WriteAthenaField("Ray Depth", m_globals.maxRayDepth);
-	WriteAthenaField("Diffuse Ray Depth", m_globals.maxRayDepthDiffuse);
-	WriteAthenaField("Reflection Ray Depth", m_globals.maxRayDepthGlossy);
-	WriteAthenaField("Refraction Ray Depth", m_globals.maxRayDepthRefraction);
-	WriteAthenaField("Shadow Ray Depth", m_globals.maxRayDepthShadow);
+	renderData.maxRayDepth = m_globals.maxRayDepth;
+	renderData.maxRayDepthDiffuse = m_globals.maxRayDepthDiffuse;
+	renderData.maxRayDepthGlossy = m_globals.maxRayDepthGlossy;
+	renderData.maxRayDepthRefraction = m_globals.maxRayDepthRefraction;
+	renderData.maxRayDepthShadow = m_globals.maxRayDepthShadow;
 
 	// maya version
-	MString mayaVer = MGlobal::mayaVersion();
-	WriteAthenaFieldAsString("App Version", mayaVer.asChar());
+	renderData.mayaVersion = MGlobal::mayaVersion().asChar();
 
 	// denoiser
 	static std::map<FireRenderGlobals::DenoiserType, std::string> denoiserName =
@@ -820,7 +968,7 @@ void FireRenderProduction::UploadAthenaData()
 	};
 
 	bool isDenoiserEnabled = m_globals.denoiserSettings.enabled;
-	WriteAthenaField("RIF Type", isDenoiserEnabled ? denoiserName[m_globals.denoiserSettings.type] : "Not Enabled");
+	renderData.denoiser = isDenoiserEnabled ? denoiserName[m_globals.denoiserSettings.type] : "Not Enabled";
 
 	RenderType renderType = m_contextPtr->GetRenderType();
 	RenderQuality quality = GetRenderQualityForRenderType(renderType);
@@ -833,9 +981,67 @@ void FireRenderProduction::UploadAthenaData()
 		{RenderQuality::RenderQualityNorthStar, "forced NorthStar"},
 		{RenderQuality::RenderQualityHybridPro, "forced HybridPro"},
 	};
-	WriteAthenaField("Quality", renderQualityName[quality]);
+	renderData.quality = renderQualityName[quality];
 
-	AthenaWrapper::GetAthenaWrapper()->AthenaSendFile(pythonCallWrap);
+	// uploads are chained: the next worker waits for the previous upload before it reuses the Athena file,
+	// so the render thread never waits here
+	std::future<void> previousUpload = std::move(s_athenaUpload);
+
+	s_athenaUpload = std::async(std::launch::async, [renderData, previousUpload = std::move(previousUpload)]() mutable
+	{
+		WaitForUploadToFinish(previousUpload);
+		SendAthenaRenderData(renderData);
+	});
+}
+
+void FireRenderProduction::WaitForAthenaUpload()
+{
+	WaitForUploadToFinish(s_athenaUpload);
+	s_athenaUpload = std::future<void>();
+}
+
+void FireRenderProduction::VerifyTelemetryCountersOnNextRender()
+{
+	s_telemetryCountersMatched = true;
+	s_verifyTelemetryCounters = true;
+}
+
+bool FireRenderProduction::TelemetryCountersMatched()
+{
+	return s_telemetryCountersMatched;
+}
+
+bool FireRenderProduction::VerifyAthenaCounters(size_t polygonCount, size_t texturesCount, long long texturesSize) const
+{
+	size_t recountedPolygons = RecountScenePolygons();
+
+	size_t recountedTextures = 0;
+	long long recountedTexturesSize = 0;
+	std::tie(recountedTextures, recountedTexturesSize) = RecountSceneTextures();
+
+	bool match = (polygonCount == recountedPolygons) &&
+		(texturesCount == recountedTextures) &&
+		(texturesSize == recountedTexturesSize);
+
+	if (!match)
+	{
+		MString message;
+		message.format("RPR telemetry counters differ from full recount: polygons ^1s/^2s, textures ^3s/^4s, textures size ^5s/^6s",
+			MString() + (double) polygonCount, MString() + (double) recountedPolygons,
+			MString() + (double) texturesCount, MString() + (double) recountedTextures,
+			MString() + (double) texturesSize, MString() + (double) recountedTexturesSize);
+
+		FireRenderThread::RunProcOnMainThread([message]()
+		{
+			MGlobal::displayError(message);
+		});
+	}
+	else
+	{
+		LogPrint("Athena: maintained counters match full recount (%zu polygons, %zu textures)", polygonCount, texturesCount);
+	}
+
+	return match;
 }
 
 void DisplayTimeMessage(float timeVal, std::string strMsg)
@@ -858,9 +1064,26 @@ void FireRenderProduction::DisplayRenderTimeData()
 	DisplayTimeMessage(m_contextPtr->m_firstFrameRenderTime, "First frame render time: ");
 
 	DisplayTimeMessage(m_contextPtr->m_lastRenderedFrameRenderTime, "Last frame render time: ");
+
+	size_t buffersRequested = 0;
+	size_t buffersCreated = 0;
+	m_contextPtr->GetContext().GetSharedDataBufferStatistics(buffersRequested, buffersCreated);
+	LogPrint("Ramp buffers: %zu requested, %zu created", buffersRequested, buffersCreated);
 }
 
 std::tuple<size_t, long long> FireRenderProduction::GeSceneTexturesCountAndSize() const
+{
+	frw::Context context = m_contextPtr->GetContext();
+
+	return std::make_tuple(context.GetImageCount(), context.GetImagesSizeBytes());
+}
+
+size_t FireRenderProduction::GetScenePolyCount() const
+{
+	return m_contextPtr->GetScene().PolygonCount();
+}
+
+std::tuple<size_t, long long> FireRenderProduction::RecountSceneTextures() const
 {
 	size_t data_size = 0;
 	rprContextGetInfo(m_contextPtr->context(), RPR_CONTEXT_LIST_CREATED_IMAGES, 0, nullptr, &data_size);
@@ -883,7 +1106,7 @@ std::tuple<size_t, long long> FireRenderProduction::GeSceneTexturesCountAndSize(
 	return std::make_tuple(images.size(), texturesSize);
 }
 
-size_t FireRenderProduction::GetScenePolyCount() const
+size_t FireRenderProduction::RecountScenePolygons() const
 {
 	size_t shapeCount = 0;
 	auto status = rprSceneGetInfo(m_contextPtr->scene(), RPR_SCENE_SHAPE_LIST, 0, nullptr, &shapeCount);
@@ -938,7 +1161,7 @@ bool FireRenderProduction::RunOnViewportThread()
 
 			try
 			{	// Render.
-				AutoMutexLock contextLock(m_contextLock);
+				AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 				if (m_contextPtr->GetState() != FireRenderContext::StateRendering) 
 					return false;
 
@@ -999,6 +1222,62 @@ void FireRenderProduction::DenoiseFromAOVs()
 	});
 }
 
+void FireRenderProduction::CreateTileWorkerContexts(int contextWidth, int contextHeight)
+{
+	MAIN_THREAD_ONLY;
+
+	int contextCount = m_globals.tileRenderContextCount;
+
+	for (int contextIndex = 1; contextIndex < contextCount; contextIndex++)
+	{
+		FireRenderContextPtr workerContextPtr = ContextCreator::CreateAppropriateContextForRenderType(RenderType::ProductionRender);
+		workerContextPtr->SetRenderType(RenderType::ProductionRender);
+		workerContextPtr->SetCPUThreadShareCount(contextCount);
+
+		workerContextPtr->enableAOV(RPR_AOV_OPACITY);
+
+		if (m_globals.adaptiveThreshold > 0.0f)
+		{
+			workerContextPtr->enableAOV(RPR_AOV_VARIANCE);
+		}
+
+		m_aovs->applyToContext(*workerContextPtr);
+
+		workerContextPtr->setCallbackCreationDisabled(true);
+
+		try
+		{
+			if (!workerContextPtr->buildScene(false, false, false))
+			{
+				throw std::runtime_error("Unable to build scene");
+			}
+
+			workerContextPtr->setResolution(contextWidth, contextHeight, true);
+			workerContextPtr->setCamera(m_camera, true);
+
+			workerContextPtr->Freshen(false, [this]() -> bool { return m_cancelled; });
+		}
+		catch (...)
+		{
+			// render remaining tiles with the contexts created so far
+			MGlobal::displayWarning(MString("Unable to create additional context for tile rendering, using ") + (int)(m_tileWorkerContexts.size() + 1));
+			break;
+		}
+
+		m_tileWorkerContexts.push_back(workerContextPtr);
+	}
+}
+
+void FireRenderProduction::ReleaseTileWorkerContexts()
+{
+	for (FireRenderContextPtr& workerContextPtr : m_tileWorkerContexts)
+	{
+		workerContextPtr->cleanSceneAsync(workerContextPtr);
+	}
+
+	m_tileWorkerContexts.clear();
+}
+
 void FireRenderProduction::RenderTiles()
 {
 	TileRenderer tileRenderer;
@@ -1020,29 +1299,79 @@ void FireRenderProduction::RenderTiles()
 		ret.first->second.resize(m_width, m_height);
 	});
 
-	m_contextPtr->setSamplesPerUpdate(m_globals.completionCriteriaFinalRender.completionCriteriaMaxIterations);
+	// main context goes first, additional contexts render their tiles concurrently with it
+	std::vector<FireRenderContext*> contexts = { m_contextPtr.get() };
+
+	for (FireRenderContextPtr& workerContextPtr : m_tileWorkerContexts)
+	{
+		contexts.push_back(workerContextPtr.get());
+	}
+
+	for (FireRenderContext* pContext : contexts)
+	{
+		pContext->setSamplesPerUpdate(m_globals.completionCriteriaFinalRender.completionCriteriaMaxIterations);
+
+		// we need to resetup camera because total width and height differs with tileSizeX and tileSizeY
+		pContext->camera().TranslateCameraExplicit(info.totalWidth, info.totalHeight);
+	}
+
+	// main context reads tiles into AOVs of the production render, additional contexts use their own copies
+	std::vector<std::vector<FireRenderAOV>> workerAOVs(contexts.size());
+
+	for (size_t contextIndex = 1; contextIndex < contexts.size(); contextIndex++)
+	{
+		m_aovs->ForEachActiveAOV([&](FireRenderAOV& aov)
+		{
+			workerAOVs[contextIndex].push_back(aov);
+		});
+	}
+
+	auto forEachContextAOV = [&](unsigned int contextIndex, std::function<void(FireRenderAOV& aov)> actionFunc)
+	{
+		if (contextIndex == 0)
+		{
+			m_aovs->ForEachActiveAOV(actionFunc);
+			return;
+		}
+
+		for (FireRenderAOV& aov : workerAOVs[contextIndex])
+		{
+			actionFunc(aov);
+		}
+	};
 
-	// we need to resetup camera because total width and height differs with tileSizeX and tileSizeY
-	m_contextPtr->camera().TranslateCameraExplicit(info.totalWidth, info.totalHeight);
+	std::mutex progressMutex;
 
-	tileRenderer.Render(*m_contextPtr, info, outBuffers, [&](RenderRegion& region, int progress, AOVPixelBuffers& out)
+	auto tileRenderStartTime = GetCurrentChronoTime();
+
+	tileRenderer.Render(contexts, info, outBuffers, [&](unsigned int contextIndex, RenderRegion& region, int progress, AOVPixelBuffers& out)
 	{
+		FireRenderContext& context = *contexts[contextIndex];
+
 		// make proper size
 		unsigned int width = region.getWidth();
 		unsigned int height = region.getHeight();
 
-		m_contextPtr->resize(width, height, true);
+		context.resize(width, height, true);
 
-		m_aovs->setRegion(RenderRegion(width, height), region.getWidth(), region.getHeight());
-		m_aovs->allocatePixels();
+		FireRenderAOV* pRenderViewAOV = nullptr;
+		forEachContextAOV(contextIndex, [&](FireRenderAOV& aov)
+		{
+			aov.setRegion(RenderRegion(width, height), region.getWidth(), region.getHeight());
+			aov.allocatePixels();
 
-		m_contextPtr->render(false);
+			if (aov.id == m_renderViewAOV->id)
+			{
+				pRenderViewAOV = &aov;
+			}
+		});
 
+		context.render(false);
 
-		// copy data to buffer
-		m_aovs->ForEachActiveAOV([&](FireRenderAOV& aov)
+		// copy data to buffer; tiles don't overlap so contexts can write into the same buffers concurrently
+		forEachContextAOV(contextIndex, [&](FireRenderAOV& aov)
 		{
-			aov.readFrameBuffer(*m_contextPtr);
+			aov.readFrameBuffer(context);
 
 			auto it = out.find(aov.id);
 
@@ -1053,16 +1382,21 @@ void FireRenderProduction::RenderTiles()
 		});
 
 		// send data to Maya render view
-		FireRenderThread::RunProcOnMainThread([this, region]()
+		if (pRenderViewAOV != nullptr)
 		{
-			// Update the Maya render view.
-			RenderViewUpdater::UpdateAndRefreshRegion(m_renderViewAOV->pixels.get(), region.getWidth(), region.getHeight(), region);
+			FireRenderThread::RunProcOnMainThread([this, region, pRenderViewAOV]()
+			{
+				// Update the Maya render view.
+				RenderViewUpdater::UpdateAndRefreshRegion(pRenderViewAOV->pixels.get(), region.getWidth(), region.getHeight(), region);
 
-			if (rcWarningDialog.shown)
-				rcWarningDialog.close();
-		});
+				if (rcWarningDialog.shown)
+					rcWarningDialog.close();
+			});
+		}
+
+		std::lock_guard<std::mutex> progressLock(progressMutex);
 
-		m_contextPtr->setProgress(progress);
+		m_contextPtr->setProgress(std::max(progress, m_contextPtr->getProgress()));
 
 		bool isContinue = !m_cancelled;
 
@@ -1075,6 +1409,15 @@ void FireRenderProduction::RenderTiles()
 	}
 	);
 
+	std::string tileRenderTimeStr = string_format("RPR tile render time: %s (tiles: %dx%d, contexts: %d)",
+		getTimeSpentString(TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), tileRenderStartTime)).c_str(),
+		info.tileSizeX, info.tileSizeY, (int)contexts.size());
+
+	FireRenderThread::RunProcOnMainThread([tileRenderTimeStr]()
+	{
+		MGlobal::displayInfo(MString(tileRenderTimeStr.c_str()));
+	});
+
 #ifdef _DEBUG
 #ifdef DUMP_TILES_AOVS_ALL
 	// debug dump resulting AOVs
@@ -1132,7 +1475,7 @@ void FireRenderProduction::RenderFullFrame()
 
 	// Read pixel data for the AOV displayed in the render view.
 	{
-		AutoMutexLock pixelsLock(m_pixelsLock);
+		AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 		m_aovs->readFrameBuffers(*m_contextPtr);
 
 		FireRenderThread::RunProcOnMainThread([this]()
@@ -63,6 +63,15 @@ public:
 	/** Update globals from render settings */
 	void UpdateGlobals(void);
 
+	/** Block until the background Athena upload, including its Python call, is done. Called on plugin unload. */
+	static void WaitForAthenaUpload();
+
+	/** Compare telemetry counters with a full RPR recount when the next render completes. Used by render tests. */
+	static void VerifyTelemetryCountersOnNextRender();
+
+	/** False if the last verified render found counters which differ from the recount. */
+	static bool TelemetryCountersMatched();
+
 	/** Start a threaded IPR render. */
 	bool startFullFrameRender();
 
@@ -121,6 +130,10 @@ private:
 
 	void RenderFullFrame(void);
 	void RenderTiles(void);
+
+	/** Create additional contexts rendering tiles concurrently with the main one. */
+	void CreateTileWorkerContexts(int contextWidth, int contextHeight);
+	void ReleaseTileWorkerContexts(void);
 	void DenoiseFromAOVs(void);
 	void TonemapFromAOVs(void);
 
@@ -145,10 +158,19 @@ private:
 	/*display render time data to log*/
 	void DisplayRenderTimeData();
 
+	/* counters maintained by frw::Scene and frw::Context */
 	size_t GetScenePolyCount() const;
 
 	std::tuple<size_t, long long> GeSceneTexturesCountAndSize() const;
 
+	/* full recounts through RPR, used to verify the maintained counters */
+	size_t RecountScenePolygons() const;
+
+	std::tuple<size_t, long long> RecountSceneTextures() const;
+
+	/* compares maintained counters with a full recount, reports a Maya error on mismatch */
+	bool VerifyAthenaCounters(size_t polygonCount, size_t texturesCount, long long texturesSize) const;
+
 	void OnBufferAvailableCallback(float progress);
 
 private:
@@ -159,6 +181,9 @@ private:
 	/** The FireRender context. */
 	FireRenderContextPtr m_contextPtr;
 
+	/** Additional contexts with the same scene used for concurrent tile rendering. */
+	std::vector<FireRenderContextPtr> m_tileWorkerContexts;
+
 	/** The current camera. */
 	MDagPath m_camera;
 
@@ -195,10 +220,10 @@ private:
 	std::atomic<bool> m_renderViewUpdateScheduled;
 
 	/** A lock to control access to the system memory frame buffer pixels. */
-	std::mutex m_pixelsLock;
+	RPR::ProfiledMutex m_pixelsLock{ "Production::pixels" };
 
 	/** A lock to control access to the RPR context. */
-	std::mutex m_contextLock;
+	RPR::ProfiledMutex m_contextLock{ "Production::context" };
 
 	/** A lock to control access to the RPR context creation and destruction. */
 	std::mutex m_contextCreationLock;
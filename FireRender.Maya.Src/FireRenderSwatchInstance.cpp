@@ -33,6 +33,11 @@ FireRenderSwatchInstance::FireRenderSwatchInstance()
 
 void FireRenderSwatchInstance::initScene()
 {
+	if (!pContext)
+	{
+		pContext = std::make_unique<NorthStarContext>();
+	}
+
 	backgroundRendererBusy = false;
 	m_warningDialogOpen = false;
 
@@ -116,6 +121,11 @@ void FireRenderSwatchInstance::ProcessInRenderThread()
 			});
 		}
 
+		{
+			RPR::AutoLock<MSpinLock> lock(mutex);
+			m_lastSwatchTime = GetCurrentChronoTime();
+		}
+
 		m_shouldClearContext = true;
 
 		return false;
@@ -153,29 +163,35 @@ FireRenderMaterialSwatchRender* FireRenderSwatchInstance::dequeSwatch()
 	return item;
 }
 
-void FireRenderSwatchInstance::removeFromQueue(FireRenderMaterialSwatchRender* swatch)
+void FireRenderSwatchInstance::RemoveFromQueue(FireRenderMaterialSwatchRender* swatch)
 {
-	RPR::AutoLock<MSpinLock> lock(mutex);
-	queueToProcess.remove(swatch);
+	RPR::AutoLock<MSpinLock> lock(m_instance.mutex);
+	m_instance.queueToProcess.remove(swatch);
 }
 
 void FireRenderSwatchInstance::CheckProcessQueue(float elapsedTime, float lastTime, void* clientData)
 {
-	RPR::AutoLock<MSpinLock> lock(instance().mutex);
+	// m_instance directly: instance() would bring a released scene back
+	RPR::AutoLock<MSpinLock> lock(m_instance.mutex);
+
+	if (!m_instance.m_shouldClearContext || (m_instance.queueToProcess.size() != 0))
+	{
+		return;
+	}
 
-	if (!instance().m_shouldClearContext || (instance().queueToProcess.size() != 0))
+	// keep the translated scene warm while the user keeps browsing
+	if (TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_instance.m_lastSwatchTime) < IdleTimeoutMs)
 	{
 		return;
 	}
 
-	instance().m_shouldClearContext = false;
+	m_instance.m_shouldClearContext = false;
 
-	// reset context
-	instance().cleanScene();
-	instance().pContext.reset();
+	// release context, it is created again with the next swatch request
+	m_instance.cleanScene();
+	m_instance.pContext.reset();
 
-	instance().pContext = std::make_unique<NorthStarContext>();
-	instance().initScene();
+	LogPrint("FireRenderSwatchInstance: swatch scene released after %d ms idle", IdleTimeoutMs);
 }
 
 
@@ -29,7 +29,8 @@ public:
 
 	void enqueSwatch(FireRenderMaterialSwatchRender* swatch);
 	FireRenderMaterialSwatchRender* dequeSwatch();
-	void removeFromQueue(FireRenderMaterialSwatchRender* swatch);
+	// does not go through instance(), so a released scene is not created again for a cancel
+	static void RemoveFromQueue(FireRenderMaterialSwatchRender* swatch);
 
 	FireRenderContext& getContext() { return *pContext.get(); }
 
@@ -48,6 +49,9 @@ private:
 
 	static void CheckProcessQueue(float elapsedTime, float lastTime, void* clientData);
 
+	// scene, IBL and textures stay resident between swatches, freed after this much idle time
+	static const int IdleTimeoutMs = 30000;
+
 private:
 	bool sceneIsCleaned;
 	MSpinLock mutex;
@@ -55,6 +59,7 @@ private:
 	std::unique_ptr<NorthStarContext> pContext;
 	std::atomic<bool> backgroundRendererBusy;
 	std::atomic<bool> m_shouldClearContext;
+	TimePoint m_lastSwatchTime;
 
 	std::list<FireRenderMaterialSwatchRender*> queueToProcess;
 
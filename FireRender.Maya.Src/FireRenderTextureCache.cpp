@@ -44,6 +44,7 @@ bool StoredFrame::Resize(int width, int height)
 		return false;
 
 	m_data.resize(width * height * 4, 0);
+	m_samples = 0;
 	return true;
 }
 
@@ -80,6 +80,9 @@ namespace FireMaya
 	class StoredFrame
 	{
 		std::vector<float> m_data;
+
+		// iterations the frame was rendered with; 0 for frames rendered during playback
+		int m_samples = 0;
 	public:
 		StoredFrame() {}
 		StoredFrame(int width, int height);
@@ -88,6 +91,9 @@ namespace FireMaya
 		operator bool() const { return !m_data.empty(); }
 		bool Resize(int width, int height);	// returns true if reallocated
 
+		int samples() const { return m_samples; }
+		void setSamples(int samples) { m_samples = samples; }
+
 		size_t byteSize() const { return m_data.size() * sizeof(float); }
 	};
 
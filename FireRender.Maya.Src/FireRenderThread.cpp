@@ -25,7 +25,7 @@ namespace FireMaya
 {
 vector<shared_ptr<FireRenderThread::QueueItemBase>> FireRenderThread::itemQueue;
 vector<shared_ptr<FireRenderThread::QueueItemBase>> FireRenderThread::itemQueueForMainThread;
-mutex FireRenderThread::itemQueueMutex;
+RPR::ProfiledMutex FireRenderThread::itemQueueMutex("FireRenderThread::itemQueue");
 unique_ptr<thread> FireRenderThread::ptrWorkerThread;
 atomic_bool FireRenderThread::shouldUseThread { false };
 atomic_bool FireRenderThread::runTheThread { true };
@@ -75,7 +75,7 @@ public:
 
 void FireRenderThread::KeepRunning(std::function<bool()> function)
 {
-	unique_lock<mutex> lock(itemQueueMutex);
+	RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 	CheckThreadIsRunning();
 
@@ -112,7 +112,7 @@ size_t FireRenderThread::RunItemsQueuedForTheMainThread()
 	decltype(itemQueueForMainThread) queue;
 
 	{
-		unique_lock<mutex> lock(itemQueueMutex);
+		RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 		queue = itemQueueForMainThread;
 	}
 
@@ -125,7 +125,7 @@ size_t FireRenderThread::RunItemsQueuedForTheMainThread()
 
 		// Now remove complete items:
 		{
-			unique_lock<mutex> lock(itemQueueMutex);
+			RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 			decltype(itemQueueForMainThread) newQueue;
 
 			for (auto item : itemQueueForMainThread)
@@ -185,7 +185,7 @@ void FireRenderThread::ThreadProc(void *)
 		decltype(itemQueue) queue;
 
 		{
-			unique_lock<mutex> lock(itemQueueMutex);
+			RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 			queue = itemQueue;
 		}
 
@@ -202,7 +202,7 @@ void FireRenderThread::ThreadProc(void *)
 			}
 
 			{
-				unique_lock<mutex> lock(itemQueueMutex);
+				RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 				decltype(itemQueue) newQueue;
 
 				for (auto item : itemQueue)
@@ -223,7 +223,7 @@ void FireRenderThread::ThreadProc(void *)
 
 void FireRenderThread::KeepRunningOnMainThread(std::function<bool()> function)
 {
-	unique_lock<mutex> lock(itemQueueMutex);
+	RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 	CheckThreadIsRunning();
 
@@ -17,6 +17,7 @@ limitations under the License.
 #include <vector>
 #include <set>
 #include <mutex>
+#include "ProfiledMutex.h"
 #include <future>
 #include <thread>
 #include <exception>
@@ -139,7 +140,7 @@ private:
 	static std::vector<std::shared_ptr<QueueItemBase>> itemQueue;
 	static std::vector<std::shared_ptr<QueueItemBase>> itemQueueForMainThread;
 	static std::set<std::thread::id> executingThreadIds;
-	static std::mutex itemQueueMutex;
+	static RPR::ProfiledMutex itemQueueMutex;
 	static std::unique_ptr<std::thread> ptrWorkerThread;
 	static std::atomic_bool shouldUseThread;
 	static std::atomic_bool runTheThread;
@@ -162,7 +163,7 @@ public:
 
 			if (shouldPostToQueue)
 			{
-				std::unique_lock<std::mutex> lock(itemQueueMutex);
+				RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 				itemQueue.emplace(itemQueue.begin(), ptr);
 			}
@@ -183,7 +184,7 @@ public:
 		{
 			if (CheckThreadIsRunning())
 			{
-				std::unique_lock<std::mutex> lock(itemQueueMutex);
+				RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 				itemQueue.emplace(itemQueue.begin(), ptr);
 			}
@@ -209,7 +210,7 @@ public:
 			}
 			else
 			{
-				std::unique_lock<std::mutex> lock(itemQueueMutex);
+				RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 				itemQueueForMainThread.push_back(ptr);
 			}
@@ -228,7 +229,7 @@ public:
 			}
 			else
 			{
-				std::unique_lock<std::mutex> lock(itemQueueMutex);
+				RPR::AutoProfiledLock lock(itemQueueMutex, __FUNCTION__);
 
 				itemQueueForMainThread.push_back(ptr);
 			}
@@ -34,6 +34,7 @@ limitations under the License.
 #include <vector>
 #include <time.h>
 #include <iostream>
+#include <sstream>
 
 #include "attributeNames.h"
 #include "OptionVarHelpers.h"
@@ -46,6 +47,9 @@ limitations under the License.
 #include <ShlObj.h>
 #include <comdef.h>
 #include <Wbemidl.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
 #endif
 
 #ifdef __linux__
@@ -66,6 +70,7 @@ limitations under the License.
 #endif
 
 #pragma comment(lib, "wbemuuid.lib")
+#pragma comment(lib, "psapi.lib")
 
 FireRenderGlobalsData::FireRenderGlobalsData() :
 	adaptiveTileSize(1),
@@ -109,6 +114,7 @@ FireRenderGlobalsData::FireRenderGlobalsData() :
 	tileRenderingEnabled(false),
 	tileSizeX(0),
 	tileSizeY(0),
+	tileRenderContextCount(1),
 	cameraType(0),
 	useMPS(false),
 	useDetailedContextWorkLog(false),
@@ -308,6 +314,10 @@ void FireRenderGlobalsData::readFromCurrentScene()
 		if (!plug.isNull())
 			tileSizeY = plug.asInt();
 
+		plug = frGlobalsNode.findPlug("tileRenderContexts");
+		if (!plug.isNull())
+			tileRenderContextCount = plug.asInt();
+
 		// In UI raycast epsilon defined in 1/10 of scene units, convert it to meters
 		plug = frGlobalsNode.findPlug("raycastEpsilon");
 		if (!plug.isNull())
@@ -566,6 +576,40 @@ bool FireRenderGlobalsData::isExrMultichannelEnabled()
 	return false;
 }
 
+bool FireRenderGlobalsData::isViewportHalfFloatTextureEnabled()
+{
+	MObject fireRenderGlobals;
+	GetRadeonProRenderGlobals(fireRenderGlobals);
+
+	// Get Fire render globals attributes
+	MFnDependencyNode frGlobalsNode(fireRenderGlobals);
+
+	MPlug plug = frGlobalsNode.findPlug("viewportHalfFloatTexture");
+	if (!plug.isNull())
+	{
+		return plug.asBool();
+	}
+
+	return false;
+}
+
+bool FireRenderGlobalsData::isViewportTextureUploadStatsEnabled()
+{
+	MObject fireRenderGlobals;
+	GetRadeonProRenderGlobals(fireRenderGlobals);
+
+	// Get Fire render globals attributes
+	MFnDependencyNode frGlobalsNode(fireRenderGlobals);
+
+	MPlug plug = frGlobalsNode.findPlug("viewportTextureUploadStats");
+	if (!plug.isNull())
+	{
+		return plug.asBool();
+	}
+
+	return false;
+}
+
 void FireRenderGlobalsData::readAirVolumeParameters(const MFnDependencyNode& frGlobalsNode)
 {
 	MPlug plug = frGlobalsNode.findPlug("airVolumeEnabled");
@@ -1732,6 +1776,26 @@ std::vector<HardwareResources::Device> HardwareResources::GetAllDevices()
 	return self._devices;
 }
 
+std::string HardwareResources::GetHardwareSignature()
+{
+	const HardwareResources& self = GetInstance();
+
+	std::ostringstream signature;
+
+	for (const Device& device : self._devices)
+	{
+		signature << device.name << ":" << device.creationFlag << ";";
+	}
+
+	for (const Driver& driver : self._drivers)
+	{
+		signature << std::string(driver.deviceName.begin(), driver.deviceName.end()) << "="
+			<< std::string(driver.name.begin(), driver.name.end()) << ";";
+	}
+
+	return signature.str();
+}
+
 HardwareResources::HardwareResources()
 {
 	if (std::getenv("RPR_MAYA_DISABLE_GPU"))
@@ -2440,4 +2504,27 @@ TimePoint GetCurrentChronoTime()
 	return std::chrono::high_resolution_clock::now();
 }
 
+size_t GetPeakResidentMemoryMB()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters = { 0 };
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize / (1024 * 1024);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef OSMac_
+	// bytes on macOS
+	return (size_t) usage.ru_maxrss / (1024 * 1024);
+#else
+	// kilobytes on Linux
+	return (size_t) usage.ru_maxrss / 1024;
+#endif
+#endif
+}
+
 
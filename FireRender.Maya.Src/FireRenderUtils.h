@@ -205,6 +205,8 @@ public:
 	static void getCPUThreadSetup(bool& overriden, int& cpuThreadCount, RenderType renderType);
 	static int getThumbnailIterCount(bool* pSwatchesEnabled = nullptr);
 	static bool isExrMultichannelEnabled(void);
+	static bool isViewportHalfFloatTextureEnabled(void);
+	static bool isViewportTextureUploadStatsEnabled(void);
 
 public:
 
@@ -336,6 +338,7 @@ public:
 	bool tileRenderingEnabled;
 	int tileSizeX;
 	int tileSizeY;
+	int tileRenderContextCount;
 
 	// AOVs.
 	FireRenderAOVs aovs;
@@ -500,6 +503,9 @@ public:
 	static std::vector<Device> GetCompatibleGPUs(bool onlyCertified = false);
 	static std::vector<Device> GetAllDevices();
 
+	// device names, creation flags and driver versions; changes when hardware or drivers change
+	static std::string GetHardwareSignature();
+
 private:
 
 	std::vector<Device> _devices;
@@ -1140,8 +1146,8 @@ frw::BufferNode CreateRPRRampNode(std::vector<RampCtrlPoint<valType>>& rampCtrlP
 	std::vector<valType> remapedRampValue(bufferSize, valType());
 	RemapRampControlPoints(remapedRampValue.size(), remapedRampValue, rampCtrlPoints);
 
-	// create buffer
-	frw::DataBuffer dataBuffer(scope.Context(), bufferDesc, &remapedRampValue[0][0]);
+	// identical ramps share one buffer
+	frw::DataBuffer dataBuffer = scope.Context().GetSharedDataBuffer(bufferDesc, &remapedRampValue[0][0]);
 
 	// create buffer node
 	frw::BufferNode bufferNode(scope.MaterialSystem());
@@ -1317,6 +1323,9 @@ T ProcessEnvVarsInFilePath(const C* in)
 
 TimePoint GetCurrentChronoTime();
 
+// Peak resident memory of the Maya process since start, in megabytes (0 if not available)
+size_t GetPeakResidentMemoryMB();
+
 template <typename T>
 long TimeDiffChrono(TimePoint currTime, TimePoint startTime)
 {
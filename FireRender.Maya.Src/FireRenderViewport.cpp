@@ -10,7 +10,9 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ********************************************************************/
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <sstream>
 #include <functional>
 
@@ -26,6 +28,8 @@ limitations under the License.
 #include <maya/MGlobal.h>
 #include <maya/MRenderView.h>
 #include <maya/MAnimControl.h>
+#include <maya/MTimerMessage.h>
+#include <maya/MEventMessage.h>
 #include <maya/MTextureManager.h>
 #include "AutoLock.h"
 
@@ -42,6 +46,15 @@ using namespace FireMaya;
 
 //#define HIGHLIGHT_TEXTURE_UPDATES	1	// debugging: every update will draw a color line on top of the rendered picture
 
+namespace
+{
+	// used for range caching when neither the command nor viewport completion criteria limit samples
+	const int DefaultCacheRangeSamples = 32;
+
+	// timer callbacks are only delivered when Maya is idle, so UI events are handled between frames
+	const float CacheRangeTimerPeriod = 0.01f;
+}
+
 MStatus FireRenderViewport::FindMayaView(const MString& panelName, M3dView *view)
 {
     // Get the Maya 3D view.
@@ -90,6 +103,13 @@ FireRenderViewport::FireRenderViewport(const MString& panelName) :
 // -----------------------------------------------------------------------------
 FireRenderViewport::~FireRenderViewport()
 {
+	// The panel is going away, so only drop the range callbacks.
+	if (isCachingRange())
+	{
+		MTimerMessage::removeCallback(m_cacheRange.callbackId);
+		MMessage::removeCallbacks(m_cacheRange.interruptCallbacks);
+	}
+
 	// Stop the render thread if required. Executed in context of the main thread.
 	stop();
 	// Now cleanup resources in context of rendering thread.
@@ -122,7 +142,7 @@ MStatus FireRenderViewport::setup()
 	if (m_pixelsUpdated)
 	{
 		// Acquire the pixels lock.
-		AutoMutexLock pixelsLock(m_pixelsLock);
+		AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 		// Update the Maya texture from the internal pixel data.
 		m_pCurrentTexture->UpdateTexture();
@@ -165,9 +185,10 @@ MStatus FireRenderViewport::doSetup()
 	bool animating = MAnimControl::isPlaying() || MAnimControl::isScrubbing();
 	m_contextPtr->updateLimits(animating);
 
-	// Check if animation caching should be used.
+	// Check if animation caching should be used. While a frame
+	// range is pre-rendered the viewport shows the cached frames.
 	bool useAnimationCache =
-		animating && m_useAnimationCache;
+		(animating || isCachingRange()) && m_useAnimationCache;
 
 	// Stop the viewport render thread if using cached frames.
 	if (m_isRunning && useAnimationCache)
@@ -300,11 +321,11 @@ bool FireRenderViewport::RunOnViewportThread()
 
 				// Perform a render iteration.
 				{
-					AutoMutexLock contextLock(m_contextLock);
+					AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 					
 					if (!NorthStarContext::IsGivenContextNorthStar(m_contextPtr.get()))
 					{
-						AutoMutexLock pixelsLock(m_pixelsLock);
+						AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 						m_contextPtr->render(false);
 						m_closeDialogNeeded = true;
@@ -339,8 +360,8 @@ bool FireRenderViewport::RunOnViewportThread()
 			if (IsDenoiserUpscalerEnabled() && !m_showUpscaledFrame)
 			{
 				{
-					AutoMutexLock contextLock(m_contextLock);
-					AutoMutexLock pixelsLock(m_pixelsLock);
+					AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
+					AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 					m_showUpscaledFrame = true;
 
@@ -450,7 +471,7 @@ void FireRenderViewport::setViewportRenderMode(int renderMode)
 {
 	FireRenderThread::RunOnceProcAndWait([this, renderMode]()
 	{
-		AutoMutexLock contextLock(m_contextLock);
+		AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 		m_contextPtr->setRenderMode(static_cast<FireRenderContext::RenderMode>(renderMode));
 		m_contextPtr->setDirty();
 		m_view.scheduleRefresh();
@@ -470,13 +491,219 @@ void FireRenderViewport::clearTextureCache()
 	m_view.scheduleRefresh();
 }
 
+// -----------------------------------------------------------------------------
+bool FireRenderViewport::startCacheRange(double startFrame, double endFrame, int samples)
+{
+	MAIN_THREAD_ONLY;
+
+	if (!m_useAnimationCache)
+	{
+		MGlobal::displayError("Animation cache is disabled for this viewport");
+		return false;
+	}
+
+	if (endFrame < startFrame)
+	{
+		MGlobal::displayError("Cache range end frame is less than start frame");
+		return false;
+	}
+
+	// restart the range if it is already being cached
+	if (isCachingRange())
+		finishCacheRange(true);
+
+	if (samples <= 0)
+	{
+		const CompletionCriteriaParams& viewportCriteria = m_contextPtr->getCompletionCriteria();
+
+		samples = viewportCriteria.isUnlimitedIterations() ?
+			DefaultCacheRangeSamples : viewportCriteria.completionCriteriaMaxIterations;
+	}
+
+	m_cacheRange = CacheRangeJob();
+	m_cacheRange.startFrame = startFrame;
+	m_cacheRange.endFrame = endFrame;
+	m_cacheRange.nextFrame = startFrame;
+	m_cacheRange.samples = samples;
+	m_cacheRange.restoreTime = MAnimControl::currentTime();
+	m_cacheRange.startTime = GetCurrentChronoTime();
+
+	MStatus status;
+	m_cacheRange.callbackId = MTimerMessage::addTimerCallback(CacheRangeTimerPeriod, FireRenderViewport::CacheRangeTimerCallback, this, &status);
+	if (status != MStatus::kSuccess)
+	{
+		m_cacheRange.callbackId = 0;
+		MGlobal::displayError("Unable to start caching the frame range");
+		return false;
+	}
+
+	// Every user edit goes through the undo queue. Caching would render the edit
+	// at another time than the user is looking at, so the job stops instead.
+	for (const char* eventName : { "undoSupported", "Undo", "Redo", "SelectionChanged" })
+	{
+		MCallbackId callbackId = MEventMessage::addEventCallback(eventName, FireRenderViewport::CacheRangeInterruptCallback, this, &status);
+		if (status == MStatus::kSuccess)
+			m_cacheRange.interruptCallbacks.append(callbackId);
+	}
+
+	LogPrint("Viewport %s: caching frames %g-%g at %d samples", m_panelName.asChar(), startFrame, endFrame, samples);
+
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::cancelCacheRange()
+{
+	if (isCachingRange())
+		finishCacheRange(true);
+}
+
+// -----------------------------------------------------------------------------
+double FireRenderViewport::cacheRangeProgress() const
+{
+	if (!isCachingRange())
+		return -1.0;
+
+	double frameCount = std::floor(m_cacheRange.endFrame - m_cacheRange.startFrame) + 1.0;
+
+	return std::min(1.0, (m_cacheRange.nextFrame - m_cacheRange.startFrame) / frameCount);
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::CacheRangeTimerCallback(float, float, void* clientData)
+{
+	FireRenderViewport* viewport = static_cast<FireRenderViewport*>(clientData);
+
+	try
+	{
+		viewport->cacheNextRangeFrame();
+	}
+	catch (...)
+	{
+		viewport->m_error.set(current_exception());
+		viewport->finishCacheRange(true);
+	}
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::CacheRangeInterruptCallback(void* clientData)
+{
+	// The timer stops the job, so the time isn't changed from inside a command.
+	static_cast<FireRenderViewport*>(clientData)->m_cacheRange.interrupted = true;
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::cacheNextRangeFrame()
+{
+	MAIN_THREAD_ONLY;
+
+	if (m_cacheRange.interrupted)
+	{
+		MGlobal::displayInfo("RPR viewport cache: stopped by a scene or selection change");
+		finishCacheRange(true);
+		return;
+	}
+
+	if (m_cacheRange.nextFrame > m_cacheRange.endFrame)
+	{
+		finishCacheRange(false);
+		return;
+	}
+
+	// Don't fight the user over the current time; resume once playback stops.
+	if (MAnimControl::isPlaying() || MAnimControl::isScrubbing())
+		return;
+
+	// The context can't be shared with the interactive render.
+	if (m_isRunning)
+		stop();
+
+	// Nothing to render into until the viewport has been set up.
+	if (m_contextPtr->width() == 0 || m_contextPtr->height() == 0)
+		return;
+
+	double frameNumber = m_cacheRange.nextFrame;
+	m_cacheRange.nextFrame += 1.0;
+
+	// Scene objects pick the new time up through their dirty callbacks.
+	MAnimControl::setCurrentTime(MTime(frameNumber, MTime::uiUnit()));
+
+	if (refreshContext() != MStatus::kSuccess)
+	{
+		finishCacheRange(true);
+		return;
+	}
+
+	{
+		AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
+
+		// Get the frame hash.
+		auto hash = m_contextPtr->GetStateHash();
+		stringstream ss;
+		ss << m_panelName.asChar() << ";" << size_t(hash);
+
+		// Frames cached by an earlier range with enough samples are kept, frames cached during playback are re-rendered.
+		auto& frame = m_renderedFramesCache[ss.str().c_str()];
+		bool resized = frame.Resize(m_contextPtr->width(), m_contextPtr->height());
+		if (resized || (frame.samples() < m_cacheRange.samples))
+		{
+			CompletionCriteriaParams viewportCriteria = m_contextPtr->getCompletionCriteria();
+
+			CompletionCriteriaParams cacheCriteria;
+			cacheCriteria.completionCriteriaMaxIterations = m_cacheRange.samples;
+			m_contextPtr->setCompletionCriteria(cacheCriteria);
+			m_contextPtr->setStartedRendering();
+
+			do
+			{
+				m_contextPtr->render();
+			} while (m_contextPtr->keepRenderRunning());
+
+			readFrameBuffer(&frame);
+			frame.setSamples(m_cacheRange.samples);
+
+			m_contextPtr->setCompletionCriteria(viewportCriteria);
+		}
+	}
+
+	m_cacheRange.renderedCount++;
+
+	int frameCount = (int) std::floor(m_cacheRange.endFrame - m_cacheRange.startFrame) + 1;
+	MString progress;
+	progress.format("RPR viewport cache: frame ^1s (^2s/^3s)", MString() + frameNumber, MString() + m_cacheRange.renderedCount, MString() + frameCount);
+	MGlobal::displayInfo(progress);
+
+	m_view.scheduleRefresh();
+}
+
+// -----------------------------------------------------------------------------
+void FireRenderViewport::finishCacheRange(bool cancelled)
+{
+	MTimerMessage::removeCallback(m_cacheRange.callbackId);
+	m_cacheRange.callbackId = 0;
+
+	MMessage::removeCallbacks(m_cacheRange.interruptCallbacks);
+	m_cacheRange.interruptCallbacks.clear();
+
+	long elapsed = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_cacheRange.startTime);
+	LogPrint("Viewport %s: %s caching %d frame(s) in %ld ms", m_panelName.asChar(),
+		cancelled ? "cancelled after" : "finished", m_cacheRange.renderedCount, elapsed);
+
+	// Go back to the frame the user was on; the viewport resumes interactive rendering.
+	if (!gExitingMaya)
+	{
+		MAnimControl::setCurrentTime(m_cacheRange.restoreTime);
+		m_view.scheduleRefresh();
+	}
+}
+
 // -----------------------------------------------------------------------------
 MStatus FireRenderViewport::cameraChanged(MDagPath& cameraPath)
 {
 	auto status = FireRenderThread::RunOnceAndWait<MStatus>([this, &cameraPath]() -> MStatus
 	{
 
-		AutoMutexLock contextLock(m_contextLock);
+		AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 
 		try
 		{
@@ -574,8 +801,14 @@ bool FireRenderViewport::initialize()
 // -----------------------------------------------------------------------------
 void FireRenderViewport::cleanUp()
 {
-	// Clean the RPR scene.
-	m_contextPtr->cleanScene();
+	// Clean the RPR scene and release the context in background.
+	if (m_contextPtr)
+	{
+		FireRenderContextPtr refToKeepAlive = m_contextPtr;
+		m_contextPtr.reset();
+
+		refToKeepAlive->cleanSceneAsync(refToKeepAlive);
+	}
 
 	// Delete the hardware backed texture.
 	// Do not delete when exiting Maya - this will cause access violation
@@ -621,8 +854,8 @@ MStatus FireRenderViewport::getSize(unsigned int& width, unsigned int& height)
 MStatus FireRenderViewport::resize(unsigned int width, unsigned int height)
 {
 	// Acquire the context and pixels locks.
-	AutoMutexLock contextLock(m_contextLock);
-	AutoMutexLock pixelsLock(m_pixelsLock);
+	AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
+	AutoProfiledLock pixelsLock(m_pixelsLock, __FUNCTION__);
 
 	try
 	{
@@ -673,6 +906,15 @@ void FireRenderViewport::resizeFrameBufferStandard(unsigned int width, unsigned
 	// Update the RPR context dimensions.
 	m_contextPtr->resize(width, height, false);
 
+	// Half float textures halve the upload size at the cost of precision.
+	bool halfFloatTexture = FireRenderGlobalsData::isViewportHalfFloatTextureEnabled();
+	m_texture.SetHalfFloat(halfFloatTexture);
+	m_textureUpscaled.SetHalfFloat(halfFloatTexture);
+
+	bool uploadStats = FireRenderGlobalsData::isViewportTextureUploadStatsEnabled();
+	m_texture.SetUploadStats(uploadStats);
+	m_textureUpscaled.SetUploadStats(uploadStats);
+
 	// Resize the pixel buffer that
 	// will receive frame buffer data.
 	m_texture.Resize(width, height);
@@ -715,7 +957,7 @@ MStatus FireRenderViewport::renderCached(unsigned int width, unsigned int height
 		bool shouldRender = frame.Resize(width, height); // returns false if frame is not empty
 		if (shouldRender)
 		{
-			AutoMutexLock contextLock(m_contextLock);
+			AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 
 			m_contextPtr->render();
 			readFrameBuffer(&frame);
@@ -886,7 +1128,7 @@ void FireRenderViewport::setCurrentAOV(int aov)
 		return;
 	}
 
-	AutoMutexLock contextLock(m_contextLock);
+	AutoProfiledLock contextLock(m_contextLock, __FUNCTION__);
 
 	// turning off previous selected aov if it is not color        
 	if (!isAOVShouldBeAlwaysEnabled(m_currentAOV))
@@ -22,6 +22,7 @@ limitations under the License.
 #include <maya/MFrameContext.h>
 #include <maya/M3dView.h>
 #include <maya/MUiMessage.h>
+#include <maya/MTime.h>
 #include <maya/MShaderManager.h>
 #include "Context/FireRenderContext.h"
 #include "FireRenderTextureCache.h"
@@ -79,6 +80,22 @@ public:
 	/** Clear the animation frame texture cache. */
 	void clearTextureCache();
 
+	/**
+	 * Pre-render frames [startFrame, endFrame] into the animation cache.
+	 * The job takes over the current time: on each timer tick it sets the time
+	 * to the next frame and renders it to the given sample count, blocking Maya
+	 * for that frame. The user's time is restored when the job ends.
+	 * Playback and scrubbing hold the job; a scene edit, undo, redo or
+	 * selection change cancels it, keeping the frames cached so far.
+	 */
+	bool startCacheRange(double startFrame, double endFrame, int samples);
+
+	/** Stop pre-rendering the frame range. Frames rendered so far stay cached. */
+	void cancelCacheRange();
+
+	/** Fraction of the frame range cached so far, or -1 if no range is being cached. */
+	double cacheRangeProgress() const;
+
 	/** Return the hardware texture. */
 	ViewportTexture* getTexture() const;
 
@@ -144,10 +161,10 @@ private:
 	bool m_pixelsUpdated;
 
 	/** A lock to control access to the system memory frame buffer pixels. */
-	std::mutex m_pixelsLock;
+	RPR::ProfiledMutex m_pixelsLock{ "Viewport::pixels" };
 
 	/** A lock to control access to the RPR context. */
-	std::mutex m_contextLock;
+	RPR::ProfiledMutex m_contextLock{ "Viewport::context" };
 
 	/** Error handler. */
 	FireRenderError m_error;
@@ -171,6 +188,23 @@ private:
 
 	ViewportTexture* m_pCurrentTexture;
 
+	/** State of the frame range being pre-rendered into the animation cache. */
+	struct CacheRangeJob
+	{
+		double startFrame = 0.0;
+		double endFrame = 0.0;
+		double nextFrame = 0.0;
+		int samples = 0;
+		int renderedCount = 0;
+		MTime restoreTime;
+		MCallbackId callbackId = 0;
+		MCallbackIdArray interruptCallbacks;
+		bool interrupted = false;
+		TimePoint startTime;
+	};
+
+	CacheRangeJob m_cacheRange;
+
 	// Private Methods
 	// -----------------------------------------------------------------------------
 private:
@@ -198,6 +232,21 @@ private:
 	/** Render a cached frame. */
 	MStatus renderCached(unsigned int width, unsigned int height);
 
+	/** True while a frame range is being pre-rendered into the cache. */
+	bool isCachingRange() const { return m_cacheRange.callbackId != 0; }
+
+	/** Timer callback rendering the next frame of the cached range. */
+	static void CacheRangeTimerCallback(float elapsedTime, float lastTime, void* clientData);
+
+	/** Event callback flagging that the user changed the scene or selection while caching. */
+	static void CacheRangeInterruptCallback(void* clientData);
+
+	/** Render the next frame of the range into the animation cache. */
+	void cacheNextRangeFrame();
+
+	/** Remove the range callbacks and restore the current time. */
+	void finishCacheRange(bool cancelled);
+
 	/** Refresh the RPR context. */
 	MStatus refreshContext();
 
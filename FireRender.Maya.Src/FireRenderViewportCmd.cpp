@@ -13,6 +13,7 @@ limitations under the License.
 #include "FireRenderViewportCmd.h"
 #include "FireRenderViewport.h"
 #include "FireRenderViewportManager.h"
+#include <maya/MGlobal.h>
 
 #include <vector>
 #include <functional>
@@ -43,6 +44,10 @@ MSyntax FireRenderViewportCmd::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kViewportModeFlag, kViewportModeFlagLong, MSyntax::kString));
 	CHECK_MSTATUS(syntax.addFlag(kRefreshFlag, kRefreshFlagLong, MSyntax::kNoArg));
 	CHECK_MSTATUS(syntax.addFlag(kViewportAOVFlag, kViewportAOVFlagLong, MSyntax::kLong));
+	CHECK_MSTATUS(syntax.addFlag(kCacheRangeFlag, kCacheRangeFlagLong, MSyntax::kDouble, MSyntax::kDouble));
+	CHECK_MSTATUS(syntax.addFlag(kCacheSamplesFlag, kCacheSamplesFlagLong, MSyntax::kLong));
+	CHECK_MSTATUS(syntax.addFlag(kCacheRangeCancelFlag, kCacheRangeCancelFlagLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kCacheRangeProgressFlag, kCacheRangeProgressFlagLong, MSyntax::kNoArg));
 
 	return syntax;
 }
@@ -89,6 +94,9 @@ MStatus FireRenderViewportCmd::doIt(const MArgList & args)
 		vector<function<void(FireRenderViewport*)>> viewportActions;
 		FireRenderViewportManager& manager = FireRenderViewportManager::instance();
 
+		// -cacheRange fails the command if the range could not be started
+		bool cacheRangeFailed = false;
+
 		if (argData.isFlagSet(kClearFlag))
 		{
 			//clear cache
@@ -133,6 +141,46 @@ MStatus FireRenderViewportCmd::doIt(const MArgList & args)
 			});
 		}
 
+		if (argData.isFlagSet(kCacheRangeCancelFlag))
+		{
+			viewportActions.push_back([](FireRenderViewport* viewport)
+			{
+				viewport->cancelCacheRange();
+			});
+		}
+
+		if (argData.isFlagSet(kCacheRangeFlag))
+		{
+			double startFrame = 0.0;
+			double endFrame = 0.0;
+			argData.getFlagArgument(kCacheRangeFlag, 0, startFrame);
+			argData.getFlagArgument(kCacheRangeFlag, 1, endFrame);
+
+			// 0 means viewport completion criteria
+			int samples = 0;
+			if (argData.isFlagSet(kCacheSamplesFlag))
+			{
+				argData.getFlagArgument(kCacheSamplesFlag, 0, samples);
+			}
+
+			viewportActions.push_back([=, &cacheRangeFailed](FireRenderViewport* viewport)
+			{
+				if (!viewport->startCacheRange(startFrame, endFrame, samples))
+					cacheRangeFailed = true;
+			});
+		}
+
+		if (argData.isFlagSet(kCacheRangeProgressFlag))
+		{
+			// reports -1 if the panel has no RPR viewport
+			setResult(-1.0);
+
+			viewportActions.push_back([this](FireRenderViewport* viewport)
+			{
+				setResult(viewport->cacheRangeProgress());
+			});
+		}
+
 		if (argData.isFlagSet(kRefreshFlag) && panelName != "")
 		{
 			viewportActions.push_back([=](FireRenderViewport* viewport)
@@ -149,7 +197,20 @@ MStatus FireRenderViewportCmd::doIt(const MArgList & args)
 				for (auto viewportAction : viewportActions)
 					viewportAction(viewport);
 			}
+			else if (argData.isFlagSet(kCacheRangeFlag))
+			{
+				MGlobal::displayError("Panel " + panelName + " has no RPR viewport to cache frames in");
+				cacheRangeFailed = true;
+			}
 		}
+		else if (argData.isFlagSet(kCacheRangeFlag))
+		{
+			MGlobal::displayError("-cacheRange needs a -panel");
+			cacheRangeFailed = true;
+		}
+
+		if (cacheRangeFailed)
+			return MStatus::kFailure;
 	}
 	catch (...)
 	{
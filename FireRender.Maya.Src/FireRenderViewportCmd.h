@@ -34,6 +34,23 @@ limitations under the License.
 #define kRefreshFlag "-rf"
 #define kRefreshFlagLong "-refresh"
 
+#define kCacheRangeFlag "-cr"
+#define kCacheRangeFlagLong "-cacheRange"
+
+#define kCacheSamplesFlag "-cs"
+#define kCacheSamplesFlagLong "-cacheSamples"
+
+#define kCacheRangeCancelFlag "-crc"
+#define kCacheRangeCancelFlagLong "-cacheRangeCancel"
+
+#define kCacheRangeProgressFlag "-crp"
+#define kCacheRangeProgressFlagLong "-cacheRangeProgress"
+
+/**
+ * fireRenderViewport -panel modelPanel4 -cacheRange 1 120 -cacheSamples 64;	// pre-render frames into the animation cache
+ * fireRenderViewport -panel modelPanel4 -cacheRangeProgress;				// returns 0..1, or -1 when not caching
+ * fireRenderViewport -panel modelPanel4 -cacheRangeCancel;
+ */
 class FireRenderViewportCmd : public MPxCommand
 {
 public:
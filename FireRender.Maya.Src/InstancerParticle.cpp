@@ -0,0 +1,333 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include <InstancerParticle.h>
+#include <FireRenderMeshMASH.h>
+#include <FireRenderUtils.h>
+#include <maya/MFnInstancer.h>
+#include <maya/MItDag.h>
+#include <maya/MUuid.h>
+
+namespace
+{
+	bool IsSameIntArray(const MIntArray& lhs, const MIntArray& rhs)
+	{
+		if (lhs.length() != rhs.length())
+			return false;
+
+		for (unsigned int idx = 0; idx < lhs.length(); ++idx)
+		{
+			if (lhs[idx] != rhs[idx])
+				return false;
+		}
+
+		return true;
+	}
+}
+
+InstancerParticle::InstancerParticle(FireRenderContext* context, const MDagPath& dagPath) :
+	FireRenderNode(context, dagPath),
+	m_topologyChanged(true)
+{
+}
+
+InstancerParticle::~InstancerParticle()
+{
+	ClearInstances();
+	m_prototypes.clear();
+}
+
+bool InstancerParticle::IsParticleInstancer(const MObject& instancer)
+{
+	MFnDependencyNode instancerNode(instancer);
+	MPlug inputPointsPlug = instancerNode.findPlug("inputPoints");
+	if (inputPointsPlug.isNull())
+		return false;
+
+	MPlugArray connectedTo;
+	inputPointsPlug.connectedTo(connectedTo, true, false);
+
+	for (const MPlug connection : connectedTo)
+	{
+		// nParticle derives from particle
+		if (connection.node().hasFn(MFn::kParticle))
+			return true;
+	}
+
+	return false;
+}
+
+void InstancerParticle::RegisterCallbacks()
+{
+	FireRenderNode::RegisterCallbacks();
+
+	if (context()->getCallbackCreationDisabled())
+		return;
+
+	AddCallback(MNodeMessage::addNodeDirtyPlugCallback(m.object, plugDirty_callback, this));
+}
+
+void InstancerParticle::OnPlugDirty(MObject& node, MPlug& plug)
+{
+	(void) node;
+	(void) plug;
+
+	setDirty();
+}
+
+void InstancerParticle::ReadInstances()
+{
+	MStatus status;
+	MFnInstancer instancer(DagPath(), &status);
+	if (status != MStatus::kSuccess)
+		return;
+
+	// single bulk call; returns prototype paths, one matrix per particle and particle -> paths mapping
+	MDagPathArray paths;
+	MIntArray pathStartIndices;
+	MIntArray pathIndices;
+	status = instancer.allInstances(paths, m_matrices, pathStartIndices, pathIndices);
+	if (status != MStatus::kSuccess)
+	{
+		m_matrices.clear();
+		pathStartIndices.clear();
+		pathIndices.clear();
+	}
+
+	std::vector<std::string> pathNames;
+	pathNames.reserve(paths.length());
+	for (unsigned int idx = 0; idx < paths.length(); ++idx)
+	{
+		pathNames.push_back(paths[idx].fullPathName().asChar());
+	}
+
+	if (pathNames != m_pathNames)
+	{
+		m_pathNames = std::move(pathNames);
+		GeneratePrototypes(paths);
+		m_topologyChanged = true;
+	}
+
+	if (!IsSameIntArray(pathStartIndices, m_pathStartIndices) || !IsSameIntArray(pathIndices, m_pathIndices))
+	{
+		m_pathStartIndices = pathStartIndices;
+		m_pathIndices = pathIndices;
+		m_topologyChanged = true;
+	}
+}
+
+void InstancerParticle::GeneratePrototypes(const MDagPathArray& paths)
+{
+	ClearInstances();
+	m_prototypes.clear();
+	m_prototypes.resize(paths.length());
+
+	for (unsigned int pathIdx = 0; pathIdx < paths.length(); ++pathIdx)
+	{
+		MItDag itDag;
+		itDag.reset(paths[pathIdx], MItDag::kDepthFirst, MFn::kMesh);
+
+		for (; !itDag.isDone(); itDag.next())
+		{
+			MDagPath meshPath;
+			if (itDag.getPath(meshPath) != MStatus::kSuccess)
+				continue;
+
+			FireRenderMesh* renderMesh = dynamic_cast<FireRenderMesh*>(context()->getRenderObject(meshPath));
+			if (!renderMesh)
+				continue;
+
+			// prototype is translated by instancer itself: source mesh is usually hidden and thus has no rpr shape
+			MUuid uuid;
+			uuid.generate();
+
+			Prototype prototype;
+			prototype.mesh = std::make_shared<FireRenderMeshMASH>(*renderMesh, uuid.asString().asChar(), m.object);
+			prototype.meshMatrix = meshPath.inclusiveMatrix();
+
+			m_prototypes[pathIdx].push_back(prototype);
+		}
+	}
+}
+
+void InstancerParticle::GenerateInstances()
+{
+	ClearInstances();
+
+	frw::Context context = Context();
+	unsigned int particleCount = m_pathStartIndices.length() > 0 ? m_pathStartIndices.length() - 1 : 0;
+
+	for (unsigned int particleIdx = 0; particleIdx < particleCount; ++particleIdx)
+	{
+		for (int idx = m_pathStartIndices[particleIdx]; idx < m_pathStartIndices[particleIdx + 1]; ++idx)
+		{
+			for (Prototype& prototype : m_prototypes[m_pathIndices[idx]])
+			{
+				for (const FrElement& element : prototype.mesh->Elements())
+				{
+					if (!element.shape)
+						continue;
+
+					frw::Shape instance = element.shape.CreateInstance(context);
+
+					if (element.shaders.size() == 1)
+					{
+						instance.SetShader(element.shaders.back());
+					}
+
+					m_instances.push_back(instance);
+				}
+			}
+		}
+	}
+
+	m_topologyChanged = false;
+}
+
+void InstancerParticle::UpdateTransforms()
+{
+	unsigned int particleCount = m_pathStartIndices.length() > 0 ? m_pathStartIndices.length() - 1 : 0;
+	size_t instanceIdx = 0;
+
+	for (unsigned int particleIdx = 0; particleIdx < particleCount; ++particleIdx)
+	{
+		const MMatrix& particleMatrix = m_matrices[particleIdx];
+
+		for (int idx = m_pathStartIndices[particleIdx]; idx < m_pathStartIndices[particleIdx + 1]; ++idx)
+		{
+			for (Prototype& prototype : m_prototypes[m_pathIndices[idx]])
+			{
+				// convert Maya mesh in cm to m
+				float mfloats[4][4];
+				FireMaya::ScaleMatrixFromCmToMFloats(prototype.meshMatrix * particleMatrix, mfloats);
+
+				for (const FrElement& element : prototype.mesh->Elements())
+				{
+					if (!element.shape)
+						continue;
+
+					assert(instanceIdx < m_instances.size());
+					m_instances[instanceIdx++].SetTransform(&mfloats[0][0]);
+				}
+			}
+		}
+	}
+}
+
+void InstancerParticle::ClearInstances()
+{
+	detachFromScene();
+	m_instances.clear();
+}
+
+void InstancerParticle::detachFromScene()
+{
+	if (!m_isVisible)
+		return;
+
+	if (auto scene = context()->GetScene())
+	{
+		for (auto& instance : m_instances)
+		{
+			scene.Detach(instance);
+		}
+
+		m_isVisible = false;
+	}
+}
+
+void InstancerParticle::attachToScene()
+{
+	if (m_isVisible)
+		return;
+
+	if (auto scene = context()->GetScene())
+	{
+		for (auto& instance : m_instances)
+		{
+			scene.Attach(instance);
+		}
+
+		m_isVisible = true;
+	}
+}
+
+bool InstancerParticle::ReloadMesh(unsigned int sampleIdx /*= 0*/)
+{
+	if (sampleIdx == 0)
+	{
+		ReadInstances();
+	}
+
+	for (auto& prototypes : m_prototypes)
+	{
+		for (auto& prototype : prototypes)
+		{
+			prototype.mesh->ReloadMesh(sampleIdx);
+		}
+	}
+
+	return true;
+}
+
+void InstancerParticle::Freshen(bool shouldCalculateHash)
+{
+	TimePoint startTime = GetCurrentChronoTime();
+
+	for (auto& prototypes : m_prototypes)
+	{
+		for (auto& prototype : prototypes)
+		{
+			// prototype shape is only a source for instances and should not be rendered by itself
+			prototype.mesh->Rebuild();
+			prototype.mesh->setVisibility(false);
+
+			// geometry was re-translated => instances should be recreated
+			std::vector<frw::Shape> shapes;
+			for (const FrElement& element : prototype.mesh->Elements())
+			{
+				if (element.shape)
+					shapes.push_back(element.shape);
+			}
+
+			if (shapes != prototype.shapes)
+			{
+				prototype.shapes = std::move(shapes);
+				m_topologyChanged = true;
+			}
+		}
+	}
+
+	bool topologyChanged = m_topologyChanged;
+	if (topologyChanged)
+	{
+		GenerateInstances();
+	}
+
+	UpdateTransforms();
+
+	if (DagPath().isVisible())
+	{
+		attachToScene();
+	}
+	else
+	{
+		detachFromScene();
+	}
+
+	FireRenderNode::Freshen(shouldCalculateHash);
+
+	DebugPrint("InstancerParticle: %zu instances (%s) synced in %d ms",
+		m_instances.size(),
+		topologyChanged ? "recreated" : "matrices only",
+		(int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), startTime));
+}
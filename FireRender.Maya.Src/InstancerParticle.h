@@ -0,0 +1,74 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+#include <FireRenderObjects.h>
+#include "Context/FireRenderContext.h"
+#include <maya/MIntArray.h>
+#include <maya/MDagPathArray.h>
+#include <maya/MMatrixArray.h>
+
+// Forward declaration
+class FireRenderMeshMASH;
+
+/**
+	Translator for Maya's classic particle instancer (instancer node driven by particle / nParticle).
+	Each distinct prototype mesh is translated once; every particle is then an rpr instance of it,
+	so the cost per particle is a single shape instance and a matrix.
+	When the particle count and prototype assignment are unchanged only the matrices are updated.
+*/
+class InstancerParticle : public FireRenderNode
+{
+	struct Prototype
+	{
+		std::shared_ptr<FireRenderMeshMASH> mesh;
+		MMatrix meshMatrix;
+		std::vector<frw::Shape> shapes; // shapes instances were made from
+	};
+
+	/** Prototypes translated by the instancer, keyed by instanced path index */
+	std::vector<std::vector<Prototype>> m_prototypes;
+
+	/** Flat list of rpr instances, in allInstances() order */
+	std::vector<frw::Shape> m_instances;
+
+	/** Layout of the last allInstances() call; used to detect topology changes */
+	MIntArray m_pathStartIndices;
+	MIntArray m_pathIndices;
+	std::vector<std::string> m_pathNames;
+	MMatrixArray m_matrices;
+
+	bool m_topologyChanged;
+
+public:
+	InstancerParticle(FireRenderContext* context, const MDagPath& dagPath);
+	virtual ~InstancerParticle();
+
+	virtual void RegisterCallbacks(void) override final;
+	virtual void Freshen(bool shouldCalculateHash) override final;
+	virtual void OnPlugDirty(MObject& node, MPlug& plug) override final;
+	virtual bool ShouldForceReload(void) const override { return true; } // prototypes should be translated before instances are made
+	virtual bool ReloadMesh(unsigned int sampleIdx = 0) override;
+
+	virtual void detachFromScene() override;
+	virtual void attachToScene() override;
+
+	// returns true if instancer is fed by particle or nParticle node (and not by MASH)
+	static bool IsParticleInstancer(const MObject& instancer);
+
+private:
+	void ReadInstances(void);
+	void GeneratePrototypes(const MDagPathArray& paths);
+	void GenerateInstances(void);
+	void UpdateTransforms(void);
+	void ClearInstances(void);
+};
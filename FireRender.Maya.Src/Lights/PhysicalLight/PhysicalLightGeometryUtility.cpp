@@ -15,6 +15,10 @@ limitations under the License.
 #include "FireRenderUtils.h"
 
 #include <math.h>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 #include <maya/MItMeshPolygon.h>
 #include <maya/MPointArray.h>
 
@@ -142,22 +146,46 @@ bool PhysicalLightGeometryUtility::FillGizmoGeometryForAreaLight(PLAreaLightShap
 		return false;
 	}
 
-	switch (shapeType)
+	// area light gizmos are unit shapes scaled by the render item matrix, so buffers are generated once per shape type
+	struct GizmoBuffers
 	{
-	case PLADisc:
-		FillBuffersForDisc(vertices, indices);
-		break;
-	case PLARectangle:
-		FillBuffersForRectangle(vertices, indices);
-		break;
-	case PLACylinder:
-		FillBuffersForCylinder(vertices, indices);
-		break;
-	case PLASphere:
-		FillBufferWithSphere(vertices, indices);
-		break;
+		GizmoVertexVector vertices;
+		IndexVector indices;
+	};
+
+	static std::map<PLAreaLightShape, GizmoBuffers> gizmoCache;
+	static std::mutex gizmoCacheMutex;
+
+	std::lock_guard<std::mutex> lock(gizmoCacheMutex);
+
+	auto it = gizmoCache.find(shapeType);
+
+	if (it == gizmoCache.end())
+	{
+		GizmoBuffers buffers;
+
+		switch (shapeType)
+		{
+		case PLADisc:
+			FillBuffersForDisc(buffers.vertices, buffers.indices);
+			break;
+		case PLARectangle:
+			FillBuffersForRectangle(buffers.vertices, buffers.indices);
+			break;
+		case PLACylinder:
+			FillBuffersForCylinder(buffers.vertices, buffers.indices);
+			break;
+		case PLASphere:
+			FillBufferWithSphere(buffers.vertices, buffers.indices);
+			break;
+		}
+
+		it = gizmoCache.emplace(shapeType, std::move(buffers)).first;
 	}
 
+	vertices = it->second.vertices;
+	indices = it->second.indices;
+
 	return true;
 }
 
@@ -435,6 +463,31 @@ frw::Shape PhysicalLightGeometryUtility::CreateShapeForAreaLight(PLAreaLightShap
 		(int*) &numFaceVertices[0], numFaceVertices.size());
 }
 
+frw::Shape PhysicalLightGeometryUtility::CreateShapeInstanceForAreaLight(PLAreaLightShape shapeType, const FireMaya::Scope& scope)
+{
+	if (shapeType == PLAMesh)
+	{
+		return nullptr;
+	}
+
+	// prototype is not attached to the scene, lights only reference it through instances
+	frw::Shape prototype = scope.GetCachedAreaLightShape(shapeType);
+
+	if (!prototype)
+	{
+		prototype = CreateShapeForAreaLight(shapeType, scope.Context());
+
+		if (!prototype)
+		{
+			return nullptr;
+		}
+
+		scope.SetCachedAreaLightShape(shapeType, prototype);
+	}
+
+	return prototype.CreateInstance(scope.Context());
+}
+
 inline float GetAreaBy3Points(const MPoint& point1, const MPoint& point2, const MPoint& point3, const MMatrix& matrix)
 {
 	return (float) (((point2 - point1) * matrix) ^ ((point3 - point1) * matrix)).length() / 2.0f;
@@ -474,8 +527,135 @@ float PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(PLAreaLightShape shap
 	return 0.0f;
 }
 
+namespace
+{
+	// geometry and transform a cached area was computed for
+	struct MeshAreaKey
+	{
+		unsigned int vertexCount = 0;
+		unsigned int faceCount = 0;
+		unsigned int faceVertexCount = 0;
+
+		// second hash of the same data, computed with a different function than the cache key
+		size_t checkHash = 0;
+
+		double matrix[4][4];
+
+		bool operator==(const MeshAreaKey& other) const
+		{
+			return (vertexCount == other.vertexCount) &&
+				(faceCount == other.faceCount) &&
+				(faceVertexCount == other.faceVertexCount) &&
+				(checkHash == other.checkHash) &&
+				(memcmp(matrix, other.matrix, sizeof(matrix)) == 0);
+		}
+	};
+
+	struct CachedMeshArea
+	{
+		MeshAreaKey key;
+		float area;
+	};
+
+	// FNV-1a for the cache key, multiply-xorshift for the check hash; both consume 32 bit words
+	const size_t KeyHashPrime = 1099511628211ull;
+	const size_t CheckHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+	struct MeshAreaHasher
+	{
+		size_t keyHash = 14695981039346656037ull;
+		size_t checkHash = 0;
+
+		void Add(unsigned int word)
+		{
+			keyHash = (keyHash ^ word) * KeyHashPrime;
+
+			checkHash = (checkHash + word + 1) * CheckHashMultiplier;
+			checkHash ^= checkHash >> 29;
+		}
+
+		template <typename T>
+		void AddValues(const T* values, size_t count)
+		{
+			static_assert(sizeof(T) == sizeof(unsigned int), "values are hashed as 32 bit words");
+
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				unsigned int word;
+				memcpy(&word, &values[idx], sizeof(word));
+				Add(word);
+			}
+		}
+
+		void AddValues(const MIntArray& values)
+		{
+			for (unsigned int idx = 0; idx < values.length(); ++idx)
+			{
+				Add((unsigned int) values[idx]);
+			}
+		}
+	};
+
+	// returns the cache key hash; key receives the data verified on a cache hit
+	size_t ReadMeshAreaKey(const MFnMesh& mesh, const MMatrix& transformMatrix, MeshAreaKey& key)
+	{
+		MFnMesh meshFn(mesh.object());
+
+		MIntArray vertexCounts;
+		MIntArray vertexList;
+		meshFn.getVertices(vertexCounts, vertexList);
+
+		key.vertexCount = meshFn.numVertices();
+		key.faceCount = vertexCounts.length();
+		key.faceVertexCount = vertexList.length();
+		transformMatrix.get(key.matrix);
+
+		MeshAreaHasher hasher;
+		hasher.Add(key.vertexCount);
+		hasher.Add(key.faceCount);
+		hasher.Add(key.faceVertexCount);
+
+		const float* points = meshFn.getRawPoints(nullptr);
+		if (points != nullptr)
+		{
+			hasher.AddValues(points, 3 * (size_t) key.vertexCount);
+		}
+
+		hasher.AddValues(vertexCounts);
+		hasher.AddValues(vertexList);
+
+		key.checkHash = hasher.checkHash;
+
+		// the matrix is compared on a hit, it only has to spread entries of instanced meshes
+		hasher.AddValues(reinterpret_cast<const float*>(&key.matrix[0][0]), sizeof(key.matrix) / sizeof(float));
+
+		return hasher.keyHash;
+	}
+}
+
 float PhysicalLightGeometryUtility::GetAreaOfMesh(const MFnMesh& mesh, const MMatrix & transformMatrix)
 {
+	// iterating triangles through MItMeshPolygon is much more expensive than reading the raw arrays,
+	// so results are cached by geometry and transform
+	const size_t maxCachedAreas = 4096;
+
+	static std::unordered_map<size_t, CachedMeshArea> areaCache;
+	static std::mutex areaCacheMutex;
+
+	MeshAreaKey key;
+	size_t hash = ReadMeshAreaKey(mesh, transformMatrix, key);
+
+	{
+		std::lock_guard<std::mutex> lock(areaCacheMutex);
+
+		// hashes can collide, entry is used only if the geometry matches
+		auto it = areaCache.find(hash);
+		if ((it != areaCache.end()) && (it->second.key == key))
+		{
+			return it->second.area;
+		}
+	}
+
 	MPointArray points;
 	MIntArray indices;
 	float area = 0.0f;
@@ -490,5 +670,14 @@ float PhysicalLightGeometryUtility::GetAreaOfMesh(const MFnMesh& mesh, const MMa
 		}
 	}
 
+	std::lock_guard<std::mutex> lock(areaCacheMutex);
+
+	if (areaCache.size() >= maxCachedAreas)
+	{
+		areaCache.clear();
+	}
+
+	areaCache[hash] = CachedMeshArea { key, area };
+
 	return area;
 }
@@ -50,6 +50,9 @@ public:
 
 	// Mesh for RPR engine
 	static frw::Shape CreateShapeForAreaLight(PLAreaLightShape shapeType, frw::Context frcontext);
+
+	// Instance of the unit shape mesh shared by all area lights of the same shape in the scope's context
+	static frw::Shape CreateShapeInstanceForAreaLight(PLAreaLightShape shapeType, const FireMaya::Scope& scope);
 };
 
 struct PLUtilityVertex
@@ -0,0 +1,94 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "LockProfilerCmd.h"
+#include "ProfiledMutex.h"
+#include <maya/MGlobal.h>
+#include <maya/MString.h>
+
+namespace
+{
+	// stress test parameters: each worker holds the lock for 1ms 100 times,
+	// so with N threads the expected total wait is about N * (N - 1) / 2 * 100ms
+	const unsigned int StressTestIterations = 100;
+	const unsigned int StressTestHoldUs = 1000;
+}
+
+LockProfilerCmd::LockProfilerCmd()
+{}
+
+LockProfilerCmd::~LockProfilerCmd()
+{}
+
+void * LockProfilerCmd::creator()
+{
+	return new LockProfilerCmd;
+}
+
+MSyntax LockProfilerCmd::newSyntax()
+{
+	MStatus status;
+	MSyntax syntax;
+
+	CHECK_MSTATUS(syntax.addFlag(kLockProfilerEnableFlag, kLockProfilerEnableFlagLong, MSyntax::kBoolean));
+	CHECK_MSTATUS(syntax.addFlag(kLockProfilerResetFlag, kLockProfilerResetFlagLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kLockProfilerReportFlag, kLockProfilerReportFlagLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kLockProfilerStressTestFlag, kLockProfilerStressTestFlagLong, MSyntax::kUnsigned));
+
+	return syntax;
+}
+
+MStatus LockProfilerCmd::doIt(const MArgList & args)
+{
+	MStatus status;
+	MArgDatabase argData(syntax(), args, &status);
+	if (status != MS::kSuccess)
+		return status;
+
+	if (argData.isFlagSet(kLockProfilerEnableFlag))
+	{
+		bool enable = false;
+		argData.getFlagArgument(kLockProfilerEnableFlag, 0, enable);
+		RPR::LockProfiler::SetEnabled(enable);
+	}
+
+	if (argData.isFlagSet(kLockProfilerResetFlag))
+	{
+		RPR::LockProfiler::Reset();
+	}
+
+	if (argData.isFlagSet(kLockProfilerStressTestFlag))
+	{
+		unsigned int threadCount = 0;
+		argData.getFlagArgument(kLockProfilerStressTestFlag, 0, threadCount);
+		if (threadCount < 2)
+		{
+			MGlobal::displayError("Stress test needs at least 2 threads");
+			return MS::kFailure;
+		}
+
+		// stress test should be visible in report even if profiling was not enabled
+		bool wasEnabled = RPR::LockProfiler::IsEnabled();
+		RPR::LockProfiler::SetEnabled(true);
+		RPR::LockProfiler::RunStressTest(threadCount, StressTestIterations, StressTestHoldUs);
+		RPR::LockProfiler::SetEnabled(wasEnabled);
+	}
+
+	if (argData.isFlagSet(kLockProfilerReportFlag) || argData.isFlagSet(kLockProfilerStressTestFlag))
+	{
+		MString report = RPR::LockProfiler::Report().c_str();
+		MGlobal::displayInfo(report);
+		setResult(report);
+	}
+
+	return MS::kSuccess;
+}
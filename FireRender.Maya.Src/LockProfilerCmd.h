@@ -0,0 +1,43 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <maya/MPxCommand.h>
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+
+#define kLockProfilerEnableFlag "-e"
+#define kLockProfilerEnableFlagLong "-enable"
+#define kLockProfilerResetFlag "-r"
+#define kLockProfilerResetFlagLong "-reset"
+#define kLockProfilerReportFlag "-rp"
+#define kLockProfilerReportFlagLong "-report"
+#define kLockProfilerStressTestFlag "-st"
+#define kLockProfilerStressTestFlagLong "-stressTest"
+
+/**
+ * fireRenderLockProfiler -enable true;		// start collecting
+ * fireRenderLockProfiler -report;			// print and return collected table
+ * fireRenderLockProfiler -reset;			// drop collected data
+ * fireRenderLockProfiler -stressTest 8;	// 8 threads fight for one lock, results appear in the report
+ */
+class LockProfilerCmd : public MPxCommand
+{
+public:
+	LockProfilerCmd();
+
+	virtual ~LockProfilerCmd();
+	MStatus doIt(const MArgList& args);
+	static void* creator();
+	static MSyntax newSyntax();
+};
@@ -47,8 +47,8 @@ frw::Value GetSamplerNodeForValue(
 		}
 	}
 
-	// create buffer
-	frw::DataBuffer dataBuffer(params.scope.Context(), bufferDesc, arrData.data());
+	// identical ramps share one buffer
+	frw::DataBuffer dataBuffer = params.scope.Context().GetSharedDataBuffer(bufferDesc, arrData.data());
 
 	frw::Value normalizedValue = (valueInput - inputMin) / (inputMax - inputMin);
 
@@ -0,0 +1,110 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "MeshAttributeSnapshot.h"
+
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnDagNode.h>
+#include <maya/MPlug.h>
+
+std::map<MeshAttributeDescriptor::TypeKey, std::unique_ptr<MeshAttributeDescriptor>> MeshAttributeDescriptor::m_descriptors;
+std::mutex MeshAttributeDescriptor::m_descriptorsMutex;
+
+namespace
+{
+	MObject GetNodeAttribute(const MFnDependencyNode& node, const char* name)
+	{
+		if (node.object().isNull())
+			return MObject::kNullObj;
+
+		return node.attribute(name);
+	}
+
+	template <typename T>
+	T ReadPlugValue(const MObject& node, const MObject& attribute, T defaultValue)
+	{
+		if (node.isNull() || attribute.isNull())
+			return defaultValue;
+
+		MPlug plug(node, attribute);
+
+		T value = defaultValue;
+		plug.getValue(value);
+
+		return value;
+	}
+}
+
+MeshAttributeDescriptor::MeshAttributeDescriptor(const MObject& shapeNode, const MObject& transformNode)
+{
+	MFnDependencyNode shape(shapeNode);
+
+	m_visibleInReflections = GetNodeAttribute(shape, "visibleInReflections");
+	m_visibleInRefractions = GetNodeAttribute(shape, "visibleInRefractions");
+	m_castsShadows = GetNodeAttribute(shape, "castsShadows");
+	m_receiveShadows = GetNodeAttribute(shape, "receiveShadows");
+	m_primaryVisibility = GetNodeAttribute(shape, "primaryVisibility");
+	m_motionBlur = GetNodeAttribute(shape, "motionBlur");
+	m_shadowColor = GetNodeAttribute(shape, "RPRShadowColor");
+
+	MFnDependencyNode transform(transformNode);
+
+	m_contourVisibility = GetNodeAttribute(transform, "RPRContourVisibility");
+	m_objectId = GetNodeAttribute(transform, "RPRObjectId");
+}
+
+const MeshAttributeDescriptor& MeshAttributeDescriptor::Get(const MObject& shapeNode, const MObject& transformNode)
+{
+	// attributes used here are either static or extension attributes, so they are the same for all nodes of the type
+	TypeKey key(
+		shapeNode.isNull() ? 0 : MFnDependencyNode(shapeNode).typeId().id(),
+		transformNode.isNull() ? 0 : MFnDependencyNode(transformNode).typeId().id());
+
+	std::lock_guard<std::mutex> lock(m_descriptorsMutex);
+
+	std::unique_ptr<MeshAttributeDescriptor>& descriptor = m_descriptors[key];
+
+	if (!descriptor)
+	{
+		descriptor.reset(new MeshAttributeDescriptor(shapeNode, transformNode));
+	}
+
+	return *descriptor;
+}
+
+const MeshAttributeDescriptor& MeshAttributeDescriptor::Get(const MDagPath& shapePath)
+{
+	return Get(shapePath.node(), shapePath.transform());
+}
+
+void MeshAttributeDescriptor::Read(const MObject& shapeNode, const MObject& transformNode, MeshAttributeSnapshot& outSnapshot) const
+{
+	outSnapshot.visibleInReflections = ReadPlugValue(shapeNode, m_visibleInReflections, true);
+	outSnapshot.visibleInRefractions = ReadPlugValue(shapeNode, m_visibleInRefractions, true);
+	outSnapshot.castsShadows = ReadPlugValue(shapeNode, m_castsShadows, true);
+	outSnapshot.receiveShadows = ReadPlugValue(shapeNode, m_receiveShadows, true);
+	outSnapshot.primaryVisibility = ReadPlugValue(shapeNode, m_primaryVisibility, true);
+	outSnapshot.motionBlur = ReadPlugValue(shapeNode, m_motionBlur, true);
+
+	outSnapshot.contourVisibility = ReadPlugValue(transformNode, m_contourVisibility, false);
+	outSnapshot.objectId = ReadPlugValue(transformNode, m_objectId, 0);
+}
+
+void MeshAttributeDescriptor::Read(const MDagPath& shapePath, MeshAttributeSnapshot& outSnapshot) const
+{
+	Read(shapePath.node(), shapePath.transform(), outSnapshot);
+}
+
+bool MeshAttributeDescriptor::ReadMotionBlur(const MObject& shapeNode) const
+{
+	return ReadPlugValue(shapeNode, m_motionBlur, true);
+}
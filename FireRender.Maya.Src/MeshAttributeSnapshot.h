@@ -0,0 +1,91 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <maya/MObject.h>
+#include <maya/MTypeId.h>
+#include <maya/MDagPath.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+/** Render relevant attributes of the shape and its parent transform, read in a single pass */
+struct MeshAttributeSnapshot
+{
+	// shape render stats
+	bool visibleInReflections = true;
+	bool visibleInRefractions = true;
+	bool castsShadows = true;
+	bool receiveShadows = true;
+	bool primaryVisibility = true;
+	bool motionBlur = true;
+
+	// parent transform
+	bool contourVisibility = false;
+	int objectId = 0;
+
+	bool operator==(const MeshAttributeSnapshot& other) const
+	{
+		return visibleInReflections == other.visibleInReflections &&
+			visibleInRefractions == other.visibleInRefractions &&
+			castsShadows == other.castsShadows &&
+			receiveShadows == other.receiveShadows &&
+			primaryVisibility == other.primaryVisibility &&
+			motionBlur == other.motionBlur &&
+			contourVisibility == other.contourVisibility &&
+			objectId == other.objectId;
+	}
+
+	bool operator!=(const MeshAttributeSnapshot& other) const { return !(*this == other); }
+};
+
+/** Attribute handles of the shape and transform node types.
+	Resolved once per node type, so objects don't have to find plugs by name on each Freshen */
+class MeshAttributeDescriptor
+{
+public:
+	// returns descriptor for the types of the shape node and its parent transform
+	static const MeshAttributeDescriptor& Get(const MObject& shapeNode, const MObject& transformNode);
+	static const MeshAttributeDescriptor& Get(const MDagPath& shapePath);
+
+	void Read(const MObject& shapeNode, const MObject& transformNode, MeshAttributeSnapshot& outSnapshot) const;
+	void Read(const MDagPath& shapePath, MeshAttributeSnapshot& outSnapshot) const;
+
+	bool ReadMotionBlur(const MObject& shapeNode) const;
+
+	// RPRShadowColor can be connected to a texture so it is not a part of the snapshot
+	MObject ShadowColorAttribute() const { return m_shadowColor; }
+
+private:
+	MeshAttributeDescriptor(const MObject& shapeNode, const MObject& transformNode);
+
+private:
+	// shape attributes
+	MObject m_visibleInReflections;
+	MObject m_visibleInRefractions;
+	MObject m_castsShadows;
+	MObject m_receiveShadows;
+	MObject m_primaryVisibility;
+	MObject m_motionBlur;
+	MObject m_shadowColor;
+
+	// transform attributes
+	MObject m_contourVisibility;
+	MObject m_objectId;
+
+	typedef std::pair<unsigned int, unsigned int> TypeKey;
+
+	static std::map<TypeKey, std::unique_ptr<MeshAttributeDescriptor>> m_descriptors;
+	static std::mutex m_descriptorsMutex;
+};
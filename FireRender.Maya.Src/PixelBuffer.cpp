@@ -0,0 +1,78 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "PixelBuffer.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifdef _DEBUG
+#ifdef DUMP_PIXELS_PIXELBUFF
+#include "FireRenderAOV.h"
+#endif
+#endif
+
+void PixelBuffer::resize(size_t newCount)
+{
+	size_t newSize = PixelSize * newCount;
+	if (newSize != m_size)
+	{
+		void * newBuffer = nullptr;
+#ifdef WIN32
+		newBuffer = _aligned_realloc(m_pBuffer, newSize, 128);
+#else
+		newBuffer = malloc(newSize);
+		if(m_pBuffer)
+		{
+			free(m_pBuffer);
+			m_pBuffer = nullptr;
+		}
+#endif
+
+		m_pBuffer = static_cast<RV_PIXEL*>(newBuffer);
+		m_size = newSize;
+	}
+}
+
+void PixelBuffer::overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id /*= 0*/)
+{
+	// ensure valid input
+	assert(input != nullptr);
+
+	if (region.top > totalHeight)
+		return;
+
+	if (region.right > totalWidth)
+		return;
+
+	// Get region dimensions.
+	unsigned int regionWidth = region.getWidth();
+	unsigned int regionHeight = region.getHeight();
+
+	// copy line by line
+	for (unsigned int y = 0; y < regionHeight; y++)
+	{
+		unsigned int inputIndex = y * regionWidth;
+
+		unsigned int destShiftY = y + totalHeight - region.top - 1;
+		unsigned int destIndex = region.left + (destShiftY) * totalWidth;
+
+		memcpy(reinterpret_cast<char*>(m_pBuffer) + destIndex * PixelSize,
+			reinterpret_cast<const char*>(input) + inputIndex * PixelSize, PixelSize * regionWidth);
+	}
+
+#ifdef _DEBUG
+#ifdef DUMP_PIXELS_PIXELBUFF
+	debugDump(totalHeight, totalWidth, std::string(FireRenderAOV::GetAOVName(aov_id) + "_tile_"), "C://temp//buffers//");
+#endif
+#endif
+}
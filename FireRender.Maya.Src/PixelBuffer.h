@@ -0,0 +1,113 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#ifdef WIN32
+#include <malloc.h>
+#endif
+
+#include "RenderRegion.h"
+
+struct RV_PIXEL;
+
+/** Automated handler for RV_PIXEL data.
+	Uses aligned memory manager and prevents unnecessary re-allocations */
+class PixelBuffer
+{
+	RV_PIXEL * m_pBuffer;
+	size_t m_size;
+	size_t m_width;
+	size_t m_height;
+
+public:
+	// RV_PIXEL is four floats; buffers are sized and copied with this so Maya's definition isn't needed here
+	static const size_t PixelSize = 4 * sizeof(float);
+
+	PixelBuffer() 
+		:	m_pBuffer(nullptr)
+		,	m_size(0)
+		,	m_width(0)
+		,	m_height(0)
+	{
+	}
+	virtual ~PixelBuffer()
+	{
+		reset();
+	}
+
+public:
+	operator bool() const
+	{
+		return m_pBuffer != nullptr;
+	}
+
+	RV_PIXEL * const get() const
+	{
+		return m_pBuffer;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	size_t width() const
+	{
+		return m_width;
+	}
+
+	size_t height() const
+	{
+		return m_height;
+	}
+
+	float* data()
+	{
+		return (float*)m_pBuffer;
+	}
+
+	void resize(size_t newCount);
+
+	void resize(size_t width, size_t height)
+	{
+		m_width = width;
+		m_height = height;
+
+		resize(width*height);
+	}
+
+	void reset()
+	{
+		if (m_pBuffer)
+		{
+#ifdef WIN32
+			_aligned_free(m_pBuffer);
+#else
+			free(m_pBuffer);
+#endif
+		}
+		m_pBuffer = nullptr;
+		m_size = 0;
+	}
+
+	void overwrite(const RV_PIXEL* input, const RenderRegion& region, unsigned int totalHeight, unsigned int totalWidth, int aov_id = 0);
+
+	void debugDump(unsigned int height, unsigned int width, const std::string& fbName, const std::string& pathToFile);
+};
+
+typedef std::map<unsigned int, PixelBuffer> AOVPixelBuffers;
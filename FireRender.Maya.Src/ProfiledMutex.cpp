@@ -0,0 +1,334 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "ProfiledMutex.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+using namespace RPR;
+
+namespace
+{
+	struct LockSiteStats
+	{
+		uint64_t count = 0;
+		uint64_t contended = 0;
+		uint64_t waitNs = 0;
+		uint64_t maxWaitNs = 0;
+		uint64_t holdNs = 0;
+		uint64_t maxHoldNs = 0;
+	};
+
+	enum LockSiteSlotState
+	{
+		SlotEmpty = 0,
+		SlotClaimed,
+		SlotReady
+	};
+
+	// one (lock name, site) pair keyed by the string pointers; counters are updated with relaxed atomics
+	struct LockSiteSlot
+	{
+		std::atomic<int> state { SlotEmpty };
+		const char* lockName = nullptr;
+		const char* site = nullptr;
+
+		std::atomic<uint64_t> count { 0 };
+		std::atomic<uint64_t> contended { 0 };
+		std::atomic<uint64_t> waitNs { 0 };
+		std::atomic<uint64_t> maxWaitNs { 0 };
+		std::atomic<uint64_t> holdNs { 0 };
+		std::atomic<uint64_t> maxHoldNs { 0 };
+	};
+
+	// power of two, far more than the number of lock sites in the plugin
+	const size_t LockSiteSlotCount = 256;
+
+	// open addressing table, slots are claimed once and never freed so Record doesn't take a lock
+	LockSiteSlot* LockSiteSlots()
+	{
+		static LockSiteSlot slots[LockSiteSlotCount];
+		return slots;
+	}
+
+	// records which didn't fit in the table
+	std::atomic<uint64_t> droppedRecords(0);
+
+	LockSiteSlot* FindLockSiteSlot(const char* lockName, const char* site)
+	{
+		size_t hash = (reinterpret_cast<uintptr_t>(lockName) * 31 + reinterpret_cast<uintptr_t>(site)) * 2654435761u;
+		hash ^= hash >> 16;
+
+		for (size_t probe = 0; probe < LockSiteSlotCount; ++probe)
+		{
+			LockSiteSlot& slot = LockSiteSlots()[(hash + probe) & (LockSiteSlotCount - 1)];
+
+			int state = slot.state.load(std::memory_order_acquire);
+			if (state == SlotEmpty)
+			{
+				if (slot.state.compare_exchange_strong(state, SlotClaimed, std::memory_order_acq_rel))
+				{
+					slot.lockName = lockName;
+					slot.site = site;
+					slot.state.store(SlotReady, std::memory_order_release);
+
+					return &slot;
+				}
+			}
+
+			// another thread is writing the key of this slot
+			while (state == SlotClaimed)
+			{
+				std::this_thread::yield();
+				state = slot.state.load(std::memory_order_acquire);
+			}
+
+			if (slot.lockName == lockName && slot.site == site)
+				return &slot;
+		}
+
+		return nullptr;
+	}
+
+	void UpdateMax(std::atomic<uint64_t>& max, uint64_t value)
+	{
+		uint64_t current = max.load(std::memory_order_relaxed);
+		while (current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	bool IsEnabledByEnvironment()
+	{
+		const char* value = std::getenv("RPR_MAYA_PROFILE_LOCKS");
+		return value && (std::strcmp(value, "1") == 0);
+	}
+
+	uint64_t ElapsedNs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+	{
+		return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	}
+
+	double ToMs(uint64_t ns)
+	{
+		return ns / 1000000.0;
+	}
+}
+
+std::atomic_bool LockProfiler::m_enabled(IsEnabledByEnvironment());
+
+void LockProfiler::SetEnabled(bool enabled)
+{
+	m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LockProfiler::Record(const char* lockName, const char* site, uint64_t waitNs, uint64_t holdNs, bool contended)
+{
+	LockSiteSlot* slot = FindLockSiteSlot(lockName, site);
+	if (slot == nullptr)
+	{
+		droppedRecords.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	slot->count.fetch_add(1, std::memory_order_relaxed);
+	if (contended)
+	{
+		slot->contended.fetch_add(1, std::memory_order_relaxed);
+	}
+	slot->waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+	UpdateMax(slot->maxWaitNs, waitNs);
+	slot->holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+	UpdateMax(slot->maxHoldNs, holdNs);
+}
+
+void LockProfiler::Reset()
+{
+	// keys stay, only the counters are cleared
+	for (size_t idx = 0; idx < LockSiteSlotCount; ++idx)
+	{
+		LockSiteSlot& slot = LockSiteSlots()[idx];
+
+		slot.count.store(0, std::memory_order_relaxed);
+		slot.contended.store(0, std::memory_order_relaxed);
+		slot.waitNs.store(0, std::memory_order_relaxed);
+		slot.maxWaitNs.store(0, std::memory_order_relaxed);
+		slot.holdNs.store(0, std::memory_order_relaxed);
+		slot.maxHoldNs.store(0, std::memory_order_relaxed);
+	}
+
+	droppedRecords.store(0, std::memory_order_relaxed);
+}
+
+std::string LockProfiler::Report()
+{
+	// the same name or site text can be a different literal in another translation unit, merge those by text
+	std::map<std::pair<std::string, std::string>, LockSiteStats> merged;
+
+	for (size_t idx = 0; idx < LockSiteSlotCount; ++idx)
+	{
+		LockSiteSlot& slot = LockSiteSlots()[idx];
+
+		if (slot.state.load(std::memory_order_acquire) != SlotReady)
+			continue;
+
+		uint64_t count = slot.count.load(std::memory_order_relaxed);
+		if (count == 0)
+			continue;
+
+		LockSiteStats& stats = merged[std::make_pair(std::string(slot.lockName), std::string(slot.site ? slot.site : "(unspecified)"))];
+		stats.count += count;
+		stats.contended += slot.contended.load(std::memory_order_relaxed);
+		stats.waitNs += slot.waitNs.load(std::memory_order_relaxed);
+		stats.maxWaitNs = std::max(stats.maxWaitNs, slot.maxWaitNs.load(std::memory_order_relaxed));
+		stats.holdNs += slot.holdNs.load(std::memory_order_relaxed);
+		stats.maxHoldNs = std::max(stats.maxHoldNs, slot.maxHoldNs.load(std::memory_order_relaxed));
+	}
+
+	std::vector<std::pair<std::pair<std::string, std::string>, LockSiteStats>> rows(merged.begin(), merged.end());
+
+	std::sort(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs)
+	{
+		return lhs.second.waitNs > rhs.second.waitNs;
+	});
+
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3);
+	out << "Lock profiler (" << (IsEnabled() ? "enabled" : "disabled") << ")\n";
+	out << "lock | site | count | contended | wait ms (total/max) | hold ms (total/max)\n";
+
+	for (const auto& row : rows)
+	{
+		const LockSiteStats& stats = row.second;
+
+		out << row.first.first << " | " << row.first.second
+			<< " | " << stats.count
+			<< " | " << stats.contended
+			<< " | " << ToMs(stats.waitNs) << "/" << ToMs(stats.maxWaitNs)
+			<< " | " << ToMs(stats.holdNs) << "/" << ToMs(stats.maxHoldNs)
+			<< "\n";
+	}
+
+	uint64_t dropped = droppedRecords.load(std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		out << dropped << " records dropped, lock site table is full\n";
+	}
+
+	return out.str();
+}
+
+void LockProfiler::RunStressTest(unsigned int threadCount, unsigned int iterations, unsigned int holdUs)
+{
+	ProfiledMutex stressLock("LockProfiler::StressTest");
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+
+	for (unsigned int threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+	{
+		threads.emplace_back([&stressLock, iterations, holdUs]()
+		{
+			for (unsigned int idx = 0; idx < iterations; ++idx)
+			{
+				AutoProfiledLock lock(stressLock, "RunStressTest worker");
+				std::this_thread::sleep_for(std::chrono::microseconds(holdUs));
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+ProfiledMutex::ProfiledMutex(const char* name) :
+	m_name(name),
+	m_waitNs(0),
+	m_site(nullptr),
+	m_contended(false),
+	m_profiled(false)
+{
+}
+
+void ProfiledMutex::lock(const char* site)
+{
+	if (!LockProfiler::IsEnabled())
+	{
+		m_mutex.lock();
+		m_profiled = false;
+		return;
+	}
+
+	if (m_mutex.try_lock())
+	{
+		OnAcquired(site, 0, false);
+		return;
+	}
+
+	auto waitStart = std::chrono::steady_clock::now();
+	m_mutex.lock();
+	OnAcquired(site, ElapsedNs(waitStart, std::chrono::steady_clock::now()), true);
+}
+
+bool ProfiledMutex::try_lock()
+{
+	if (!m_mutex.try_lock())
+		return false;
+
+	if (LockProfiler::IsEnabled())
+	{
+		OnAcquired(nullptr, 0, false);
+	}
+	else
+	{
+		m_profiled = false;
+	}
+
+	return true;
+}
+
+void ProfiledMutex::unlock()
+{
+	if (!m_profiled)
+	{
+		m_mutex.unlock();
+		return;
+	}
+
+	uint64_t holdNs = ElapsedNs(m_acquiredAt, std::chrono::steady_clock::now());
+	const char* site = m_site;
+	uint64_t waitNs = m_waitNs;
+	bool contended = m_contended;
+	m_profiled = false;
+
+	m_mutex.unlock();
+
+	LockProfiler::Record(m_name, site, waitNs, holdNs, contended);
+}
+
+void ProfiledMutex::OnAcquired(const char* site, uint64_t waitNs, bool contended)
+{
+	m_site = site;
+	m_waitNs = waitNs;
+	m_contended = contended;
+	m_profiled = true;
+	m_acquiredAt = std::chrono::steady_clock::now();
+}
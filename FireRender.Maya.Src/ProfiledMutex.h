@@ -0,0 +1,102 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace RPR
+{
+	/**
+	 * Collects wait and hold times of ProfiledMutex instances, grouped by lock name
+	 * and acquisition site. Profiling is off by default; it is switched on by the
+	 * fireRenderLockProfiler command or by setting RPR_MAYA_PROFILE_LOCKS=1.
+	 * When disabled the only cost of a lock is one relaxed atomic load.
+	 * Statistics are keyed by the lock name and site pointers and updated with
+	 * atomics, so both have to be string literals.
+	 */
+	class LockProfiler
+	{
+	public:
+		static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+		static void SetEnabled(bool enabled);
+
+		static void Record(const char* lockName, const char* site, uint64_t waitNs, uint64_t holdNs, bool contended);
+		static void Reset();
+
+		// human readable table sorted by total wait time
+		static std::string Report();
+
+		// runs threadCount threads that take the same lock iterations times while holding it for holdUs
+		static void RunStressTest(unsigned int threadCount, unsigned int iterations, unsigned int holdUs);
+
+	private:
+		static std::atomic_bool m_enabled;
+	};
+
+	/**
+	 * Drop-in replacement for std::mutex (lock / try_lock / unlock) that reports
+	 * to LockProfiler. Works with std::lock_guard and std::unique_lock; use
+	 * AutoProfiledLock or lock(site) to also record where the lock was taken.
+	 */
+	class ProfiledMutex
+	{
+		std::mutex m_mutex;
+		const char* m_name;
+
+		// valid only while locked by the profiled owner
+		std::chrono::steady_clock::time_point m_acquiredAt;
+		uint64_t m_waitNs;
+		const char* m_site;
+		bool m_contended;
+		bool m_profiled;
+
+		ProfiledMutex(const ProfiledMutex&) = delete;
+		ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+	public:
+		explicit ProfiledMutex(const char* name);
+
+		void lock() { lock(nullptr); }
+		void lock(const char* site);
+		bool try_lock();
+		void unlock();
+
+		const char* Name() const { return m_name; }
+
+	private:
+		void OnAcquired(const char* site, uint64_t waitNs, bool contended);
+	};
+
+	/** Scoped lock of ProfiledMutex with acquisition site, see AutoLock. */
+	class AutoProfiledLock
+	{
+		ProfiledMutex& m_lock;
+
+		AutoProfiledLock(const AutoProfiledLock&) = delete;
+	public:
+		AutoProfiledLock(ProfiledMutex& lock, const char* site) :
+			m_lock(lock)
+		{
+			m_lock.lock(site);
+		}
+
+		~AutoProfiledLock()
+		{
+			m_lock.unlock();
+		}
+	};
+}
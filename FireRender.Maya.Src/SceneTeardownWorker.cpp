@@ -0,0 +1,137 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "SceneTeardownWorker.h"
+#include "FireRenderThread.h"
+#include "FireRenderUtils.h"
+
+#if _WIN32
+#include <windows.h>
+#endif
+
+using namespace FireMaya;
+
+std::mutex SceneTeardownWorker::m_mutex;
+std::condition_variable SceneTeardownWorker::m_condition;
+std::deque<SceneTeardownWorker::Job> SceneTeardownWorker::m_jobs;
+std::unique_ptr<std::thread> SceneTeardownWorker::m_thread;
+bool SceneTeardownWorker::m_isRunningJob = false;
+bool SceneTeardownWorker::m_isStopped = false;
+std::atomic<size_t> SceneTeardownWorker::m_completedCount { 0 };
+std::atomic<long long> SceneTeardownWorker::m_totalTimeMs { 0 };
+
+void SceneTeardownWorker::Enqueue(const std::string& name, std::function<void()> job)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!m_isStopped)
+		{
+			if (!m_thread)
+				m_thread = std::make_unique<std::thread>(ThreadProc);
+
+			m_jobs.push_back({ name, std::move(job) });
+			m_condition.notify_one();
+
+			return;
+		}
+	}
+
+	// exiting: nobody would pick the job up
+	job();
+}
+
+size_t SceneTeardownWorker::GetPendingCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	return m_jobs.size() + (m_isRunningJob ? 1 : 0);
+}
+
+void SceneTeardownWorker::ThreadProc()
+{
+#if _WIN32
+	// teardown should not compete with Maya UI and active renders
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_isRunningJob = false;
+
+			m_condition.wait(lock, [] { return m_isStopped || !m_jobs.empty(); });
+
+			if (m_jobs.empty())
+				return;
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+			m_isRunningJob = true;
+		}
+
+		TimePoint startTime = GetCurrentChronoTime();
+
+		try
+		{
+			job.function();
+		}
+		catch (...)
+		{
+			LogPrint("SceneTeardownWorker: %s teardown failed", job.name.c_str());
+		}
+
+		// objects captured by the job are released here as well
+		job.function = nullptr;
+
+		long long elapsed = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), startTime);
+		m_totalTimeMs += elapsed;
+		m_completedCount++;
+
+		LogPrint("SceneTeardownWorker: %s released in %lld ms (%zu released in total)", job.name.c_str(), elapsed, m_completedCount.load());
+	}
+}
+
+void SceneTeardownWorker::WaitForPendingTeardown()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_isStopped = true;
+		m_condition.notify_all();
+	}
+
+	if (!m_thread)
+		return;
+
+	size_t pending = GetPendingCount();
+	if (pending > 0)
+	{
+		LogPrint("Waiting for %zu scene teardown job(s) to finish", pending);
+	}
+
+	// teardown may post work for main thread; keep serving it while waiting
+	while (GetPendingCount() > 0)
+	{
+		if (FireRenderThread::AreWeOnMainThread())
+		{
+			FireRenderThread::RunItemsQueuedForTheMainThread();
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	m_thread->join();
+	m_thread.reset();
+}
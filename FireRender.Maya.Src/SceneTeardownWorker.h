@@ -0,0 +1,61 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+	Single low priority thread releasing scenes and contexts that are no longer used.
+	Jobs own what they release (typically the last FireRenderContextPtr reference), so heavy
+	rpr object destruction happens off the main thread. Jobs still go through FireRenderThread
+	where the RPR API requires it.
+	WaitForPendingTeardown() should be called before the RPR thread is stopped on exit / unload.
+*/
+class SceneTeardownWorker
+{
+	struct Job
+	{
+		std::string name;
+		std::function<void()> function;
+	};
+
+	static std::mutex m_mutex;
+	static std::condition_variable m_condition;
+	static std::deque<Job> m_jobs;
+	static std::unique_ptr<std::thread> m_thread;
+	static bool m_isRunningJob;
+	static bool m_isStopped;
+
+	static std::atomic<size_t> m_completedCount;
+	static std::atomic<long long> m_totalTimeMs;
+
+	static void ThreadProc();
+
+public:
+	// job is executed on teardown thread; if the worker was already stopped it is executed in place
+	static void Enqueue(const std::string& name, std::function<void()> job);
+
+	static size_t GetPendingCount();
+	static size_t GetCompletedCount() { return m_completedCount; }
+	static long long GetTotalTimeMs() { return m_totalTimeMs; }
+
+	// finishes queued teardown and stops the thread; called on Maya exit and plugin unload
+	static void WaitForPendingTeardown();
+};
@@ -11,31 +11,127 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ********************************************************************/
 #include "StartupContextChecker.h"
+#include "common.h"
+#include "FireRenderUtils.h"
+#include "Logger.h"
+
+#include <fstream>
+#include <sstream>
+#include <functional>
 
 bool StartupContextChecker::m_IsMachineLearningDenoiserSupportedOnCPU = false;
 bool StartupContextChecker::m_IsRprSupported = false;
 bool StartupContextChecker::m_WasCheckedBeforeUsage = false;
+std::future<bool> StartupContextChecker::m_MLDenoiserCheck;
+std::unique_ptr<NorthStarContext> StartupContextChecker::m_ProbeContext;
+std::string StartupContextChecker::m_CacheKey;
+std::string StartupContextChecker::m_MLDenoiserError;
+
+MString StartupContextChecker::GetCacheFilePath()
+{
+	MString prefDir = MGlobal::executeCommandStringResult("internalVar -userPrefDir");
+
+	return prefDir + "rprStartupCheck.txt";
+}
+
+bool StartupContextChecker::ReadCache()
+{
+	std::ifstream file(GetCacheFilePath().asUTF8());
+
+	if (!file)
+	{
+		return false;
+	}
+
+	std::string key;
+	int rprSupported = 0;
+	int mlDenoiserSupportedCPU = 0;
+
+	std::getline(file, key);
+	file >> rprSupported >> mlDenoiserSupportedCPU;
+
+	if (file.fail() || key != m_CacheKey || rprSupported == 0)
+	{
+		return false;
+	}
+
+	m_IsRprSupported = true;
+	m_IsMachineLearningDenoiserSupportedOnCPU = mlDenoiserSupportedCPU != 0;
+
+	return true;
+}
+
+void StartupContextChecker::WriteCache()
+{
+	// failures are not cached, so the check is repeated after drivers are fixed
+	if (!m_IsRprSupported)
+	{
+		return;
+	}
+
+	std::ofstream file(GetCacheFilePath().asUTF8(), std::ios::trunc);
+
+	if (!file)
+	{
+		return;
+	}
+
+	file << m_CacheKey << std::endl;
+	file << (m_IsRprSupported ? 1 : 0) << " " << (m_IsMachineLearningDenoiserSupportedOnCPU ? 1 : 0) << std::endl;
+}
+
+bool StartupContextChecker::CheckMLDenoiserSupportedCPU(rpr_context context, std::string mlModelsFolder, std::string& outError)
+{
+	try
+	{
+		auto rifContext = std::make_unique<RifContextCPU>(context);
+		auto filter = std::make_unique<RifFilterMlColorOnly>(rifContext.get(), 512, 512, mlModelsFolder, true);
+	}
+	catch (const std::runtime_error & e)
+	{
+		outError = e.what();
+		return false;
+	}
+
+	return true;
+}
 
 void StartupContextChecker::CheckContexts()
 {
 	m_WasCheckedBeforeUsage = true;
 
+	TimePoint start = GetCurrentChronoTime();
+
+	auto createFlags = FireMaya::Options::GetContextDeviceFlags();
+
+	std::ostringstream key;
+	key << PLUGIN_VERSION << "|" << createFlags << "|" << std::hash<std::string>()(HardwareResources::GetHardwareSignature());
+	m_CacheKey = key.str();
+
+	if (ReadCache())
+	{
+		LogPrint("RPR startup check: %d ms (cached)", (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), start));
+		return;
+	}
+
 	//Check rpr context
 	rpr_int res;
-	NorthStarContext rprContext;
+	m_ProbeContext = std::make_unique<NorthStarContext>();
 	try
 	{
-		auto createFlags = FireMaya::Options::GetContextDeviceFlags();
-		rprContext.createContextEtc(createFlags, true, &res);
+		m_ProbeContext->createContextEtc(createFlags, true, &res);
 	}
 	catch (const FireRenderException & e)
 	{
+		m_ProbeContext.reset();
 		FireRenderError(e.code, e.message, true);
 		return;
 	}
 
 	if (res != RPR_SUCCESS)
 	{
+		m_ProbeContext.reset();
+
 		MString msg;
 		if (res == RPR_ERROR_INVALID_API_VERSION)
 		{
@@ -48,23 +144,44 @@ void StartupContextChecker::CheckContexts()
 
 	//Check rif context
 #ifdef WIN32
-	try
+	MString path;
+	MStatus status = MGlobal::executeCommand("getModulePath -moduleName RadeonProRender", path);
+	std::string mlModelsFolder = (path + "/data/models").asChar();
+	rpr_context context = m_ProbeContext->context();
+
+	// creating the ML filter takes seconds, so the plugin is usable before the check completes
+	m_MLDenoiserCheck = std::async(std::launch::async, [context, mlModelsFolder]()
 	{
-		auto rifContext = std::make_unique<RifContextCPU>(rprContext.context());
-		std::unique_ptr<RifFilterWrapper> mRifFilter;
-		MString path;
-		MStatus status = MGlobal::executeCommand("getModulePath -moduleName RadeonProRender", path);
-		MString mlModelsFolder = path + "/data/models";
-		auto filter = std::make_unique<RifFilterMlColorOnly>(rifContext.get(), 512, 512, mlModelsFolder.asChar(), true);
-	}
-	catch (const std::runtime_error & e)
+		// read on the main thread only after the future is resolved
+		return CheckMLDenoiserSupportedCPU(context, mlModelsFolder, m_MLDenoiserError);
+	});
+#else
+	m_ProbeContext.reset();
+	m_IsMachineLearningDenoiserSupportedOnCPU = true;
+	WriteCache();
+#endif
+
+	LogPrint("RPR startup check: %d ms (not cached)", (int) TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), start));
+}
+
+void StartupContextChecker::FinishMLDenoiserCheck()
+{
+	if (!m_MLDenoiserCheck.valid())
 	{
-		MGlobal::displayWarning(e.what());
 		return;
 	}
-#endif
 
-	m_IsMachineLearningDenoiserSupportedOnCPU = true;
+	m_IsMachineLearningDenoiserSupportedOnCPU = m_MLDenoiserCheck.get();
+
+	// context is released on the calling (main) thread, after the check no longer uses it
+	m_ProbeContext.reset();
+
+	if (!m_IsMachineLearningDenoiserSupportedOnCPU)
+	{
+		MGlobal::displayWarning(m_MLDenoiserError.c_str());
+	}
+
+	WriteCache();
 }
 
 bool StartupContextChecker::IsRprSupported()
@@ -76,5 +193,18 @@ bool StartupContextChecker::IsRprSupported()
 bool StartupContextChecker::IsMLDenoiserSupportedCPU()
 {
 	assert(m_WasCheckedBeforeUsage);
+
+	FinishMLDenoiserCheck();
+
 	return m_IsMachineLearningDenoiserSupportedOnCPU;
 }
+
+bool StartupContextChecker::IsMLDenoiserCheckComplete()
+{
+	return !m_MLDenoiserCheck.valid();
+}
+
+void StartupContextChecker::WaitForPendingChecks()
+{
+	FinishMLDenoiserCheck();
+}
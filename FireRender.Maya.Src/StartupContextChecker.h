@@ -14,18 +14,46 @@ limitations under the License.
 #include "Context/TahoeContext.h"
 #include <ImageFilter/ImageFilter.h>
 
+#include <future>
+#include <memory>
+#include <string>
+
 /** 
 	Used to check compatibility with RPR functions.
 	CheckContexts() should be called before accesing other methods.
 	Assuming that if any GPU has support for RPR context -> it has support for ML denoiser.
+
+	Results are cached on disk, keyed by plugin version, selected devices and hardware/driver signature,
+	so no context is created on startup when the cache is valid. On a cache miss the ML denoiser
+	check runs on a background thread and is waited for on the first IsMLDenoiserSupportedCPU() call.
 */
 class StartupContextChecker
 {
 	static bool m_IsRprSupported;
 	static bool m_IsMachineLearningDenoiserSupportedOnCPU;
 	static bool m_WasCheckedBeforeUsage;
+
+	// pending ML denoiser check and the context it uses
+	static std::future<bool> m_MLDenoiserCheck;
+	static std::unique_ptr<NorthStarContext> m_ProbeContext;
+	static std::string m_CacheKey;
+	static std::string m_MLDenoiserError;
+
+	static MString GetCacheFilePath();
+	static bool ReadCache();
+	static void WriteCache();
+
+	static bool CheckMLDenoiserSupportedCPU(rpr_context context, std::string mlModelsFolder, std::string& outError);
+	static void FinishMLDenoiserCheck();
+
 public:
 	static void CheckContexts();
 	static bool IsRprSupported();
 	static bool IsMLDenoiserSupportedCPU();
+
+	// ML denoiser support is known without waiting for the background check
+	static bool IsMLDenoiserCheckComplete();
+
+	// called on plugin unload
+	static void WaitForPendingChecks();
 };
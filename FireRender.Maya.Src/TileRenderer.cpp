@@ -23,115 +23,133 @@ TileRenderer::~TileRenderer()
 {
 }
 
+// camera state of the single context which is changed while rendering tiles
+struct TileCameraState
+{
+	FireRenderCamera* fireRenderCamera;
+	rpr_camera camera;
+
+	RadeonProRender::float2 sensorSize = 0.0f;
+	RadeonProRender::float2 orthoSize = 0.0f;
+
+	TileCameraState(FireRenderContext& renderContext) :
+		fireRenderCamera(&renderContext.camera()),
+		camera(renderContext.camera().data().Handle())
+	{
+		rprCameraGetInfo(camera, RPR_CAMERA_SENSOR_SIZE, sizeof(sensorSize), &sensorSize, nullptr);
+
+		rprCameraGetInfo(camera, RPR_CAMERA_ORTHO_WIDTH, sizeof(orthoSize.x), &orthoSize.x, nullptr);
+		rprCameraGetInfo(camera, RPR_CAMERA_ORTHO_HEIGHT, sizeof(orthoSize.y), &orthoSize.y, nullptr);
+	}
+
+	void SetupForTile(const TileRenderInfo& info, const RenderRegion& region)
+	{
+		float shiftX = (region.left + 0.5f * ((int)region.getWidth() - (int)info.totalWidth)) / region.getWidth();
+		float shiftY = (region.bottom + 0.5f * ((int)region.getHeight() - (int)info.totalHeight)) / region.getHeight();
+
+		rprCameraSetLensShift(camera, shiftX, shiftY);
+
+		if (fireRenderCamera->isDefaultPerspective())
+		{
+			rprCameraSetSensorSize(camera, sensorSize.x / ((float)info.totalWidth / region.getWidth()),
+				sensorSize.y / ((float)info.totalHeight / region.getHeight()));
+		}
+		else if (fireRenderCamera->isDefaultOrtho())
+		{
+			rprCameraSetOrthoWidth(camera, orthoSize.x / ((float)info.totalWidth / region.getWidth()));
+			rprCameraSetOrthoHeight(camera, orthoSize.y / ((float)info.totalHeight / region.getHeight()));
+		}
+		else
+		{
+			// not implemented;
+			assert(false);
+		}
+	}
+
+	void Restore()
+	{
+		// back previous values
+		// probably this may be ommited, since this is already end of the rendering
+		if (fireRenderCamera->isDefaultPerspective())
+		{
+			rprCameraSetSensorSize(camera, sensorSize.x, sensorSize.y);
+		}
+		else if (fireRenderCamera->isDefaultOrtho())
+		{
+			rprCameraSetOrthoWidth(camera, orthoSize.x);
+			rprCameraSetOrthoHeight(camera, orthoSize.y);
+		}
+	}
+};
+
 void TileRenderer::Render(FireRenderContext& renderContext, const TileRenderInfo& info, AOVPixelBuffers& outBuffer, TileRenderingCallback callbackFunc)
 {
-	float tilesXf = info.totalWidth / (float)info.tileSizeX;
-	float tilesYf = info.totalHeight / (float)info.tileSizeY;
+	Render(std::vector<FireRenderContext*> { &renderContext }, info, outBuffer, callbackFunc);
+}
 
-	int xTiles = (int) std::ceil(tilesXf);
-	int yTiles = (int) std::ceil(tilesYf);
+void TileRenderer::Render(const std::vector<FireRenderContext*>& renderContexts, const TileRenderInfo& info, AOVPixelBuffers& outBuffer, TileRenderingCallback callbackFunc)
+{
+	assert(!renderContexts.empty());
 
-	FireRenderCamera& fireRenderCamera = renderContext.camera();
-	rpr_camera camera = fireRenderCamera.data().Handle();
+	TileScheduler scheduler(info);
 
-	RadeonProRender::float2 sensorSize = 0.0f;
-	rprCameraGetInfo(camera, RPR_CAMERA_SENSOR_SIZE, sizeof(sensorSize), &sensorSize, nullptr);
+	int xTiles = scheduler.GetTilesX();
+	int yTiles = scheduler.GetTilesY();
 
-	RadeonProRender::float2 orthoSize = 0.0f;
-	rprCameraGetInfo(camera, RPR_CAMERA_ORTHO_WIDTH, sizeof(orthoSize.x), &orthoSize.x, nullptr);
-	rprCameraGetInfo(camera, RPR_CAMERA_ORTHO_HEIGHT, sizeof(orthoSize.y), &orthoSize.y, nullptr);
+	std::vector<TileCameraState> cameraStates;
+	cameraStates.reserve(renderContexts.size());
+
+	for (FireRenderContext* pContext : renderContexts)
+	{
+		cameraStates.emplace_back(*pContext);
+	}
+
+	// image plane is the same for all contexts, read it once on the calling thread
+	FireRenderCamera& fireRenderCamera = renderContexts.front()->camera();
 
 	MObject node = fireRenderCamera.Object();
 	MFnDagNode dagNode(node);
 	MPlug imagePlanePlug = dagNode.findPlug("imagePlane");
-	MString plugName = imagePlanePlug.name();
 	if (imagePlanePlug.isArray())
 	{
 		if (int n = imagePlanePlug.numElements())
 			imagePlanePlug = imagePlanePlug.elementByPhysicalIndex(0);
 	}
-	plugName = imagePlanePlug.name();
 
 	MObject imagePlane = FireMaya::GetConnectedNode(imagePlanePlug);
-	if (!imagePlane.isNull())
-	{
-		MFnDependencyNode imNode(imagePlane);
-		MString name2 = imNode.name();
-	}
 
 	MString name = fireRenderCamera.GetPlugValue(imagePlane, "imageName", MString());
 
 	FireMaya::FitType tileFitType = (FireMaya::FitType) fireRenderCamera.GetPlugValue(imagePlane, "fit", 1);
 
-	int counter = 0;
-	for (int yTile = yTiles - 1; yTile >= 0; yTile--)
+	scheduler.Run((unsigned int) renderContexts.size(), [&](unsigned int contextIndex, const TileDescription& tile)
 	{
-		for (int xTile = 0; xTile < xTiles; xTile++)
-		{
-			RenderRegion region;
-
-			region.left = xTile * info.tileSizeX;
-			region.right = std::min(info.totalWidth, region.left + info.tileSizeX) - 1;
-
-			region.bottom = yTile * info.tileSizeY;
-			region.top = std::min(info.totalHeight, region.bottom + info.tileSizeY) - 1;
-
-			float shiftX  = (region.left + 0.5f * ((int)region.getWidth() - (int)info.totalWidth)) / region.getWidth();
-			float shiftY = (region.bottom + 0.5f * ((int)region.getHeight() - (int)info.totalHeight)) / region.getHeight();
-
-			rprCameraSetLensShift(camera, shiftX, shiftY);
-
-			if (fireRenderCamera.isDefaultPerspective())
-			{
-				rprCameraSetSensorSize(camera, sensorSize.x / ((float)info.totalWidth / region.getWidth()),
-					sensorSize.y / ((float)info.totalHeight / region.getHeight()));
-			}
-			else if (fireRenderCamera.isDefaultOrtho())
-			{
-				rprCameraSetOrthoWidth(camera, orthoSize.x / ((float)info.totalWidth / region.getWidth()));
-				rprCameraSetOrthoHeight(camera, orthoSize.y / ((float)info.totalHeight / region.getHeight()));
-			}
-			else
-			{
-				// not implemented;
-				assert(false);
-			}
-
-			// process back plate
-			int yTileIdx = yTiles - yTile - 1;
-
-			int tileWidth = region.right - region.left + 1;
-			int tileHeight = region.top - region.bottom + 1;
-
-			MString colorSpace;
-			frw::Image image = fireRenderCamera.Scope().GetTiledImage(name,
-				info.totalWidth, info.totalHeight,
-				info.tileSizeX, info.tileSizeY,
-				tileWidth, tileHeight,
-				xTiles, yTiles,
-				xTile, yTileIdx,
-				colorSpace, tileFitType);
-			fireRenderCamera.Scene().SetBackgroundImage(image);
-
-			counter++;
-			if (!callbackFunc(region, 100 * counter / (xTiles * yTiles), outBuffer))
-			{
-				// to exit the loop
-				xTile = xTiles;
-				yTile = -1; 
-			}
-		}
-	}
+		FireRenderContext& renderContext = *renderContexts[contextIndex];
+		TileCameraState& cameraState = cameraStates[contextIndex];
 
-	// back previous values
-	// probably this may be ommited, since this is already end of the rendering
-	if (fireRenderCamera.isDefaultPerspective())
-	{
-		rprCameraSetSensorSize(camera, sensorSize.x, sensorSize.y);
-	}
-	else if (fireRenderCamera.isDefaultOrtho())
+		RenderRegion region = tile.region;
+
+		cameraState.SetupForTile(info, region);
+
+		// process back plate
+		int tileWidth = region.right - region.left + 1;
+		int tileHeight = region.top - region.bottom + 1;
+
+		MString colorSpace;
+		frw::Image image = cameraState.fireRenderCamera->Scope().GetTiledImage(name,
+			info.totalWidth, info.totalHeight,
+			info.tileSizeX, info.tileSizeY,
+			tileWidth, tileHeight,
+			xTiles, yTiles,
+			tile.xTile, tile.yTileIdx,
+			colorSpace, tileFitType);
+		cameraState.fireRenderCamera->Scene().SetBackgroundImage(image);
+
+		return callbackFunc(contextIndex, region, 100 * tile.sequenceNumber / scheduler.GetTileCount(), outBuffer);
+	});
+
+	for (TileCameraState& cameraState : cameraStates)
 	{
-		rprCameraSetOrthoWidth(camera, orthoSize.x);
-		rprCameraSetOrthoHeight(camera, orthoSize.y);
+		cameraState.Restore();
 	}
 }
@@ -14,30 +14,12 @@ limitations under the License.
 
 #include <functional>
 
-#include "RenderRegion.h"
+#include "TileScheduler.h"
 #include "FireRenderAOV.h"
 
 class FireRenderContext;
 
-enum class TileRenderFillType
-{
-	Normal = 0
-
-	// _TODO Add Different algorithms, i.e spiral etc
-};
-
-struct TileRenderInfo
-{
-	unsigned int totalWidth;
-	unsigned int totalHeight;
-
-	unsigned int tileSizeX;
-	unsigned int tileSizeY;
-
-	TileRenderFillType tilesFillType;
-};
-
-typedef std::function<bool(RenderRegion&, int, AOVPixelBuffers& out)> TileRenderingCallback;
+typedef std::function<bool(unsigned int contextIndex, RenderRegion&, int, AOVPixelBuffers& out)> TileRenderingCallback;
 
 class TileRenderer
 {
@@ -46,5 +28,9 @@ public:
 	~TileRenderer();
 
 	void Render(FireRenderContext& renderContext, const TileRenderInfo& info, AOVPixelBuffers& outBuffer, TileRenderingCallback callbackFunc);
+
+	// Renders different tiles on each context concurrently; all contexts should have the same scene translated.
+	// Callback is called from the worker threads, index of the context which rendered the tile is passed to it
+	void Render(const std::vector<FireRenderContext*>& renderContexts, const TileRenderInfo& info, AOVPixelBuffers& outBuffer, TileRenderingCallback callbackFunc);
 };
 
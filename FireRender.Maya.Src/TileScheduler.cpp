@@ -0,0 +1,119 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "TileScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <thread>
+
+TileScheduler::TileScheduler(const TileRenderInfo& info) :
+	m_nextTile(0),
+	m_cancelled(false)
+{
+	float tilesXf = info.totalWidth / (float)info.tileSizeX;
+	float tilesYf = info.totalHeight / (float)info.tileSizeY;
+
+	m_tilesX = (int) std::ceil(tilesXf);
+	m_tilesY = (int) std::ceil(tilesYf);
+
+	m_tiles.reserve(m_tilesX * m_tilesY);
+
+	unsigned int counter = 0;
+	for (int yTile = m_tilesY - 1; yTile >= 0; yTile--)
+	{
+		for (int xTile = 0; xTile < m_tilesX; xTile++)
+		{
+			TileDescription tile;
+
+			tile.region.left = xTile * info.tileSizeX;
+			tile.region.right = std::min(info.totalWidth, tile.region.left + info.tileSizeX) - 1;
+
+			tile.region.bottom = yTile * info.tileSizeY;
+			tile.region.top = std::min(info.totalHeight, tile.region.bottom + info.tileSizeY) - 1;
+
+			tile.xTile = xTile;
+			tile.yTile = yTile;
+			tile.yTileIdx = m_tilesY - yTile - 1;
+			tile.sequenceNumber = ++counter;
+
+			m_tiles.push_back(tile);
+		}
+	}
+}
+
+bool TileScheduler::GetNextTile(TileDescription& tile)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_cancelled || m_nextTile >= m_tiles.size())
+		return false;
+
+	tile = m_tiles[m_nextTile++];
+
+	return true;
+}
+
+void TileScheduler::Cancel()
+{
+	m_cancelled = true;
+}
+
+void TileScheduler::Run(unsigned int workerCount, TileWorkerFunc workerFunc)
+{
+	std::exception_ptr workerException;
+	std::mutex exceptionMutex;
+
+	auto workerProc = [&](unsigned int workerIndex)
+	{
+		try
+		{
+			TileDescription tile;
+			while (GetNextTile(tile))
+			{
+				if (!workerFunc(workerIndex, tile))
+				{
+					Cancel();
+				}
+			}
+		}
+		catch (...)
+		{
+			Cancel();
+
+			std::lock_guard<std::mutex> lock(exceptionMutex);
+			if (!workerException)
+			{
+				workerException = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int workerIndex = 1; workerIndex < workerCount; workerIndex++)
+	{
+		threads.emplace_back(workerProc, workerIndex);
+	}
+
+	workerProc(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (workerException)
+	{
+		std::rethrow_exception(workerException);
+	}
+}
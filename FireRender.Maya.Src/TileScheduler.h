@@ -0,0 +1,87 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "RenderRegion.h"
+
+enum class TileRenderFillType
+{
+	Normal = 0
+
+	// _TODO Add Different algorithms, i.e spiral etc
+};
+
+struct TileRenderInfo
+{
+	unsigned int totalWidth;
+	unsigned int totalHeight;
+
+	unsigned int tileSizeX;
+	unsigned int tileSizeY;
+
+	TileRenderFillType tilesFillType;
+};
+
+struct TileDescription
+{
+	RenderRegion region;
+
+	int xTile;
+	int yTile;
+
+	// index of the tile row counted from the top of the image (used for back plate tiling)
+	int yTileIdx;
+
+	// 1-based order in which tile was handed out
+	unsigned int sequenceNumber;
+};
+
+/** Splits frame into tiles and hands them out to any number of rendering workers.
+	Scheduler doesn't depend on RPR so it can be driven by any renderer */
+class TileScheduler
+{
+public:
+	// returns false if rendering should be stopped
+	typedef std::function<bool(unsigned int workerIndex, const TileDescription& tile)> TileWorkerFunc;
+
+	TileScheduler(const TileRenderInfo& info);
+
+	int GetTilesX() const { return m_tilesX; }
+	int GetTilesY() const { return m_tilesY; }
+	unsigned int GetTileCount() const { return (unsigned int) m_tiles.size(); }
+
+	// thread safe; returns false if there are no tiles left or scheduling was cancelled
+	bool GetNextTile(TileDescription& tile);
+
+	void Cancel();
+	bool IsCancelled() const { return m_cancelled; }
+
+	// Runs workerCount workers until all tiles are processed. Worker 0 runs on the calling thread.
+	// Exception thrown by any worker cancels scheduling and is rethrown after all workers are finished.
+	void Run(unsigned int workerCount, TileWorkerFunc workerFunc);
+
+private:
+	int m_tilesX;
+	int m_tilesY;
+
+	std::vector<TileDescription> m_tiles;
+
+	std::mutex m_mutex;
+	size_t m_nextTile;
+	std::atomic<bool> m_cancelled;
+};
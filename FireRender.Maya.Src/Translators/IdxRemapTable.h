@@ -0,0 +1,56 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace FireMaya
+{
+	// Converts global index of the mesh (vertex, normal or uv coord) to index local to submesh.
+	// Global index spaces of Maya mesh are bounded by vertex / normal / uv counts, so the table is a dense
+	// array indexed by global index. One table is shared by all submeshes which are filled one after another:
+	// entries are stamped with the submesh which wrote them, so starting next submesh resets nothing.
+	class IdxRemapTable
+	{
+	public:
+		static const int NotInDictionary = -1;
+
+		void Init(size_t globalCount)
+		{
+			m_entries.assign(globalCount, Entry());
+			m_stamp = 1;
+		}
+
+		// all entries become NotInDictionary
+		void NextSubmesh() { ++m_stamp; }
+
+		int Get(int globalIdx) const
+		{
+			const Entry& entry = m_entries[globalIdx];
+			return entry.stamp == m_stamp ? entry.localIdx : NotInDictionary;
+		}
+
+		void Set(int globalIdx, int localIdx) { m_entries[globalIdx] = { m_stamp, localIdx }; }
+
+	private:
+		struct Entry
+		{
+			unsigned int stamp = 0;
+			int localIdx = NotInDictionary;
+		};
+
+		std::vector<Entry> m_entries;
+		unsigned int m_stamp = 1;
+	};
+}
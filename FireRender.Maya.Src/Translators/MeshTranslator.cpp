@@ -22,12 +22,15 @@ limitations under the License.
 #include <maya/MFloatPointArray.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MFloatArray.h>
+#include <maya/MColorArray.h>
 #include <maya/MPointArray.h>
 #include <maya/MItMeshPolygon.h>
 #include <maya/MSelectionList.h>
 #include <maya/MAnimControl.h>
 
 #include <unordered_map>
+#include <atomic>
+#include <cstring>
 
 #include "SingleShaderMeshTranslator.h"
 #include "MultipleShaderMeshTranslator.h"
@@ -152,12 +155,252 @@ void FireMaya::MeshTranslator::MeshPolygonData::clear()
 {
 	m_isInitialized = false;
 
-	arrVertices.clear();
-	arrNormals.clear();
+	// vector::clear() keeps capacity, swap with empty vectors to actually give memory back
+	std::vector<float>().swap(arrVertices);
+	std::vector<float>().swap(arrNormals);
 
-	uvCoords.clear();
-	sizeCoords.clear();
-	puvCoords.clear();
+	std::vector<std::vector<Float2>>().swap(uvCoords);
+	std::vector<size_t>().swap(sizeCoords);
+	std::vector<const float*>().swap(puvCoords);
+
+	uvSetNames.clear();
+	faceMaterialIndices.clear();
+
+	pVertices = nullptr;
+	pNormals = nullptr;
+	countVertices = 0;
+	countNormals = 0;
+	triangleVertexIndicesCount = 0;
+	motionSamplesCount = 0;
+	haveDeformation = false;
+}
+
+void FireMaya::MeshTranslator::StagingArena::Reset(size_t indicesCount, unsigned int uvSetCount, unsigned int colorCount)
+{
+	faceVertexIndices.clear();
+	faceVertexIndices.reserve(indicesCount);
+
+	faceNormalIndices.clear();
+	faceNormalIndices.reserve(indicesCount);
+
+	uvIndices.resize(uvSetCount);
+	for (std::vector<int>& channelIndices : uvIndices)
+	{
+		channelIndices.clear();
+		channelIndices.reserve(indicesCount);
+	}
+
+	// filled by vertex index, so these are sized rather than reserved
+	vertexColors.clear();
+	vertexColors.resize(colorCount);
+	colorVertexIndices.clear();
+	colorVertexIndices.resize(colorCount);
+
+	// in case all faces are triangles
+	numFaceVertices.clear();
+	numFaceVertices.reserve(indicesCount / 3);
+
+	ngonPolygons.clear();
+}
+
+namespace
+{
+	// bytes held by topology caches of all meshes
+	std::atomic<size_t> s_topologyCacheBytes { 0 };
+}
+
+void FireMaya::MeshTranslator::TopologyCache::clear()
+{
+	s_topologyCacheBytes -= m_reservedBytes;
+	m_reservedBytes = 0;
+
+	fingerprint = 0;
+	countVertices = 0;
+
+	std::vector<int>().swap(faceVertexIndices);
+	std::vector<int>().swap(faceNormalIndices);
+	std::vector<std::vector<int>>().swap(uvIndices);
+	std::vector<std::vector<Float2>>().swap(uvCoords);
+	std::vector<int>().swap(numFaceVertices);
+	std::vector<MColor>().swap(vertexColors);
+	std::vector<int>().swap(colorVertexIndices);
+	std::vector<int>().swap(faceMaterialIndices);
+	std::vector<int>().swap(ngonPolygons);
+}
+
+size_t FireMaya::MeshTranslator::TopologyCache::GetSizeBytes() const
+{
+	size_t bytes = (faceVertexIndices.capacity() + faceNormalIndices.capacity() + numFaceVertices.capacity() +
+		colorVertexIndices.capacity() + faceMaterialIndices.capacity() + ngonPolygons.capacity()) * sizeof(int);
+	bytes += vertexColors.capacity() * sizeof(MColor);
+
+	for (const std::vector<int>& channelIndices : uvIndices)
+	{
+		bytes += channelIndices.capacity() * sizeof(int);
+	}
+
+	for (const std::vector<Float2>& channelCoords : uvCoords)
+	{
+		bytes += channelCoords.capacity() * sizeof(Float2);
+	}
+
+	return bytes;
+}
+
+bool FireMaya::MeshTranslator::TopologyCache::ReserveBudget()
+{
+	size_t bytes = GetSizeBytes();
+
+	if (s_topologyCacheBytes.fetch_add(bytes) + bytes > TopologyCacheBudgetBytes)
+	{
+		s_topologyCacheBytes -= bytes;
+		return false;
+	}
+
+	m_reservedBytes = bytes;
+
+	return true;
+}
+
+namespace
+{
+	template <typename T>
+	void ReleaseIfAboveLimit(std::vector<T>& buffer, size_t limitBytes)
+	{
+		buffer.clear();
+
+		if (buffer.capacity() * sizeof(T) > limitBytes)
+		{
+			std::vector<T>().swap(buffer);
+		}
+	}
+}
+
+void FireMaya::MeshTranslator::StagingArena::Release()
+{
+	ReleaseIfAboveLimit(faceVertexIndices, StagingArenaRetainedBytes);
+	ReleaseIfAboveLimit(faceNormalIndices, StagingArenaRetainedBytes);
+
+	for (std::vector<int>& channelIndices : uvIndices)
+	{
+		ReleaseIfAboveLimit(channelIndices, StagingArenaRetainedBytes);
+	}
+
+	ReleaseIfAboveLimit(vertexColors, StagingArenaRetainedBytes);
+	ReleaseIfAboveLimit(colorVertexIndices, StagingArenaRetainedBytes);
+	ReleaseIfAboveLimit(numFaceVertices, StagingArenaRetainedBytes);
+	ReleaseIfAboveLimit(ngonPolygons, StagingArenaRetainedBytes);
+
+	ReleaseIfAboveLimit(faceVertexIds.polygonOffsets, StagingArenaRetainedBytes);
+	ReleaseIfAboveLimit(faceVertexIds.normalIds, StagingArenaRetainedBytes);
+
+	for (std::vector<int>& channelIds : faceVertexIds.uvIds)
+	{
+		ReleaseIfAboveLimit(channelIds, StagingArenaRetainedBytes);
+	}
+}
+
+size_t FireMaya::MeshTranslator::StagingArena::GetCapacityBytes() const
+{
+	size_t bytes = (faceVertexIndices.capacity() + faceNormalIndices.capacity() + colorVertexIndices.capacity() + numFaceVertices.capacity() + ngonPolygons.capacity()) * sizeof(int);
+	bytes += vertexColors.capacity() * sizeof(MColor);
+
+	for (const std::vector<int>& channelIndices : uvIndices)
+	{
+		bytes += channelIndices.capacity() * sizeof(int);
+	}
+
+	bytes += (faceVertexIds.polygonOffsets.capacity() + faceVertexIds.normalIds.capacity()) * sizeof(int);
+
+	for (const std::vector<int>& channelIds : faceVertexIds.uvIds)
+	{
+		bytes += channelIds.capacity() * sizeof(int);
+	}
+
+	return bytes;
+}
+
+void FireMaya::MeshTranslator::FaceVertexIds::Read(const MFnMesh& fnMesh, const MStringArray& uvSetNames)
+{
+	MStatus mstatus;
+
+	// normal id counts are equal to vertex counts of polygons
+	MIntArray polygonVertexCounts;
+	MIntArray mayaNormalIds;
+	mstatus = fnMesh.getNormalIds(polygonVertexCounts, mayaNormalIds);
+	assert(MStatus::kSuccess == mstatus);
+
+	unsigned int polygonCount = polygonVertexCounts.length();
+	polygonOffsets.resize(polygonCount);
+
+	unsigned int faceVertexCount = 0;
+	for (unsigned int polygonIdx = 0; polygonIdx < polygonCount; ++polygonIdx)
+	{
+		polygonOffsets[polygonIdx] = faceVertexCount;
+		faceVertexCount += polygonVertexCounts[polygonIdx];
+	}
+
+	assert(mayaNormalIds.length() == faceVertexCount);
+	normalIds.resize(mayaNormalIds.length());
+	if (!normalIds.empty())
+	{
+		mayaNormalIds.get(normalIds.data());
+	}
+
+	unsigned int uvSetCount = uvSetNames.length();
+	uvIds.resize(uvSetCount);
+
+	for (unsigned int uvSetIdx = 0; uvSetIdx < uvSetCount; ++uvSetIdx)
+	{
+		// uv counts are either 0 or equal to vertex count of polygon
+		MIntArray uvCounts;
+		MIntArray mayaUVIds;
+		mstatus = fnMesh.getAssignedUVs(uvCounts, mayaUVIds, &uvSetNames[uvSetIdx]);
+		assert(MStatus::kSuccess == mstatus);
+
+		std::vector<int>& channelIds = uvIds[uvSetIdx];
+		channelIds.assign(faceVertexCount, UnassignedUV);
+
+		unsigned int mayaIdx = 0;
+		unsigned int uvPolygonCount = std::min(uvCounts.length(), polygonCount);
+		for (unsigned int polygonIdx = 0; polygonIdx < uvPolygonCount; ++polygonIdx)
+		{
+			unsigned int count = std::min((unsigned int) uvCounts[polygonIdx], (unsigned int) polygonVertexCounts[polygonIdx]);
+			for (unsigned int localIdx = 0; localIdx < count; ++localIdx)
+			{
+				channelIds[polygonOffsets[polygonIdx] + localIdx] = mayaUVIds[mayaIdx + localIdx];
+			}
+
+			mayaIdx += uvCounts[polygonIdx];
+		}
+	}
+}
+
+void FireMaya::MeshTranslator::MeshIdxRemapTables::Init(size_t vertexCount, size_t normalCount, const std::vector<size_t>& uvCoordCounts)
+{
+	vertices.Init(vertexCount);
+	normals.Init(normalCount);
+
+	for (size_t uvSetIdx = 0; uvSetIdx < 2; ++uvSetIdx)
+	{
+		size_t uvCount = uvSetIdx < uvCoordCounts.size() ? uvCoordCounts[uvSetIdx] : 0;
+		uvs[uvSetIdx].Init(uvCount);
+	}
+}
+
+void FireMaya::MeshTranslator::MeshIdxRemapTables::NextSubmesh()
+{
+	vertices.NextSubmesh();
+	normals.NextSubmesh();
+	uvs[0].NextSubmesh();
+	uvs[1].NextSubmesh();
+}
+
+FireMaya::MeshTranslator::StagingArena& FireMaya::MeshTranslator::GetStagingArena()
+{
+	thread_local StagingArena arena;
+
+	return arena;
 }
 
 bool FireMaya::MeshTranslator::MeshPolygonData::Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath)
@@ -231,6 +474,30 @@ bool FireMaya::MeshTranslator::MeshPolygonData::Initialize(MFnMesh& fnMesh, unsi
 	return true;
 }
 
+bool FireMaya::MeshTranslator::MeshPolygonData::InitializePositions(MFnMesh& fnMesh)
+{
+	MStatus mstatus;
+
+	pVertices = fnMesh.getRawPoints(&mstatus);
+	countVertices = fnMesh.numVertices();
+	if ((pVertices == nullptr) || (countVertices == 0))
+	{
+		return false;
+	}
+
+	pNormals = fnMesh.getRawNormals(&mstatus);
+	countNormals = fnMesh.numNormals();
+
+	haveDeformation = false;
+	motionSamplesCount = 0;
+
+	arrVertices.assign(pVertices, pVertices + countVertices * 3);
+	arrNormals.assign(pNormals, pNormals + countNormals * 3);
+
+	m_isInitialized = true;
+	return true;
+}
+
 bool FireMaya::MeshTranslator::MeshPolygonData::ReadDeformationFrame(MFnMesh& fnMesh, unsigned int currentDeformationFrame)
 {
 	if (!haveDeformation)
@@ -380,7 +647,8 @@ frw::Shape FireMaya::MeshTranslator::TranslateMesh(
 	const frw::Context& context,
 	const MObject& originalObject,
 	std::vector<int>& outFaceMaterialIndices,
-	unsigned int deformationFrameCount, MString fullDagPath)
+	unsigned int deformationFrameCount, MString fullDagPath,
+	TopologyCache* outTopologyCache)
 {
 	DebugPrint("TranslateMesh: %s", meshPolygonData.fullName.asUTF8());
 
@@ -406,12 +674,42 @@ frw::Shape FireMaya::MeshTranslator::TranslateMesh(
 		mayaStatus.perror("MFnMesh constructor");
 	}
 
+	// topology can be reused only for meshes translated directly (not from temporary smoothed / tessellated ones) without deformation motion blur
+	size_t fingerprint = 0;
+	if (outTopologyCache != nullptr)
+	{
+		outTopologyCache->clear();
+
+		if ((object == originalObject) && (meshPolygonData.motionSamplesCount == 0))
+		{
+			fingerprint = CalculateTopologyFingerprint(fnMesh, meshPolygonData.faceMaterialIndices);
+		}
+		else
+		{
+			outTopologyCache = nullptr;
+		}
+	}
+
 	// translate mesh
 	frw::Shape outShape;
 	SingleShaderMeshTranslator::TranslateMesh(
-		context, fnMesh, outShape, meshPolygonData, meshPolygonData.faceMaterialIndices, outFaceMaterialIndices
+		context, fnMesh, outShape, meshPolygonData, meshPolygonData.faceMaterialIndices, outFaceMaterialIndices, outTopologyCache
 	);
 
+	// cache stays empty if topology can't be reused (i.e. mesh has non convex n-gons)
+	if ((outTopologyCache != nullptr) && !outTopologyCache->numFaceVertices.empty())
+	{
+		if (outTopologyCache->ReserveBudget())
+		{
+			outTopologyCache->fingerprint = fingerprint;
+		}
+		else
+		{
+			DebugPrint("TranslateMesh: %s, topology cache budget exceeded, mesh is not cached", meshPolygonData.fullName.asUTF8());
+			outTopologyCache->clear();
+		}
+	}
+
 	// Now remove any temporary mesh we created.
 	MFnDagNode node(originalObject);
 	if (!meshPolygonData.tesselatedObject.isNull())
@@ -429,6 +727,234 @@ frw::Shape FireMaya::MeshTranslator::TranslateMesh(
 	return outShape;
 }
 
+bool FireMaya::MeshTranslator::PreProcessDeformedMesh(
+	MeshPolygonData& outMeshPolygonData,
+	const MObject& originalObject,
+	const TopologyCache& topologyCache)
+{
+	MAIN_THREAD_ONLY;
+
+	if (!topologyCache.IsValid() || !originalObject.hasFn(MFn::kMesh))
+	{
+		return false;
+	}
+
+	MStatus mayaStatus;
+	MFnMesh fnMesh(originalObject, &mayaStatus);
+	if (MStatus::kSuccess != mayaStatus)
+	{
+		return false;
+	}
+
+	if (fnMesh.isIntermediateObject())
+	{
+		return false;
+	}
+
+	// smooth preview is translated from temporary mesh, its topology is not cached
+	DependencyNode attributes(originalObject);
+	if (attributes.getBool("displaySmoothMesh"))
+	{
+		return false;
+	}
+
+	MIntArray faceMaterialIndices;
+	GetFaceMaterials(fnMesh, faceMaterialIndices);
+
+	if (CalculateTopologyFingerprint(fnMesh, faceMaterialIndices) != topologyCache.fingerprint)
+	{
+		return false;
+	}
+
+	if (!topologyCache.ngonPolygons.empty())
+	{
+		MItMeshPolygon it(originalObject);
+		int prevIndex = 0;
+
+		for (int polygonIdx : topologyCache.ngonPolygons)
+		{
+			it.setIndex(polygonIdx, prevIndex);
+			if (!it.isConvex())
+			{
+				return false;
+			}
+		}
+	}
+
+	outMeshPolygonData.fullName = fnMesh.fullPathName();
+
+	DebugPrint("PreProcessDeformedMesh: %s, topology is reused", outMeshPolygonData.fullName.asUTF8());
+
+	return outMeshPolygonData.InitializePositions(fnMesh);
+}
+
+frw::Shape FireMaya::MeshTranslator::TranslateDeformedMesh(
+	MeshPolygonData& meshPolygonData,
+	const frw::Context& context,
+	const MObject& originalObject,
+	const TopologyCache& topologyCache,
+	std::vector<int>& outFaceMaterialIndices)
+{
+	DebugPrint("TranslateDeformedMesh: %s", meshPolygonData.fullName.asUTF8());
+
+	assert(topologyCache.IsValid());
+	assert(topologyCache.countVertices == meshPolygonData.countVertices);
+
+	unsigned int uvSetCount = (unsigned int) topologyCache.uvCoords.size();
+
+	std::vector<const float*> puvCoords;
+	std::vector<size_t> sizeCoords;
+	std::vector<const rpr_int*> puvIndices;
+	puvCoords.reserve(uvSetCount);
+	sizeCoords.reserve(uvSetCount);
+	puvIndices.reserve(uvSetCount);
+
+	for (unsigned int idx = 0; idx < uvSetCount; ++idx)
+	{
+		const std::vector<Float2>& coords = topologyCache.uvCoords[idx];
+		puvCoords.push_back(coords.size() > 0 ? (const float*) coords.data() : nullptr);
+		sizeCoords.push_back(coords.size());
+		puvIndices.push_back(topologyCache.uvIndices[idx].size() > 0 ? topologyCache.uvIndices[idx].data() : nullptr);
+	}
+
+	std::vector<int> multiUV_texcoord_strides(uvSetCount, sizeof(Float2));
+	std::vector<int> texIndexStride(uvSetCount, sizeof(int));
+
+	if (sizeCoords.size() == 0 || puvIndices.size() == 0 || sizeCoords[0] == 0 || puvIndices[0] == nullptr)
+	{
+		// no uv set
+		uvSetCount = 0;
+	}
+
+	rpr_mesh_info mesh_properties[16] = { 0 };
+
+	MFnDagNode node(originalObject);
+
+	frw::Shape outShape = context.CreateMeshEx(
+		meshPolygonData.GetVertices(), meshPolygonData.GetTotalVertexCount(), sizeof(Float3),
+		meshPolygonData.GetNormals(), meshPolygonData.GetTotalNormalCount(), sizeof(Float3),
+		nullptr, 0, 0,
+		uvSetCount, puvCoords.data(), sizeCoords.data(), multiUV_texcoord_strides.data(),
+		topologyCache.faceVertexIndices.data(), sizeof(rpr_int),
+		topologyCache.faceNormalIndices.data(), sizeof(rpr_int),
+		puvIndices.data(), texIndexStride.data(),
+		topologyCache.numFaceVertices.data(), topologyCache.numFaceVertices.size(), mesh_properties, node.name().asChar());
+
+	if (!topologyCache.vertexColors.empty())
+	{
+		outShape.SetVertexColors(topologyCache.colorVertexIndices, topologyCache.vertexColors, (rpr_int) topologyCache.countVertices);
+	}
+
+	outFaceMaterialIndices = topologyCache.faceMaterialIndices;
+
+	meshPolygonData.clear();
+
+	return outShape;
+}
+
+namespace
+{
+	// FNV-1a over 32 bit words
+	const size_t FingerprintPrime = 1099511628211ull;
+
+	void HashWord(size_t& hash, unsigned int value)
+	{
+		hash ^= value;
+		hash *= FingerprintPrime;
+	}
+
+	void HashWords(size_t& hash, const MIntArray& values)
+	{
+		unsigned int count = values.length();
+		HashWord(hash, count);
+
+		for (unsigned int idx = 0; idx < count; ++idx)
+		{
+			HashWord(hash, (unsigned int) values[idx]);
+		}
+	}
+
+	void HashFloat(size_t& hash, float value)
+	{
+		unsigned int word;
+		std::memcpy(&word, &value, sizeof(word));
+		HashWord(hash, word);
+	}
+
+	void HashFloats(size_t& hash, const MFloatArray& values)
+	{
+		unsigned int count = values.length();
+		HashWord(hash, count);
+
+		for (unsigned int idx = 0; idx < count; ++idx)
+		{
+			HashFloat(hash, values[idx]);
+		}
+	}
+}
+
+size_t FireMaya::MeshTranslator::CalculateTopologyFingerprint(const MFnMesh& fnMesh, const MIntArray& faceMaterialIndices)
+{
+	size_t hash = 14695981039346656037ull;
+
+	HashWord(hash, fnMesh.numVertices());
+	HashWord(hash, fnMesh.numNormals());
+	HashWord(hash, fnMesh.numColors());
+
+	MIntArray polygonVertexCounts;
+	MIntArray polygonVertices;
+	fnMesh.getVertices(polygonVertexCounts, polygonVertices);
+	HashWords(hash, polygonVertexCounts);
+	HashWords(hash, polygonVertices);
+
+	// normal ids change with hard / soft edges
+	MIntArray normalCounts;
+	MIntArray normalIds;
+	fnMesh.getNormalIds(normalCounts, normalIds);
+	HashWords(hash, normalIds);
+
+	// uv and vertex color values are cached with the topology, so they are hashed too; up to 2 UV channels is supported
+	MStringArray uvSetNames;
+	fnMesh.getUVSetNames(uvSetNames);
+	unsigned int uvSetCount = std::min(uvSetNames.length(), 2u);
+	HashWord(hash, uvSetCount);
+
+	for (unsigned int uvSetIdx = 0; uvSetIdx < uvSetCount; ++uvSetIdx)
+	{
+		HashWord(hash, fnMesh.numUVs(uvSetNames[uvSetIdx]));
+
+		MIntArray uvCounts;
+		MIntArray uvIds;
+		fnMesh.getAssignedUVs(uvCounts, uvIds, &uvSetNames[uvSetIdx]);
+		HashWords(hash, uvCounts);
+		HashWords(hash, uvIds);
+
+		MFloatArray uArray;
+		MFloatArray vArray;
+		fnMesh.getUVs(uArray, vArray, &uvSetNames[uvSetIdx]);
+		HashFloats(hash, uArray);
+		HashFloats(hash, vArray);
+	}
+
+	// same colors as the translator reads
+	MColorArray vertexColors;
+	const_cast<MFnMesh&>(fnMesh).getVertexColors(vertexColors);
+	HashWord(hash, vertexColors.length());
+
+	for (unsigned int idx = 0; idx < vertexColors.length(); ++idx)
+	{
+		const MColor& color = vertexColors[idx];
+		HashFloat(hash, color.r);
+		HashFloat(hash, color.g);
+		HashFloat(hash, color.b);
+		HashFloat(hash, color.a);
+	}
+
+	HashWords(hash, faceMaterialIndices);
+
+	return hash != 0 ? hash : 1;
+}
+
 frw::Shape FireMaya::MeshTranslator::TranslateMesh(
 	const frw::Context& context, 
 	const MObject& originalObject, 
@@ -923,6 +1449,10 @@ void FireMaya::MeshTranslator::GetUVCoords(
 	std::vector<size_t>& sizeCoords)
 {
 	uvSetNames.clear();
+	uvCoords.clear();
+	puvCoords.clear();
+	sizeCoords.clear();
+
 	fnMesh.getUVSetNames(uvSetNames);
 	unsigned int uvSetCount = uvSetNames.length();
 
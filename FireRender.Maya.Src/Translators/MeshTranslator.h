@@ -14,6 +14,7 @@ limitations under the License.
 
 #include "frWrap.h"
 #include "FireRenderUtils.h"
+#include "IdxRemapTable.h"
 
 #include <maya/MItMeshPolygon.h>
 #include <maya/MObject.h>
@@ -58,6 +59,8 @@ namespace FireMaya
 
 			// Initializes mesh and returns error status
 			bool Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath);
+			// reads only points and normals; used when topology of the mesh is taken from TopologyCache
+			bool InitializePositions(MFnMesh& fnMesh);
 			bool ReadDeformationFrame(MFnMesh& fnMesh, unsigned int currentDeformationFrame);
 			bool ProcessDeformationFrameCount(MFnMesh& fnMesh, MString fullDagPath);
 
@@ -69,7 +72,7 @@ namespace FireMaya
 
 			bool IsInitialized(void) const { return m_isInitialized; }
 
-			// free memory
+			// free memory; called once data is uploaded to RPR, so nothing stays resident in the plugin
 			void clear(void);
 
 		private:
@@ -96,18 +99,6 @@ namespace FireMaya
 			// output indices of normals (3 indices for each triangle)
 			std::vector<int> normalIndices;
 
-			// table to convert global index of vertex (index of vertex in pVertices array) to one in vertexCoords
-			// - local to submesh
-			std::unordered_map<int, int> vertexCoordsIndicesGlobalToDictionary;
-
-			// table to convert global index of normal (index of normal in pNormals array) to one in vertexCoords
-			// - local to submesh
-			std::unordered_map<int, int> normalCoordIdxGlobal2Local;
-
-			// table to convert global index of uv coord (index of coord in uvIndices array) to one in normalCoords
-			// - local to submesh
-			std::unordered_map<int, int> uvCoordIdxGlobal2Local[2]; // size is always 1 or 2
-
 			// output indices of UV coordinates (3 indices for each triangle)
 			// up to 2 UV channels is supported, thus vector of vectors
 			std::vector<int> uvIndices[2];
@@ -119,8 +110,131 @@ namespace FireMaya
 			std::map<int, MColor> vertexColors;
 		};
 
+		// Global to submesh-local index table, see IdxRemapTable.h
+		typedef FireMaya::IdxRemapTable IdxRemapTable;
+
+		struct MeshIdxRemapTables
+		{
+			// vertex index (in pVertices array) to one in vertexCoords
+			IdxRemapTable vertices;
+
+			// normal index (in pNormals array) to one in normalCoords
+			IdxRemapTable normals;
+
+			// uv coord index (in uvCoords array) to one in uvSubmeshCoords
+			IdxRemapTable uvs[2]; // size is always 1 or 2
+
+			// sizes tables by global counts of the mesh
+			void Init(size_t vertexCount, size_t normalCount, const std::vector<size_t>& uvCoordCounts);
+
+			void NextSubmesh();
+		};
+
+		// Per face-vertex normal and uv ids of the whole mesh. Read from Maya once per mesh
+		// with bulk MFnMesh calls instead of querying MItMeshPolygon for every vertex and every UV set.
+		struct FaceVertexIds
+		{
+			// index of first face-vertex of each polygon
+			std::vector<unsigned int> polygonOffsets;
+
+			std::vector<int> normalIds;
+
+			// one array per UV set; UnassignedUV for polygons which have no uvs in the set
+			std::vector<std::vector<int>> uvIds;
+
+			static const int UnassignedUV = -1;
+
+			void Read(const MFnMesh& fnMesh, const MStringArray& uvSetNames);
+
+			int GetNormalId(unsigned int polygonIdx, unsigned int localIdx) const
+			{
+				return normalIds[polygonOffsets[polygonIdx] + localIdx];
+			}
+
+			int GetUVId(unsigned int uvSetIdx, unsigned int polygonIdx, unsigned int localIdx) const
+			{
+				return uvIds[uvSetIdx][polygonOffsets[polygonIdx] + localIdx];
+			}
+		};
+
+		// Temporary index buffers used while building arguments for CreateMeshEx.
+		// One arena per thread: buffers keep their capacity from mesh to mesh, so translating
+		// many meshes doesn't allocate new vectors each time. Buffers grown above
+		// StagingArenaRetainedBytes by a huge mesh are freed by Release().
+		struct StagingArena
+		{
+			std::vector<int> faceVertexIndices;
+			std::vector<int> faceNormalIndices;
+			std::vector<std::vector<int>> uvIndices;
+			std::vector<MColor> vertexColors;
+			std::vector<int> colorVertexIndices;
+			std::vector<int> numFaceVertices;
+			std::vector<int> ngonPolygons;
+
+			FaceVertexIds faceVertexIds;
+
+			// empties buffers for next mesh and reserves space; allocated memory is reused
+			void Reset(size_t indicesCount, unsigned int uvSetCount, unsigned int colorCount);
+
+			// called after data was passed to RPR
+			void Release();
+
+			size_t GetCapacityBytes() const;
+		};
+
+		// Index buffers, uvs, vertex colors and face materials of a translated mesh. Kept only for meshes
+		// that were changed after creation (i.e. deforming ones), so next deformation re-reads just
+		// points and normals and reuses the rest. Valid while fingerprint of the mesh stays the same.
+		// Caches of all meshes together are limited by TopologyCacheBudgetBytes, meshes over the budget are fully translated.
+		struct TopologyCache
+		{
+			TopologyCache() = default;
+			TopologyCache(const TopologyCache&) = delete;
+			TopologyCache& operator=(const TopologyCache&) = delete;
+			~TopologyCache() { clear(); }
+
+			size_t fingerprint = 0;
+			size_t countVertices = 0;
+
+			std::vector<int> faceVertexIndices;
+			std::vector<int> faceNormalIndices;
+			std::vector<std::vector<int>> uvIndices;
+			std::vector<std::vector<Float2>> uvCoords;
+			std::vector<int> numFaceVertices;
+			std::vector<MColor> vertexColors;
+			std::vector<int> colorVertexIndices;
+			std::vector<int> faceMaterialIndices;
+
+			// polygons with more than 4 vertices; they were triangulated as fans which is valid only while they are convex
+			std::vector<int> ngonPolygons;
+
+			bool IsValid() const { return fingerprint != 0; }
+			void clear();
+
+			size_t GetSizeBytes() const;
+
+			// accounts cache size in the shared budget; returns false if the budget would be exceeded
+			bool ReserveBudget();
+
+		private:
+			size_t m_reservedBytes = 0;
+		};
+
+		static const size_t StagingArenaRetainedBytes = 32 * 1024 * 1024;
+		static const size_t TopologyCacheBudgetBytes = 512 * 1024 * 1024;
+
+		static StagingArena& GetStagingArena();
+
 		static bool PreProcessMesh(MeshPolygonData& outMeshPolygonData, const frw::Context& context, const MObject& originalObject, unsigned int deformationFrameCount = 0, unsigned int currentDeformationFrame = 0, MString fullDagPath = "");
-		static frw::Shape TranslateMesh(MeshPolygonData& meshPolygonData, const frw::Context& context, const MObject& originalObject, std::vector<int>& outFaceMaterialIndices, unsigned int deformationFrameCount = 0, MString fullDagPath = "");
+		static frw::Shape TranslateMesh(MeshPolygonData& meshPolygonData, const frw::Context& context, const MObject& originalObject, std::vector<int>& outFaceMaterialIndices, unsigned int deformationFrameCount = 0, MString fullDagPath = "", TopologyCache* outTopologyCache = nullptr);
+
+		// Reads points and normals of deformed mesh if its topology matches the cache; returns false if full PreProcessMesh is needed
+		static bool PreProcessDeformedMesh(MeshPolygonData& outMeshPolygonData, const MObject& originalObject, const TopologyCache& topologyCache);
+		// Creates rpr shape from points and normals read by PreProcessDeformedMesh and cached topology
+		static frw::Shape TranslateDeformedMesh(MeshPolygonData& meshPolygonData, const frw::Context& context, const MObject& originalObject, const TopologyCache& topologyCache, std::vector<int>& outFaceMaterialIndices);
+
+		// hash of polygon connectivity, normal and uv ids, uv and vertex color values and face materials of the mesh; never 0
+		static size_t CalculateTopologyFingerprint(const MFnMesh& fnMesh, const MIntArray& faceMaterialIndices);
 
 		static frw::Shape TranslateMesh(const frw::Context& context, const MObject& originalObject, std::vector<int>& outFaceMaterialIndices, unsigned int deformationFrameCount = 0, MString fullDagPath="");
 
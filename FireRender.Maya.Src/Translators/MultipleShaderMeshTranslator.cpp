@@ -26,11 +26,33 @@ void FireMaya::MultipleShaderMeshTranslator::TranslateMesh(
 	// reserve space for indices and coordinates
 	ReserveShaderData(fnMesh, shaderData.data(), faceMaterialIndices, outElements.size());
 
+	// polygons are processed submesh by submesh, so all submeshes share one set of remap tables
+	std::vector<std::vector<int>> shaderPolygons(outElements.size());
+	for (unsigned int polygonIdx = 0; polygonIdx < faceMaterialIndices.length(); ++polygonIdx)
+	{
+		shaderPolygons[faceMaterialIndices[polygonIdx]].push_back(polygonIdx);
+	}
+
+	MeshTranslator::MeshIdxRemapTables remapTables;
+	remapTables.Init(meshPolygonData.GetTotalVertexCount(), meshPolygonData.GetTotalNormalCount(), meshPolygonData.sizeCoords);
+
+	// normal and uv ids of all polygons are read at once
+	MeshTranslator::FaceVertexIds faceVertexIds;
+	faceVertexIds.Read(fnMesh, meshPolygonData.uvSetNames);
+
 	// iterate through mesh
-	for (MItMeshPolygon it = MItMeshPolygon(fnMesh.object()); !it.isDone(); it.next())
+	MItMeshPolygon it(fnMesh.object());
+	for (size_t shaderId = 0; shaderId < shaderPolygons.size(); ++shaderId)
 	{
-		int shaderId = faceMaterialIndices[it.index()];
-		AddPolygonMultipleShader(it, meshPolygonData, shaderData[shaderId]);
+		remapTables.NextSubmesh();
+
+		for (int polygonIdx : shaderPolygons[shaderId])
+		{
+			int prevIndex = 0;
+			it.setIndex(polygonIdx, prevIndex);
+
+			AddPolygonMultipleShader(it, meshPolygonData, faceVertexIds, remapTables, shaderData[shaderId]);
+		}
 	}
 
 	// make UVCoords and UVIndices arrays have the same size (RPR crashes if they are not)
@@ -43,6 +65,8 @@ void FireMaya::MultipleShaderMeshTranslator::TranslateMesh(
 void FireMaya::MultipleShaderMeshTranslator::AddPolygonMultipleShader(
 	MItMeshPolygon& meshPolygonIterator,
 	const MeshTranslator::MeshPolygonData& meshPolygonData,
+	const MeshTranslator::FaceVertexIds& faceVertexIds,
+	MeshTranslator::MeshIdxRemapTables& remapTables,
 	MeshTranslator::MeshIdxDictionary& outMeshDictionary)
 {
 	MStatus mstatus;
@@ -70,10 +94,9 @@ void FireMaya::MultipleShaderMeshTranslator::AddPolygonMultipleShader(
 	mstatus = meshPolygonIterator.getTriangles(points, globalVertexIndicesFromTrianglesList);
 	assert(MStatus::kSuccess == mstatus);
 
-	FillDictionaryWithVertexCoords(meshPolygonData, globalVertexIndicesFromTrianglesList, outMeshDictionary);
+	FillDictionaryWithVertexCoords(meshPolygonData, globalVertexIndicesFromTrianglesList, remapTables.vertices, outMeshDictionary);
 	FillDictionaryWithColorData(meshPolygonIterator, indicesInPolygon, outMeshDictionary);
-	FillDictionaryWithNormals(meshPolygonIterator, meshPolygonData, globalVertexIndicesFromTrianglesList, vertexIdxGlobalToLocal, outMeshDictionary);
-	FillDictionaryWithUV(meshPolygonIterator, meshPolygonData, globalVertexIndicesFromTrianglesList, vertexIdxGlobalToLocal, outMeshDictionary);
+	FillDictionaryWithNormalsAndUV(meshPolygonData, faceVertexIds, meshPolygonIterator.index(), globalVertexIndicesFromTrianglesList, vertexIdxGlobalToLocal, remapTables, outMeshDictionary);
 }
 
 
@@ -93,7 +116,6 @@ void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithColorData(
 			continue;
 
 		int globalVertexIndex = indicesInPolygon[localVertexIndex];
-		int coreVertexIndex = outMeshDictionary.vertexCoordsIndicesGlobalToDictionary[globalVertexIndex];
 
 		outMeshDictionary.vertexColors[globalVertexIndex] = polygonColors[localVertexIndex];
 		outMeshDictionary.colorVertexIndices[globalVertexIndex] = globalVertexIndex;
@@ -103,6 +125,7 @@ void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithColorData(
 void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithVertexCoords(
 	const MeshTranslator::MeshPolygonData& meshPolygonData,
 	const MIntArray& globalVertexIndicesFromTrianglesList,
+	MeshTranslator::IdxRemapTable& vertexRemapTable,
 	MeshTranslator::MeshIdxDictionary& outMeshDictionary)
 {
 	// Save polygon triangles coordinates into dictionary with corresponging indices
@@ -111,9 +134,9 @@ void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithVertexCoords(
 	for (unsigned int localVertexIndexFromPolygonTriangle = 0; localVertexIndexFromPolygonTriangle < globalVertexIndicesFromTrianglesList.length(); ++localVertexIndexFromPolygonTriangle)
 	{
 		int globalVertexIndex = globalVertexIndicesFromTrianglesList[localVertexIndexFromPolygonTriangle];
-		auto it = outMeshDictionary.vertexCoordsIndicesGlobalToDictionary.find(globalVertexIndex);
+		int dictionaryVertexIndex = vertexRemapTable.Get(globalVertexIndex);
 
-		if (it == outMeshDictionary.vertexCoordsIndicesGlobalToDictionary.end())
+		if (dictionaryVertexIndex == MeshTranslator::IdxRemapTable::NotInDictionary)
 		{
 			int currentDictionaryVertexIndex = static_cast<int>(outMeshDictionary.vertexCoords.size());
 
@@ -122,91 +145,81 @@ void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithVertexCoords(
 			vertex.x = vertices[rawVertexDataOffset];
 			vertex.y = vertices[rawVertexDataOffset + 1];
 			vertex.z = vertices[rawVertexDataOffset + 2];
-			outMeshDictionary.vertexCoordsIndicesGlobalToDictionary[globalVertexIndex] = currentDictionaryVertexIndex;
+			vertexRemapTable.Set(globalVertexIndex, currentDictionaryVertexIndex);
 			outMeshDictionary.vertexCoordsIndices.push_back(currentDictionaryVertexIndex); // <= write indices of triangles in mesh into output triangle indices array
 			outMeshDictionary.vertexCoords.push_back(vertex);
 		}
 		else
 		{
 			// write indices of triangles in mesh into output triangle indices array
-			outMeshDictionary.vertexCoordsIndices.push_back(it->second);
+			outMeshDictionary.vertexCoordsIndices.push_back(dictionaryVertexIndex);
 		}
 	}
 }
 
-void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithNormals(
-	MItMeshPolygon& meshPolygonIterator,
+void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithNormalsAndUV(
 	const MeshTranslator::MeshPolygonData& meshPolygonData,
+	const MeshTranslator::FaceVertexIds& faceVertexIds,
+	unsigned int polygonIdx,
 	const MIntArray& globalVertexIndicesFromTrianglesList,
 	const std::map<int, int>& vertexIdxGlobalToLocal,
+	MeshTranslator::MeshIdxRemapTables& remapTables,
 	MeshTranslator::MeshIdxDictionary& outMeshDictionary)
 {
-	// write indices of normals of vertices (parallel to triangle vertices) into output array
+	const int NotInDictionary = MeshTranslator::IdxRemapTable::NotInDictionary;
+
+	// up to 2 UV channels is supported
+	unsigned int uvSetCount = meshPolygonData.uvSetNames.length();
 
+	// write indices of normals and uvs of vertices (parallel to triangle vertices) into output arrays
 	const float* normals = meshPolygonData.GetNormals();
 	for (unsigned int idx = 0; idx < globalVertexIndicesFromTrianglesList.length(); ++idx)
 	{
-		auto localNormalIdxIt = vertexIdxGlobalToLocal.find(globalVertexIndicesFromTrianglesList[idx]);
-		assert(localNormalIdxIt != vertexIdxGlobalToLocal.end());
+		auto localIdxIt = vertexIdxGlobalToLocal.find(globalVertexIndicesFromTrianglesList[idx]);
+		assert(localIdxIt != vertexIdxGlobalToLocal.end());
 
-		int globalNormalIdx = meshPolygonIterator.normalIndex(localNormalIdxIt->second);
-		std::unordered_map<int, int>::iterator normal_it = outMeshDictionary.normalCoordIdxGlobal2Local.find(globalNormalIdx);
+		unsigned int localIdx = localIdxIt->second;
 
-		if (normal_it == outMeshDictionary.normalCoordIdxGlobal2Local.end())
+		int globalNormalIdx = faceVertexIds.GetNormalId(polygonIdx, localIdx);
+		int localNormalIdx = remapTables.normals.Get(globalNormalIdx);
+
+		if (localNormalIdx == NotInDictionary)
 		{
 			Float3 normal;
 			normal.x = normals[globalNormalIdx * 3];
 			normal.y = normals[globalNormalIdx * 3 + 1];
 			normal.z = normals[globalNormalIdx * 3 + 2];
-			outMeshDictionary.normalCoordIdxGlobal2Local[globalNormalIdx] = (int)(outMeshDictionary.normalCoords.size());
+			localNormalIdx = (int)(outMeshDictionary.normalCoords.size());
+			remapTables.normals.Set(globalNormalIdx, localNormalIdx);
 			outMeshDictionary.normalCoords.push_back(normal);
 		}
 
-		outMeshDictionary.normalIndices.push_back(outMeshDictionary.normalCoordIdxGlobal2Local[globalNormalIdx]);
-	}
-}
-
-void FireMaya::MultipleShaderMeshTranslator::FillDictionaryWithUV(
-	MItMeshPolygon& meshPolygonIterator,
-	const MeshTranslator::MeshPolygonData& meshPolygonData,
-	const MIntArray& globalVertexIndicesFromTrianglesList,
-	const std::map<int, int>& vertexIdxGlobalToLocal,
-	MeshTranslator::MeshIdxDictionary& outMeshDictionary)
-{
-	// up to 2 UV channels is supported
-	unsigned int uvSetCount = meshPolygonData.uvSetNames.length();
+		outMeshDictionary.normalIndices.push_back(localNormalIdx);
 
-	for (unsigned int currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
-	{
-		// write indices 
-		for (unsigned int idx = 0; idx < globalVertexIndicesFromTrianglesList.length(); ++idx)
+		for (unsigned int currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
 		{
-			auto localUVIdxIt = vertexIdxGlobalToLocal.find(globalVertexIndicesFromTrianglesList[idx]);
-			assert(localUVIdxIt != vertexIdxGlobalToLocal.end());
-
-			int uvIdx = 0;
-			MString name = meshPolygonData.uvSetNames[currentChannelUV];
-			MStatus status = meshPolygonIterator.getUVIndex(localUVIdxIt->second, uvIdx, &name);
+			int uvIdx = faceVertexIds.GetUVId(currentChannelUV, polygonIdx, localIdx);
 
-			if (status != MStatus::kSuccess)
+			if (uvIdx == MeshTranslator::FaceVertexIds::UnassignedUV)
 			{
 				// in case if uv coordinate not assigned to polygon set it index to 0
 				outMeshDictionary.uvIndices[currentChannelUV].push_back(0);
 				continue;
 			}
 
-			auto uv_it = outMeshDictionary.uvCoordIdxGlobal2Local[currentChannelUV].find(uvIdx);
+			int localUVIdx = remapTables.uvs[currentChannelUV].Get(uvIdx);
 
-			if (uv_it == outMeshDictionary.uvCoordIdxGlobal2Local[currentChannelUV].end())
+			if (localUVIdx == NotInDictionary)
 			{
 				Float2 uv;
 				uv.x = meshPolygonData.puvCoords[currentChannelUV][uvIdx * 2];
 				uv.y = meshPolygonData.puvCoords[currentChannelUV][uvIdx * 2 + 1];
-				outMeshDictionary.uvCoordIdxGlobal2Local[currentChannelUV][uvIdx] = (int)(outMeshDictionary.uvSubmeshCoords[currentChannelUV].size());
+				localUVIdx = (int)(outMeshDictionary.uvSubmeshCoords[currentChannelUV].size());
+				remapTables.uvs[currentChannelUV].Set(uvIdx, localUVIdx);
 				outMeshDictionary.uvSubmeshCoords[currentChannelUV].push_back(uv);
 			}
 
-			outMeshDictionary.uvIndices[currentChannelUV].push_back(outMeshDictionary.uvCoordIdxGlobal2Local[currentChannelUV][uvIdx]);
+			outMeshDictionary.uvIndices[currentChannelUV].push_back(localUVIdx);
 		}
 	}
 }
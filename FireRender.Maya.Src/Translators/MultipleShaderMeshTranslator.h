@@ -34,6 +34,8 @@ namespace FireMaya
 		static void AddPolygonMultipleShader(
 			MItMeshPolygon& meshPolygonIterator,
 			const MeshTranslator::MeshPolygonData& meshPolygonData,
+			const MeshTranslator::FaceVertexIds& faceVertexIds,
+			MeshTranslator::MeshIdxRemapTables& remapTables,
 			MeshTranslator::MeshIdxDictionary& meshIdxDictionary
 		);
 
@@ -46,22 +48,18 @@ namespace FireMaya
 		static void FillDictionaryWithVertexCoords(
 			const MeshTranslator::MeshPolygonData& meshPolygonData,
 			const MIntArray& indicesInPolygon,
+			MeshTranslator::IdxRemapTable& vertexRemapTable,
 			MeshTranslator::MeshIdxDictionary& outMeshDictionary
 		);
 
-		static void FillDictionaryWithNormals(
-			MItMeshPolygon& meshPolygonIterator,
-			const MeshTranslator::MeshPolygonData& meshPolygonData,
-			const MIntArray& globalVertexIndicesFromTrianglesList,
-			const std::map<int, int>& vertexIdxGlobalToLocal,
-			MeshTranslator::MeshIdxDictionary& outMeshDictionary
-		);
-
-		static void FillDictionaryWithUV(
-			MItMeshPolygon& meshPolygonIterator,
+		// normals and all uv sets are remapped in one pass through triangle vertices
+		static void FillDictionaryWithNormalsAndUV(
 			const MeshTranslator::MeshPolygonData& meshPolygonData,
+			const MeshTranslator::FaceVertexIds& faceVertexIds,
+			unsigned int polygonIdx,
 			const MIntArray& globalVertexIndicesFromTrianglesList,
 			const std::map<int, int>& vertexIdxGlobalToLocal,
+			MeshTranslator::MeshIdxRemapTables& remapTables,
 			MeshTranslator::MeshIdxDictionary& outMeshDictionary
 		);
 
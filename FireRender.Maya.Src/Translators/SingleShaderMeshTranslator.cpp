@@ -18,45 +18,41 @@ void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 	frw::Shape& outShape,
 	MeshTranslator::MeshPolygonData& meshData,
 	const MIntArray& faceMaterialIndices,
-	std::vector<int>& outFaceMaterialIndices)
+	std::vector<int>& outFaceMaterialIndices,
+	MeshTranslator::TopologyCache* outTopologyCache)
 {
+	unsigned int uvSetCount = meshData.uvSetNames.length();
+
+	MColorArray vtxColors;
+	const_cast<MFnMesh&>(fnMesh).getVertexColors(vtxColors);
+	unsigned int countVtxColors = vtxColors.length();
+
+	// index buffers are taken from per thread staging arena instead of being allocated for each mesh
+	MeshTranslator::StagingArena& arena = MeshTranslator::GetStagingArena();
+	arena.Reset(meshData.triangleVertexIndicesCount, uvSetCount, countVtxColors);
+	arena.faceVertexIds.Read(fnMesh, meshData.uvSetNames);
+
 	// output indices of vertexes (3 indices for each triangle, 4 for quads)
-	std::vector<int> faceVertexIndices;
-	faceVertexIndices.reserve(meshData.triangleVertexIndicesCount);
+	std::vector<int>& faceVertexIndices = arena.faceVertexIndices;
 
 	// output indices of normals (3 indices for each triangle, 4 for quads)
-	std::vector<int> faceNormalIndices;
-	faceNormalIndices.reserve(meshData.triangleVertexIndicesCount);
+	std::vector<int>& faceNormalIndices = arena.faceNormalIndices;
 
 	// output indices of UV coordinates (3 indices for each triangle, 4 for quads)
 	// up to 2 UV channels is supported, thus vector of vectors
-	std::vector<std::vector<int>> uvIndices;
-	unsigned int uvSetCount = meshData.uvSetNames.length();
-	uvIndices.reserve(uvSetCount);
-	for (unsigned int currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
-	{
-		uvIndices.emplace_back(); // create vector for uv indices
-		uvIndices[currentChannelUV].reserve(meshData.triangleVertexIndicesCount);
-	}
-
-	MColorArray vtxColors;
-	const_cast<MFnMesh&>(fnMesh).getVertexColors(vtxColors);
-	unsigned int countVtxColors = vtxColors.length();
+	std::vector<std::vector<int>>& uvIndices = arena.uvIndices;
 
-	std::vector<MColor> vertexColors;
-	vertexColors.resize(countVtxColors);
-	std::vector<int> colorVertexIndices;
-	colorVertexIndices.resize(countVtxColors);
+	std::vector<MColor>& vertexColors = arena.vertexColors;
+	std::vector<int>& colorVertexIndices = arena.colorVertexIndices;
 
-	std::vector<int> numFaceVertices;
-	numFaceVertices.reserve(faceVertexIndices.size() / 3); // in case all faces are triangles
+	std::vector<int>& numFaceVertices = arena.numFaceVertices;
 
 	// iterate through mesh
 
 #ifdef OPTIMIZATION_CLOCK
 	std::chrono::steady_clock::time_point start_AddPolygon = std::chrono::steady_clock::now();
 #endif
-	MeshIndicesData data(faceVertexIndices, faceNormalIndices, uvIndices, vertexColors, colorVertexIndices, numFaceVertices);
+	MeshIndicesData data(faceVertexIndices, faceNormalIndices, uvIndices, vertexColors, colorVertexIndices, numFaceVertices, arena.ngonPolygons, arena.faceVertexIds);
 	for (auto it = MItMeshPolygon(fnMesh.object()); !it.isDone(); it.next())
 	{
 #ifdef OPTIMIZATION_CLOCK
@@ -64,7 +60,6 @@ void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 #endif
 		AddPolygonSingleShader(
 			it, 
-			meshData.uvSetNames, 
 			data, 
 			faceMaterialIndices,
 			outFaceMaterialIndices
@@ -130,7 +125,25 @@ void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 		outShape.SetVertexColors(colorVertexIndices, vertexColors, (rpr_int) meshData.countVertices);
 	}
 
+	// non convex polygons are triangulated by Maya depending on vertex positions, so their topology can't be reused
+	if ((outTopologyCache != nullptr) && !data.hasNonConvexPolygons)
+	{
+		outTopologyCache->countVertices = meshData.countVertices;
+		outTopologyCache->faceVertexIndices = faceVertexIndices;
+		outTopologyCache->faceNormalIndices = faceNormalIndices;
+		outTopologyCache->uvIndices.assign(uvIndices.begin(), uvIndices.begin() + uvSetCount);
+		outTopologyCache->uvCoords.swap(meshData.uvCoords);
+		outTopologyCache->uvCoords.resize(uvSetCount);
+		outTopologyCache->numFaceVertices = numFaceVertices;
+		outTopologyCache->vertexColors = vertexColors;
+		outTopologyCache->colorVertexIndices = colorVertexIndices;
+		outTopologyCache->faceMaterialIndices = outFaceMaterialIndices;
+		outTopologyCache->ngonPolygons = data.ngonPolygons;
+	}
+
+	// RPR keeps its own copy of the geometry, plugin side data isn't needed anymore
 	meshData.clear();
+	arena.Release();
 
 #ifdef OPTIMIZATION_CLOCK
 	std::chrono::steady_clock::time_point fin = std::chrono::steady_clock::now();
@@ -140,9 +153,8 @@ void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 }
 
 void FireMaya::SingleShaderMeshTranslator::ProcessIndexesSimplified(
-	MItMeshPolygon& meshPolygonIterator,
-	const MStringArray& uvSetNames,
 	MeshIndicesData& idxData,
+	unsigned int polygonIdx,
 	unsigned int localIdx,
 	MIntArray& vertices,
 	MColorArray& polygonColors
@@ -152,7 +164,7 @@ void FireMaya::SingleShaderMeshTranslator::ProcessIndexesSimplified(
 	idxData.triangleVertexIndices.push_back(vertices[localIdx]);
 
 	// normal indices
-	idxData.normalIndices.push_back(meshPolygonIterator.normalIndex(localIdx));
+	idxData.normalIndices.push_back(idxData.faceVertexIds.GetNormalId(polygonIdx, localIdx));
 
 	// vertex colors
 	if (polygonColors.length() > 0)
@@ -162,28 +174,18 @@ void FireMaya::SingleShaderMeshTranslator::ProcessIndexesSimplified(
 	}
 
 	// uv coordinates
-	unsigned int uvSetCount = uvSetNames.length();
-	for (unsigned int currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
+	size_t uvSetCount = idxData.uvIndices.size();
+	for (size_t currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
 	{
-		const MString& name = uvSetNames[currentChannelUV];
-		int uvIndex = 0;
-		MStatus status = meshPolygonIterator.getUVIndex(localIdx, uvIndex, &name);
+		int uvIndex = idxData.faceVertexIds.GetUVId((unsigned int) currentChannelUV, polygonIdx, localIdx);
 
-		if (status == MStatus::kSuccess)
-		{
-			idxData.uvIndices[currentChannelUV].push_back(uvIndex);
-		}
-		else
-		{
-			// in case if uv coordinate not assigned to polygon set it index to 0
-			idxData.uvIndices[currentChannelUV].push_back(0);
-		}
+		// in case if uv coordinate not assigned to polygon set it index to 0
+		idxData.uvIndices[currentChannelUV].push_back(uvIndex != MeshTranslator::FaceVertexIds::UnassignedUV ? uvIndex : 0);
 	}
 }
 
 void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 	MItMeshPolygon& meshPolygonIterator,
-	const MStringArray& uvSetNames,
 	MeshIndicesData& idxData,
 	const MIntArray& faceMaterialIndices,
 	std::vector<int>& outFaceMaterialIndices)
@@ -218,7 +220,7 @@ void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 
 		for (unsigned int vtxIdx = 0; vtxIdx < 4; ++vtxIdx)
 		{
-			ProcessIndexesSimplified(meshPolygonIterator, uvSetNames, idxData, vtxIdx, vertices, polygonColors);
+			ProcessIndexesSimplified(idxData, iteratorIdx, vtxIdx, vertices, polygonColors);
 		}
 
 		outFaceMaterialIndices.push_back(shaderId);
@@ -229,6 +231,8 @@ void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 	// polygon isConvex => don't need to get local indices from Maya
 	if (!meshPolygonIterator.isConvex())
 	{
+		idxData.hasNonConvexPolygons = true;
+
 		// get indices of vertices of triangles of current polygon
 		// - these are indices of verts in triangles!
 		MIntArray trianglesVertexList;
@@ -272,13 +276,16 @@ void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 			}
 		}
 
-		FillNormalsIndices(trianglesVertexList, vertexIndexGlobalToLocal, meshPolygonIterator, idxData.normalIndices);
-
-		FillIndicesUV(trianglesVertexList, vertexIndexGlobalToLocal, uvSetNames, meshPolygonIterator, idxData.uvIndices);
+		FillNormalAndUVIndices(trianglesVertexList, vertexIndexGlobalToLocal, iteratorIdx, idxData);
 	}
 	else
 	{
 		// don't need table for convex polygons
+		if (vertices.length() > 4)
+		{
+			idxData.ngonPolygons.push_back(iteratorIdx);
+		}
+
 		unsigned int countTriangles = vertices.length() - 2;
 		for (unsigned triangleIdx = 0; triangleIdx < countTriangles; ++triangleIdx)
 		{
@@ -288,7 +295,7 @@ void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 
 			for (unsigned localIdx : localIndices)
 			{
-				ProcessIndexesSimplified(meshPolygonIterator, uvSetNames, idxData, localIdx, vertices, polygonColors);
+				ProcessIndexesSimplified(idxData, iteratorIdx, localIdx, vertices, polygonColors);
 			}
 
 			outFaceMaterialIndices.push_back(shaderId);
@@ -303,72 +310,31 @@ void FireMaya::SingleShaderMeshTranslator::AddPolygonSingleShader(
 #endif
 }
 
-void FireMaya::SingleShaderMeshTranslator::FillIndicesUV(
-	const MIntArray& vertexList,
+void FireMaya::SingleShaderMeshTranslator::FillNormalAndUVIndices(
+	const MIntArray& trianglesVertexList,
 	const std::map<int, int>& vertexIdxGlobalToLocal,
-	const MStringArray& uvSetNames,
-	MItMeshPolygon& meshPolygonIterator,
-	std::vector<std::vector<int>>& outIndicesUV)
+	unsigned int polygonIdx,
+	MeshIndicesData& idxData)
 {
-	// up to 2 UV channels is supported
-	for (unsigned int currentChannelUV = 0; currentChannelUV < uvSetNames.length(); ++currentChannelUV)
+	size_t uvSetCount = idxData.uvIndices.size();
+
+	// write indices of normals and uvs of vertices (parallel to triangle vertices) into output arrays
+	for (unsigned int idx = 0; idx < trianglesVertexList.length(); ++idx)
 	{
-		// write indices 
-		for (unsigned int idx = 0; idx < vertexList.length(); ++idx)
-		{
-			int uvIndex = 0;
-			int globalVertexIndex = vertexList[idx];
+		auto it = vertexIdxGlobalToLocal.find(trianglesVertexList[idx]);
+		assert(it != vertexIdxGlobalToLocal.end());
 
-			auto it = vertexIdxGlobalToLocal.find(globalVertexIndex);
-			assert(it != vertexIdxGlobalToLocal.end());
+		unsigned int localIdx = it->second;
 
-			const MString& name = uvSetNames[currentChannelUV];
+		idxData.normalIndices.push_back(idxData.faceVertexIds.GetNormalId(polygonIdx, localIdx));
 
-#ifdef OPTIMIZATION_CLOCK
-			std::chrono::steady_clock::time_point start_3GetData = std::chrono::steady_clock::now();
-#endif
-			MStatus status = meshPolygonIterator.getUVIndex(it->second, uvIndex, &name);
-#ifdef OPTIMIZATION_CLOCK
-			std::chrono::steady_clock::time_point fin_3GetData = std::chrono::steady_clock::now();
-			std::chrono::nanoseconds elapsed_3GetData = std::chrono::duration_cast<std::chrono::nanoseconds>(fin_3GetData - start_3GetData);
-			FireRenderContext::timeGetDataFromMaya += elapsed_3GetData.count();
-#endif
+		// up to 2 UV channels is supported
+		for (size_t currentChannelUV = 0; currentChannelUV < uvSetCount; ++currentChannelUV)
+		{
+			int uvIndex = idxData.faceVertexIds.GetUVId((unsigned int) currentChannelUV, polygonIdx, localIdx);
 
-			if (status == MStatus::kSuccess)
-			{
-				outIndicesUV[currentChannelUV].push_back(uvIndex);
-			}
-			else
-			{
-				// in case if uv coordinate not assigned to polygon set it index to 0
-				outIndicesUV[currentChannelUV].push_back(0);
-			}
+			// in case if uv coordinate not assigned to polygon set it index to 0
+			idxData.uvIndices[currentChannelUV].push_back(uvIndex != MeshTranslator::FaceVertexIds::UnassignedUV ? uvIndex : 0);
 		}
 	}
 }
-
-void FireMaya::SingleShaderMeshTranslator::FillNormalsIndices(
-	const MIntArray& trianglesVertexList,
-	const std::map<int, int>& vertexIdxGlobalToLocal,
-	MItMeshPolygon& meshPolygonIterator,
-	std::vector<int>& outNormalIndices)
-{
-	// write indices of normals of vertices (parallel to triangle vertices) into output array
-	for (unsigned int globalVertexIndex = 0; globalVertexIndex < trianglesVertexList.length(); ++globalVertexIndex)
-	{
-		auto it = vertexIdxGlobalToLocal.find(trianglesVertexList[globalVertexIndex]);
-		assert(it != vertexIdxGlobalToLocal.end());
-
-#ifdef OPTIMIZATION_CLOCK
-		std::chrono::steady_clock::time_point start_2GetData = std::chrono::steady_clock::now();
-#endif
-		unsigned int normalIndex = meshPolygonIterator.normalIndex(it->second);
-#ifdef OPTIMIZATION_CLOCK
-		std::chrono::steady_clock::time_point fin_2GetData = std::chrono::steady_clock::now();
-		std::chrono::nanoseconds elapsed_2GetData = std::chrono::duration_cast<std::chrono::nanoseconds>(fin_2GetData - start_2GetData);
-		FireRenderContext::timeGetDataFromMaya += elapsed_2GetData.count();
-#endif
-
-		outNormalIndices.push_back(normalIndex);
-	}
-}
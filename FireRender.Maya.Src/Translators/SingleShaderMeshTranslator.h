@@ -26,7 +26,8 @@ namespace FireMaya
 			frw::Shape& outShape,
 			MeshTranslator::MeshPolygonData& meshPolygonData,
 			const MIntArray& faceMaterialIndices,
-			std::vector<int>& outFaceMaterialIndices
+			std::vector<int>& outFaceMaterialIndices,
+			MeshTranslator::TopologyCache* outTopologyCache = nullptr
 		);
 
 	private:
@@ -38,6 +39,9 @@ namespace FireMaya
 			std::vector<MColor>& vertexColors;
 			std::vector<int>& colorVertexIndices;
 			std::vector<int>& numFaceVertices;
+			std::vector<int>& ngonPolygons;
+			const MeshTranslator::FaceVertexIds& faceVertexIds;
+			bool hasNonConvexPolygons;
 
 			MeshIndicesData(
 				std::vector<int>& _triangleVertexIndices,
@@ -45,43 +49,39 @@ namespace FireMaya
 				std::vector<std::vector<int>>& _uvIndices,
 				std::vector<MColor>& _vertexColors,
 				std::vector<int>& _colorVertexIndices,
-				std::vector<int>& _numFaceVertices)
+				std::vector<int>& _numFaceVertices,
+				std::vector<int>& _ngonPolygons,
+				const MeshTranslator::FaceVertexIds& _faceVertexIds)
 				: triangleVertexIndices(_triangleVertexIndices)
 				, normalIndices(_normalIndices)
 				, uvIndices(_uvIndices)
 				, vertexColors(_vertexColors)
 				, colorVertexIndices(_colorVertexIndices)
 				, numFaceVertices(_numFaceVertices)
+				, ngonPolygons(_ngonPolygons)
+				, faceVertexIds(_faceVertexIds)
+				, hasNonConvexPolygons(false)
 			{};
 		};
 
 		static void AddPolygonSingleShader(
 			MItMeshPolygon& meshPolygonIterator,
-			const MStringArray& uvSetNames,
 			MeshIndicesData& idxData,
 			const MIntArray& faceMaterialIndices,
 			std::vector<int>& outFaceMaterialIndices
 		);
 
-		static void FillIndicesUV(
-			const MIntArray& vertexList,
-			const std::map<int, int>& vertexIdxGlobalToLocal,
-			const MStringArray& uvSetNames,
-			MItMeshPolygon& meshPolygonIterator,
-			std::vector<std::vector<int>>& uvIndices
-		);
-
-		static void FillNormalsIndices(
+		// writes normal and uv indices (all uv sets in one pass) of triangulated polygon
+		static void FillNormalAndUVIndices(
 			const MIntArray& vertexList,
 			const std::map<int, int>& vertexIdxGlobalToLocal,
-			MItMeshPolygon& meshPolygonIterator,
-			std::vector<int>& normalIndices
+			unsigned int polygonIdx,
+			MeshIndicesData& idxData
 		);
 
 		static void ProcessIndexesSimplified(
-			MItMeshPolygon& meshPolygonIterator,
-			const MStringArray& uvSetNames,
 			MeshIndicesData& idxData,
+			unsigned int polygonIdx,
 			unsigned int localIdx,
 			MIntArray& vertices,
 			MColorArray& polygonColors
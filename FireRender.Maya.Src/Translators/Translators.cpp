@@ -641,7 +641,7 @@ namespace FireMaya
 
 			if (areaLightData.areaLightShape != PLAMesh)
 			{
-				frlight.areaLight = PhysicalLightGeometryUtility::CreateShapeForAreaLight(areaLightData.areaLightShape, frcontext);
+				frlight.areaLight = PhysicalLightGeometryUtility::CreateShapeInstanceForAreaLight(areaLightData.areaLightShape, scope);
 				calculatedArea = PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(areaLightData.areaLightShape, transformMatrix);
 			}
 			else
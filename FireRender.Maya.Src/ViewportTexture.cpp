@@ -1,11 +1,172 @@
 #include <maya/MTextureManager.h>
 #include <maya/MRenderView.h>
 #include <assert.h>
+#include <string.h>
+
+// F16C conversion is compiled for every x64 build and chosen at run time
+#if defined(_M_X64) || defined(__x86_64__)
+#define VIEWPORT_TEXTURE_F16C 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define F16C_TARGET
+#else
+#include <cpuid.h>
+#define F16C_TARGET __attribute__((target("avx,f16c")))
+#endif
+#endif
 
 #include "ViewportTexture.h"
+#include "Logger.h"
+
+namespace
+{
+	const unsigned int numComponents = 4;
+
+	// Round to nearest even, overflow goes to infinity
+	inline uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t exponent = (bits >> 23) & 0xff;
+		uint32_t mantissa = bits & 0x7fffff;
+
+		// infinity or NaN
+		if (exponent == 0xff)
+		{
+			return (uint16_t) (sign | 0x7c00 | (mantissa ? 0x200 : 0));
+		}
+
+		int halfExponent = (int) exponent - 127 + 15;
+
+		if (halfExponent >= 0x1f)
+		{
+			return (uint16_t) (sign | 0x7c00);
+		}
+
+		// denormalized half
+		if (halfExponent <= 0)
+		{
+			if (halfExponent < -10)
+			{
+				return (uint16_t) sign;
+			}
+
+			mantissa |= 0x800000;
+
+			uint32_t shift = 14 - halfExponent;
+			uint32_t half = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t halfway = 1u << (shift - 1);
+
+			if (remainder > halfway || (remainder == halfway && (half & 1)))
+			{
+				half++;
+			}
+
+			return (uint16_t) (sign | half);
+		}
+
+		uint32_t half = ((uint32_t) halfExponent << 10) | (mantissa >> 13);
+		uint32_t remainder = mantissa & 0x1fff;
+
+		// carry into the exponent is correct here
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			half++;
+		}
+
+		return (uint16_t) (sign | half);
+	}
+
+#ifdef VIEWPORT_TEXTURE_F16C
+	bool IsF16CSupported()
+	{
+		const unsigned int osxsaveBit = 1u << 27;
+		const unsigned int avxBit = 1u << 28;
+		const unsigned int f16cBit = 1u << 29;
+		const unsigned int required = osxsaveBit | avxBit | f16cBit;
+
+		unsigned int ecx = 0;
+		unsigned long long xcr0 = 0;
+
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		ecx = (unsigned int) info[2];
+
+		if ((ecx & required) != required)
+		{
+			return false;
+		}
 
+		xcr0 = _xgetbv(0);
+#else
+		unsigned int eax, ebx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & required) != required)
+		{
+			return false;
+		}
 
-ViewportTexture::ViewportTexture() : m_texture(nullptr)
+		unsigned int xcr0Low, xcr0High;
+		__asm__ ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+		xcr0 = ((unsigned long long) xcr0High << 32) | xcr0Low;
+#endif
+
+		// the OS has to preserve the xmm and ymm registers
+		return (xcr0 & 0x6) == 0x6;
+	}
+
+	// Converts whole groups of 8 values; returns how many were converted
+	F16C_TARGET size_t ConvertFloatToHalfF16C(const float* src, uint16_t* dst, size_t count)
+	{
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 values = _mm256_loadu_ps(src + i);
+			__m128i halfs = _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), halfs);
+		}
+
+		_mm256_zeroupper();
+
+		return i;
+	}
+#endif
+
+	void ConvertFloatToHalf(const float* src, uint16_t* dst, size_t count)
+	{
+		size_t i = 0;
+
+#ifdef VIEWPORT_TEXTURE_F16C
+		static const bool f16cSupported = IsF16CSupported();
+
+		if (f16cSupported)
+		{
+			i = ConvertFloatToHalfF16C(src, dst, count);
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			dst[i] = FloatToHalf(src[i]);
+		}
+	}
+}
+
+ViewportTexture::ViewportTexture() :
+	m_texture(nullptr),
+	m_width(0),
+	m_height(0),
+	m_halfFloat(false),
+	m_halfFloatRequested(false),
+	m_uploadStats(false),
+	m_uploadedBytes(0),
+	m_uploadCount(0),
+	m_statsStart(std::chrono::steady_clock::now())
 {
 
 }
@@ -15,14 +176,123 @@ ViewportTexture::~ViewportTexture()
 	Release();
 }
 
-MStatus ViewportTexture::UpdateTexture(float* externalData /* = nullptr*/)
+MStatus ViewportTexture::UpdateTexture(const float* externalData /* = nullptr*/)
 {
-	if (m_texture != nullptr)
+	if (m_texture == nullptr)
+	{
+		return MStatus::kFailure;
+	}
+
+	const float* pixels = externalData ? externalData : m_pixels.data();
+
+	if (!m_halfFloat)
 	{
-		return m_texture->update(externalData ? externalData : m_pixels.data(), false);
+		AddUploadStats(m_pixels.size() * sizeof(float));
+
+		return m_texture->update(pixels, false);
 	}
 
-	return MStatus::kFailure;
+	unsigned int firstChangedRow = 0;
+	unsigned int lastChangedRow = 0;
+
+	if (!ConvertToHalf(pixels, firstChangedRow, lastChangedRow))
+	{
+		return MStatus::kSuccess;
+	}
+
+	// upload only the rows that were changed
+	unsigned int rowPitch = m_width * numComponents * sizeof(uint16_t);
+
+	MHWRender::MTextureUpdateRegion region;
+	region.fXRangeMin = 0;
+	region.fXRangeMax = m_width;
+	region.fYRangeMin = firstChangedRow;
+	region.fYRangeMax = lastChangedRow + 1;
+	region.fZRangeMin = 0;
+	region.fZRangeMax = 1;
+
+	AddUploadStats((size_t) rowPitch * (lastChangedRow - firstChangedRow + 1));
+
+	return m_texture->update(m_halfPixels.data() + (size_t) firstChangedRow * m_width * numComponents, false, rowPitch, &region);
+}
+
+bool ViewportTexture::ConvertToHalf(const float* pixels, unsigned int& firstChangedRow, unsigned int& lastChangedRow)
+{
+	const size_t rowSize = (size_t) m_width * numComponents;
+
+	assert(m_halfRow.size() == rowSize);
+
+	uint16_t* row = m_halfRow.data();
+
+	bool changed = false;
+
+	for (unsigned int y = 0; y < m_height; y++)
+	{
+		uint16_t* dst = m_halfPixels.data() + y * rowSize;
+
+		ConvertFloatToHalf(pixels + y * rowSize, row, rowSize);
+
+		if (memcmp(dst, row, rowSize * sizeof(uint16_t)) == 0)
+		{
+			continue;
+		}
+
+		memcpy(dst, row, rowSize * sizeof(uint16_t));
+
+		if (!changed)
+		{
+			firstChangedRow = y;
+			changed = true;
+		}
+
+		lastChangedRow = y;
+	}
+
+	return changed;
+}
+
+void ViewportTexture::SetUploadStats(bool uploadStats)
+{
+	if (uploadStats && !m_uploadStats)
+	{
+		m_uploadedBytes = 0;
+		m_uploadCount = 0;
+		m_statsStart = std::chrono::steady_clock::now();
+	}
+
+	m_uploadStats = uploadStats;
+}
+
+void ViewportTexture::AddUploadStats(size_t uploadedBytes)
+{
+	const long long reportPeriodMs = 5000;
+
+	if (!m_uploadStats)
+	{
+		return;
+	}
+
+	m_uploadedBytes += uploadedBytes;
+	m_uploadCount++;
+
+	auto now = std::chrono::steady_clock::now();
+	long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_statsStart).count();
+
+	if (elapsedMs < reportPeriodMs)
+	{
+		return;
+	}
+
+	double seconds = elapsedMs / 1000.0;
+
+	LogPrint("Viewport texture upload: %.1f MB/s, %.1f updates/s (%s)",
+		m_uploadedBytes / (1024.0 * 1024.0) / seconds,
+		m_uploadCount / seconds,
+		m_halfFloat ? "half float" : "float");
+
+	m_uploadedBytes = 0;
+	m_uploadCount = 0;
+	m_statsStart = now;
 }
 
 void ViewportTexture::ClearPixels()
@@ -35,7 +305,6 @@ void ViewportTexture::ClearPixels()
 	zero.b = 0;
 	zero.a = 1;
 
-	const unsigned int numComponents = 4;
 	for (unsigned int i = 0; i < m_pixels.size(); i += numComponents)
 	{
 		memcpy(m_pixels.data() + i, &zero, sizeof(RV_PIXEL));
@@ -56,36 +325,60 @@ void ViewportTexture::Resize(unsigned int width, unsigned int height)
 
 	bool createNewTexture = m_texture == nullptr ||
 		texDescription.fWidth != width ||
-		texDescription.fHeight != height;
+		texDescription.fHeight != height ||
+		m_halfFloat != m_halfFloatRequested;
 
 	if (createNewTexture)
 	{
 		Release();
 
-		m_pixels.resize(width * height * 4);
+		m_width = width;
+		m_height = height;
+		m_halfFloat = m_halfFloatRequested;
+
+		m_pixels.resize(width * height * numComponents);
 		ClearPixels();
 
+		unsigned int componentSize = sizeof(float);
+		MHWRender::MRasterFormat format = MHWRender::MRasterFormat::kR32G32B32A32_FLOAT;
+		const void* initialData = m_pixels.data();
+
+		if (m_halfFloat)
+		{
+			m_halfPixels.resize(m_pixels.size());
+			m_halfRow.resize((size_t) width * numComponents);
+			ConvertFloatToHalf(m_pixels.data(), m_halfPixels.data(), m_pixels.size());
+
+			componentSize = sizeof(uint16_t);
+			format = MHWRender::MRasterFormat::kR16G16B16A16_FLOAT;
+			initialData = m_halfPixels.data();
+		}
+		else
+		{
+			m_halfPixels.clear();
+			m_halfPixels.shrink_to_fit();
+			m_halfRow.clear();
+			m_halfRow.shrink_to_fit();
+		}
+
 		/** The description of the texture that will receive the RPR frame buffer. */
 		MHWRender::MTextureDescription textureDesc;
 
-		textureDesc.setToDefault2DTexture();
-		textureDesc.fFormat = MHWRender::MRasterFormat::kR32G32B32A32_FLOAT;
-
 		// Update the texture description.
 		textureDesc.setToDefault2DTexture();
 		textureDesc.fWidth = width;
 		textureDesc.fHeight = height;
 		textureDesc.fDepth = 1;
-		textureDesc.fBytesPerRow = 4 * sizeof(float) * width;
+		textureDesc.fBytesPerRow = numComponents * componentSize * width;
 		textureDesc.fBytesPerSlice = textureDesc.fBytesPerRow * height;
-		textureDesc.fFormat = MHWRender::MRasterFormat::kR32G32B32A32_FLOAT;
+		textureDesc.fFormat = format;
 
 		// Create a new texture with the supplied data.
 		MRenderer* renderer = MRenderer::theRenderer();
 
 		MTextureManager* textureManager = renderer->getTextureManager();
 
-		m_texture = textureManager->acquireTexture("", textureDesc, m_pixels.data(), false);
+		m_texture = textureManager->acquireTexture("", textureDesc, initialData, false);
 	}
 }
 
@@ -101,7 +394,7 @@ void ViewportTexture::Release()
 	}
 }
 
-void ViewportTexture::SetPixelData(std::vector<float> vecData)
+void ViewportTexture::SetPixelData(std::vector<float>&& vecData)
 {
 	m_pixels = std::move(vecData);
 }
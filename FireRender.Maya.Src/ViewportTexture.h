@@ -2,6 +2,8 @@
 
 #include <maya/MShaderManager.h>
 #include <vector>
+#include <chrono>
+#include <cstdint>
 
 class ViewportTexture
 {
@@ -10,21 +12,47 @@ public:
 	~ViewportTexture();
 
 	// only from main thread
-	MStatus UpdateTexture(float* externalData = nullptr);
+	MStatus UpdateTexture(const float* externalData = nullptr);
 
 	void Resize(unsigned int width, unsigned int height);
 
 	void Release();
 
+	// Upload 16 bit float texture instead of 32 bit float one; applied on the next Resize
+	void SetHalfFloat(bool halfFloat) { m_halfFloatRequested = halfFloat; }
+
+	// Log upload bandwidth and update rate every few seconds
+	void SetUploadStats(bool uploadStats);
+
 	MTexture* GetTexture() const{ return m_texture; }
 
 	float* GetPixelData() { return m_pixels.data(); }
-	void SetPixelData(std::vector<float> vecData);
+	void SetPixelData(std::vector<float>&& vecData);
 
 private:
 	void ClearPixels();
 
+	// converts pixels to half floats; returns false if nothing changed since the last upload
+	bool ConvertToHalf(const float* pixels, unsigned int& firstChangedRow, unsigned int& lastChangedRow);
+
+	void AddUploadStats(size_t uploadedBytes);
+
 private:
 	MHWRender::MTexture* m_texture;
 	std::vector<float> m_pixels;
+
+	unsigned int m_width;
+	unsigned int m_height;
+
+	bool m_halfFloat;
+	bool m_halfFloatRequested;
+	std::vector<uint16_t> m_halfPixels;
+	// one converted row, compared with the uploaded one; sized on Resize
+	std::vector<uint16_t> m_halfRow;
+
+	// upload statistics
+	bool m_uploadStats;
+	size_t m_uploadedBytes;
+	unsigned int m_uploadCount;
+	std::chrono::steady_clock::time_point m_statsStart;
 };
@@ -27,6 +27,11 @@ limitations under the License.
 #include <set>
 #include <string>
 #include <array>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include <maya/MString.h>
 
 #include <math.h>
@@ -90,6 +95,11 @@ namespace frw
 	class FrameBuffer;
 	class PostEffect;
 
+	namespace NodePatch
+	{
+		struct Patch;
+	}
+
 	enum Operator
 	{
 		OperatorAdd = RPR_MATERIAL_NODE_OP_ADD,
@@ -693,6 +703,13 @@ namespace frw
 		/// do not use if you can avoid it (unsafe)
 		void _SetInputNode(rpr_material_node_input key, const Shader& shader);
 
+		/**
+			Copies constant inputs of another node graph onto this one, walking both graphs together.
+			Nothing is changed and false is returned if node types, connections, images or buffers differ.
+			The inputs written are returned in appliedPatches
+		*/
+		bool PatchValuesFrom(const Node& source, std::vector<NodePatch::Patch>* appliedPatches = nullptr);
+
 		int GetType() const
 		{
 			return data().type;
@@ -871,6 +888,7 @@ namespace frw
 		float GetX(double def = 0) const { return type == FLOAT ? x : float(def); }
 		float GetY(double def = 0) const { return type == FLOAT ? y : float(def); }
 		float GetZ(double def = 0) const { return type == FLOAT ? z : float(def); }
+		float GetW(double def = 0) const { return type == FLOAT ? w : float(def); }
 
 		// for combo-box value
 		int GetInt(int def = 0) const { return type == FLOAT ? (int)x : def; }
@@ -902,6 +920,9 @@ namespace frw
 	class DataBuffer : public Object
 	{
 		DECLARE_OBJECT_NO_DATA(DataBuffer, Object);
+		friend class Context;
+
+		explicit DataBuffer(DataPtr p) : Object(p) {}
 
 	public:
 		explicit DataBuffer(rpr_buffer h, const Context &context) : Object(h, context, true, new Data()) {}
@@ -928,6 +949,10 @@ namespace frw
 
 			// Used to determine if we can setup displacement or not
 			bool isUVCoordinatesSet = false;
+
+			// known at creation for meshes, queried once for instances; topology does not change after creation
+			size_t polygonCount = 0;
+			bool polygonCountValid = false;
 		};
 
 	public:
@@ -1181,6 +1206,30 @@ namespace frw
 		void SetSubdivisionBoundaryInterop(rpr_subdiv_boundary_interfop_type type);
 
 		bool IsAreaLight() { return data().isAreaLight; }
+
+		void SetPolygonCount(size_t polygonCount)
+		{
+			data().polygonCount = polygonCount;
+			data().polygonCountValid = true;
+		}
+
+		size_t GetPolygonCount() const
+		{
+			Data& d = data();
+			if (!d.polygonCountValid)
+			{
+				size_t polygonCount = 0;
+				if (rprMeshGetInfo(Handle(), RPR_MESH_POLYGON_COUNT, sizeof(polygonCount), &polygonCount, nullptr) != RPR_SUCCESS)
+				{
+					polygonCount = 0;
+				}
+
+				d.polygonCount = polygonCount;
+				d.polygonCountValid = true;
+			}
+
+			return d.polygonCount;
+		}
 		void SetAreaLightFlag(bool isAreaLight) { data().isAreaLight = isAreaLight; }
 
 		bool IsUVCoordinatesSet() const 
@@ -1243,22 +1292,24 @@ namespace frw
 		{
 			DECLARE_OBJECT_DATA
 		public:
-			virtual ~Data()
-			{
-				for (auto it = m_udimsMap.begin(); it != m_udimsMap.end(); ++it)
-				{
-					rprImageSetUDIM(Handle(), it->first, nullptr);
-				}
-
-				m_udimsMap.clear();
-			}
+			virtual ~Data();
 			
 			std::map<rpr_uint, Image> m_udimsMap;
+
+			// set when the image is counted in the context image statistics
+			bool tracked = false;
+			long long sizeBytes = 0;
 		};
 
+		// single point every image handle of the plugin passes through, keeps context image statistics
+		void AttachCreated(rpr_image h);
+
 
 	public:
-		explicit Image(rpr_image h, const Context& context) : Object(h, context, true, new Data()) {}
+		explicit Image(rpr_image h, const Context& context) : Object(nullptr, context, true, new Data())
+		{
+			AttachCreated(h);
+		}
 
 		Image(Context context, float r, float g, float b);
 		Image(Context context, const rpr_image_format& format, const rpr_image_desc& image_desc, const void* data);
@@ -1673,6 +1724,7 @@ namespace frw
 			int mAreaLightCount = 0;
 			int mShapeCount = 0;
 			int mLightCount = 0;
+			size_t mPolygonCount = 0;
 		};
 
 	public:
@@ -1690,6 +1742,7 @@ namespace frw
 			}
 
 			data().mShapeCount++;
+			data().mPolygonCount += v.GetPolygonCount();
 		}
 		void Attach(Light v)
 		{
@@ -1722,6 +1775,7 @@ namespace frw
 
 			if (v.IsAreaLight()) data().mAreaLightCount--;
 			data().mShapeCount--;
+			data().mPolygonCount -= v.GetPolygonCount();
 		}
 		void Detach(Volume v)
 		{
@@ -1767,6 +1821,7 @@ namespace frw
 			d.backgroundImage = Image();
 
 			data().mAreaLightCount = data().mLightCount = data().mShapeCount = 0;
+			data().mPolygonCount = 0;
 		}
 
 		int AreaLightCount() const
@@ -1789,6 +1844,12 @@ namespace frw
 			return data().mShapeCount;
 		}
 
+		// polygons of all attached shapes, maintained on attach/detach
+		size_t PolygonCount() const
+		{
+			return data().mPolygonCount;
+		}
+
 		void DetachShapes()
 		{
 			auto count = ShapeCount();
@@ -1804,6 +1865,7 @@ namespace frw
 			}
 
 			data().mShapeCount = 0;
+			data().mPolygonCount = 0;
 		}
 
 		std::list<Shape> GetShapes() const
@@ -1903,6 +1965,23 @@ namespace frw
 			: scene(nullptr)
 			{}
 			rpr_scene scene;		// scene handle; not frw::Scene to avoid circular references
+
+			// images created through frw::Image, images can be released from any thread
+			std::atomic<size_t> imageCount{ 0 };
+			std::atomic<long long> imageSizeBytes{ 0 };
+
+			// generated buffers (ramps, lookups) shared by content; entries expire with the last user
+			struct SharedBuffer
+			{
+				std::vector<float> values;
+				rpr_buffer_desc desc;
+				std::weak_ptr<Object::Data> buffer;
+			};
+
+			std::mutex sharedBuffersMutex;
+			std::unordered_multimap<size_t, SharedBuffer> sharedBuffers;
+			size_t sharedBuffersRequested = 0;
+			size_t sharedBuffersCreated = 0;
 		};
 
 	public:
@@ -2010,6 +2089,40 @@ namespace frw
 			return data().scene;
 		}
 
+		// count and size of images currently alive in this context, kept up to date by frw::Image
+		void AddImageStatistics(long long sizeBytes)
+		{
+			data().imageCount++;
+			data().imageSizeBytes += sizeBytes;
+		}
+
+		void RemoveImageStatistics(long long sizeBytes)
+		{
+			data().imageCount--;
+			data().imageSizeBytes -= sizeBytes;
+		}
+
+		size_t GetImageCount() const
+		{
+			return data().imageCount;
+		}
+
+		long long GetImagesSizeBytes() const
+		{
+			return data().imageSizeBytes;
+		}
+
+		// returns a buffer with the same content if one is still alive in this context, creates a new one otherwise
+		DataBuffer GetSharedDataBuffer(const rpr_buffer_desc& bufferDesc, const float* values);
+
+		void GetSharedDataBufferStatistics(size_t& requested, size_t& created) const
+		{
+			std::lock_guard<std::mutex> lock(data().sharedBuffersMutex);
+
+			requested = data().sharedBuffersRequested;
+			created = data().sharedBuffersCreated;
+		}
+
 		Camera CreateCamera()
 		{
 			FRW_PRINT_DEBUG("CreateCamera()");
@@ -3970,6 +4083,166 @@ namespace frw
 		return data().materialSystem.As<MaterialSystem>();
 	}
 
+	namespace NodePatch
+	{
+		struct Patch
+		{
+			rpr_material_node node;
+			rpr_material_node_input key;
+			NodeInputType type;
+			rpr_float value[4];
+			rpr_uint uintValue;
+		};
+
+		inline bool ReadInput(rpr_material_node node, size_t index, void* value, size_t size)
+		{
+			size_t valueSize = 0;
+			rpr_int res = rprMaterialNodeGetInputInfo(node, index, NodeInputInfoValue, 0, nullptr, &valueSize);
+			if (res != RPR_SUCCESS || valueSize != size)
+				return false;
+
+			return RPR_SUCCESS == rprMaterialNodeGetInputInfo(node, index, NodeInputInfoValue, size, value, nullptr);
+		}
+
+		inline bool SameInputData(rpr_material_node target, rpr_material_node source, size_t index)
+		{
+			size_t targetSize = 0;
+			size_t sourceSize = 0;
+			if (RPR_SUCCESS != rprMaterialNodeGetInputInfo(target, index, NodeInputInfoValue, 0, nullptr, &targetSize) ||
+				RPR_SUCCESS != rprMaterialNodeGetInputInfo(source, index, NodeInputInfoValue, 0, nullptr, &sourceSize) ||
+				targetSize != sourceSize)
+			{
+				return false;
+			}
+
+			std::vector<char> targetData(targetSize);
+			std::vector<char> sourceData(sourceSize);
+			return targetSize == 0 ||
+				(ReadInput(target, index, targetData.data(), targetSize) &&
+				 ReadInput(source, index, sourceData.data(), sourceSize) &&
+				 targetData == sourceData);
+		}
+
+		// collects value changes, returns false as soon as the graphs differ in anything else
+		inline bool Collect(rpr_material_node target, rpr_material_node source,
+			std::map<rpr_material_node, rpr_material_node>& visited, std::vector<Patch>& patches)
+		{
+			auto it = visited.find(target);
+			if (it != visited.end())
+				return it->second == source;
+
+			visited[target] = source;
+
+			rpr_material_node_type targetType = 0;
+			rpr_material_node_type sourceType = 0;
+			size_t targetCount = 0;
+			size_t sourceCount = 0;
+			if (RPR_SUCCESS != rprMaterialNodeGetInfo(target, NodeInfoType, sizeof(targetType), &targetType, nullptr) ||
+				RPR_SUCCESS != rprMaterialNodeGetInfo(source, NodeInfoType, sizeof(sourceType), &sourceType, nullptr) ||
+				RPR_SUCCESS != rprMaterialNodeGetInfo(target, NodeInfoInputCount, sizeof(targetCount), &targetCount, nullptr) ||
+				RPR_SUCCESS != rprMaterialNodeGetInfo(source, NodeInfoInputCount, sizeof(sourceCount), &sourceCount, nullptr) ||
+				targetType != sourceType || targetCount != sourceCount)
+			{
+				return false;
+			}
+
+			for (size_t index = 0; index < targetCount; index++)
+			{
+				rpr_material_node_input targetKey = 0;
+				rpr_material_node_input sourceKey = 0;
+				rpr_uint targetInputType = 0;
+				rpr_uint sourceInputType = 0;
+				if (RPR_SUCCESS != rprMaterialNodeGetInputInfo(target, index, NodeInputInfoId, sizeof(targetKey), &targetKey, nullptr) ||
+					RPR_SUCCESS != rprMaterialNodeGetInputInfo(source, index, NodeInputInfoId, sizeof(sourceKey), &sourceKey, nullptr) ||
+					RPR_SUCCESS != rprMaterialNodeGetInputInfo(target, index, NodeInputInfoType, sizeof(targetInputType), &targetInputType, nullptr) ||
+					RPR_SUCCESS != rprMaterialNodeGetInputInfo(source, index, NodeInputInfoType, sizeof(sourceInputType), &sourceInputType, nullptr) ||
+					targetKey != sourceKey || targetInputType != sourceInputType)
+				{
+					return false;
+				}
+
+				switch (targetInputType)
+				{
+				case NodeInputTypeFloat4:
+				{
+					Patch patch = { target, targetKey, NodeInputTypeFloat4 };
+					rpr_float current[4] = {};
+					if (!ReadInput(target, index, current, sizeof(current)) || !ReadInput(source, index, patch.value, sizeof(patch.value)))
+						return false;
+
+					if (memcmp(current, patch.value, sizeof(current)) != 0)
+						patches.push_back(patch);
+					break;
+				}
+
+				case NodeInputTypeUint:
+				{
+					rpr_uint current = 0;
+					rpr_uint value = 0;
+					if (!ReadInput(target, index, &current, sizeof(current)) || !ReadInput(source, index, &value, sizeof(value)))
+						return false;
+
+					if (current != value)
+					{
+						Patch patch = { target, targetKey, NodeInputTypeUint };
+						patch.uintValue = value;
+						patches.push_back(patch);
+					}
+					break;
+				}
+
+				case NodeInputTypeNode:
+				{
+					rpr_material_node targetInput = nullptr;
+					rpr_material_node sourceInput = nullptr;
+					if (!ReadInput(target, index, &targetInput, sizeof(targetInput)) || !ReadInput(source, index, &sourceInput, sizeof(sourceInput)))
+						return false;
+
+					if (!targetInput != !sourceInput)
+						return false;
+
+					if (targetInput && !Collect(targetInput, sourceInput, visited, patches))
+						return false;
+					break;
+				}
+
+				default:
+					// images, buffers and grids come from caches, so an unchanged input is the same handle
+					if (!SameInputData(target, source, index))
+						return false;
+					break;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	inline bool Node::PatchValuesFrom(const Node& source, std::vector<NodePatch::Patch>* appliedPatches)
+	{
+		if (!Handle() || !source.Handle())
+			return false;
+
+		std::map<rpr_material_node, rpr_material_node> visited;
+		std::vector<NodePatch::Patch> patches;
+
+		if (!NodePatch::Collect(Handle(), source.Handle(), visited, patches))
+			return false;
+
+		for (const NodePatch::Patch& patch : patches)
+		{
+			rpr_int res = (patch.type == NodeInputTypeUint) ?
+				rprMaterialNodeSetInputUByKey(patch.node, patch.key, patch.uintValue) :
+				rprMaterialNodeSetInputFByKey(patch.node, patch.key, patch.value[0], patch.value[1], patch.value[2], patch.value[3]);
+			checkStatus(res);
+		}
+
+		if (appliedPatches)
+			*appliedPatches = std::move(patches);
+
+		return true;
+	}
+
 
 	inline Shader MaterialSystem::ShaderBlend(const Shader& a, const Shader& b, const Value& t) const
 	{
@@ -4263,6 +4536,67 @@ namespace frw
 			m->Attach(h);
 	}
 
+	inline DataBuffer Context::GetSharedDataBuffer(const rpr_buffer_desc& bufferDesc, const float* values)
+	{
+		size_t count = bufferDesc.nb_element * bufferDesc.element_channel_size;
+
+		// FNV-1a over the values and the layout
+		size_t hash = 14695981039346656037ULL;
+		auto hashBytes = [&hash](const void* bytes, size_t size)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= static_cast<const unsigned char*>(bytes)[i];
+				hash *= 1099511628211ULL;
+			}
+		};
+
+		hashBytes(&bufferDesc.nb_element, sizeof(bufferDesc.nb_element));
+		hashBytes(&bufferDesc.element_type, sizeof(bufferDesc.element_type));
+		hashBytes(&bufferDesc.element_channel_size, sizeof(bufferDesc.element_channel_size));
+		hashBytes(values, count * sizeof(float));
+
+		std::lock_guard<std::mutex> lock(data().sharedBuffersMutex);
+
+		data().sharedBuffersRequested++;
+
+		auto range = data().sharedBuffers.equal_range(hash);
+		for (auto it = range.first; it != range.second; )
+		{
+			DataPtr buffer = it->second.buffer.lock();
+			if (!buffer)
+			{
+				it = data().sharedBuffers.erase(it);
+				continue;
+			}
+
+			const Data::SharedBuffer& entry = it->second;
+			if (entry.desc.nb_element == bufferDesc.nb_element &&
+				entry.desc.element_type == bufferDesc.element_type &&
+				entry.desc.element_channel_size == bufferDesc.element_channel_size &&
+				std::equal(entry.values.begin(), entry.values.end(), values))
+			{
+				return DataBuffer(buffer);
+			}
+
+			++it;
+		}
+
+		DataBuffer buffer(*this, bufferDesc, values);
+		if (!buffer)
+			return buffer;
+
+		data().sharedBuffersCreated++;
+
+		Data::SharedBuffer entry;
+		entry.values.assign(values, values + count);
+		entry.desc = bufferDesc;
+		entry.buffer = buffer.m;
+		data().sharedBuffers.emplace(hash, std::move(entry));
+
+		return buffer;
+	}
+
 	inline Image::Image(Context context, float r, float g, float b)
 		: Object(nullptr, context, true, new Data())
 	{
@@ -4276,7 +4610,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, &image_desc, data, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
-			m->Attach(h);
+			AttachCreated(h);
 		}
 	}
 
@@ -4288,7 +4622,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, &image_desc, data, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
-			m->Attach(h);
+			AttachCreated(h);
 		}
 	}
 
@@ -4300,7 +4634,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, nullptr, nullptr, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
-			m->Attach(h);
+			AttachCreated(h);
 		}
 	}
 
@@ -4325,7 +4659,44 @@ namespace frw
 		if (ErrorUnsupportedImageFormat != res) {
 			//^ we don't want to give Error messages to the user about unsupported image formats, since we support them through the plugin.
 			if (checkStatus(res, "Unable to load: " + MString(filename)))
-				m->Attach(h);
+			{
+				AttachCreated(h);
+			}
+		}
+	}
+
+	inline void Image::AttachCreated(rpr_image h)
+	{
+		if (!h)
+			return;
+
+		m->Attach(h);
+
+		long long sizeBytes = 0;
+		if (rprImageGetInfo(Handle(), RPR_IMAGE_DATA_SIZEBYTE, sizeof(sizeBytes), &sizeBytes, nullptr) != RPR_SUCCESS)
+		{
+			sizeBytes = 0;
+		}
+
+		Data& d = data();
+		d.tracked = true;
+		d.sizeBytes = sizeBytes;
+
+		GetContext().AddImageStatistics(sizeBytes);
+	}
+
+	inline Image::Data::~Data()
+	{
+		for (auto it = m_udimsMap.begin(); it != m_udimsMap.end(); ++it)
+		{
+			rprImageSetUDIM(Handle(), it->first, nullptr);
+		}
+
+		m_udimsMap.clear();
+
+		if (tracked && context)
+		{
+			Context(context).RemoveImageStatistics(sizeBytes);
 		}
 	}
 
@@ -4418,6 +4789,7 @@ namespace frw
 		Shape shapeObj(shape, *this);
 
 		shapeObj.SetUVCoordinatesSetFlag(texcoords != nullptr && num_texcoords > 0);
+		shapeObj.SetPolygonCount(num_faces);
 
 		return shapeObj;
 	}
@@ -4453,6 +4825,7 @@ namespace frw
 
 		Shape shapeObj (shape, *this);
 		shapeObj.SetUVCoordinatesSetFlag(numberOfTexCoordLayers > 0);
+		shapeObj.SetPolygonCount(num_faces);
 
 		return shapeObj;
 	}
@@ -4474,6 +4847,7 @@ namespace frw
 		checkStatusThrow(status, ("Unable to create mesh"));
 
 		Shape shapeObj(shape, *this);
+		shapeObj.SetPolygonCount(0);
 
 		return shapeObj;
 	}
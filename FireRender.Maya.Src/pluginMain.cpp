@@ -26,6 +26,7 @@ limitations under the License.
 #include "FireRenderVolumeMaterial.h"
 #include "FireRenderStandardMaterial.h"
 #include "FireRenderPBRMaterial.h"
+#include "FireRenderProduction.h"
 #include "FireRenderTransparentMaterial.h"
 #include "FireRenderMaterialSwatchRender.h"
 #include "FireRenderToonMaterial.h"
@@ -37,6 +38,7 @@ limitations under the License.
 #include "FireRenderCmd.h"
 #include "FireRenderLocationCmd.h"
 #include "EnableSaveIntermediateCmd.h"
+#include "LockProfilerCmd.h"
 #include "FireRenderIBL.h"
 #include "FireRenderSkyLocator.h"
 #include "Lights/IES/FireRenderIESLight.h"
@@ -97,6 +99,7 @@ limitations under the License.
 
 #include "GLTFTranslator.h"
 #include "StartupContextChecker.h"
+#include "SceneTeardownWorker.h"
 
 #ifdef _WIN32
 #pragma warning( disable : 4091 )
@@ -178,6 +181,51 @@ void RPRRelease();
 
 bool gExitingMaya = false;
 
+// UI-only subsystems (swatches, material viewer, viewport override, menus) are not set up
+// in batch, mayapy or prompt sessions, where they only add to plugin load time
+bool HasInteractiveUI()
+{
+	return MGlobal::mayaState() == MGlobal::kInteractive;
+}
+
+// Collects durations of plugin load phases and logs a breakdown at the end of initializePlugin
+class PluginLoadProfile
+{
+public:
+	PluginLoadProfile() :
+		m_start(GetCurrentChronoTime()),
+		m_phaseStart(m_start)
+	{
+	}
+
+	void EndPhase(const char* name)
+	{
+		TimePoint now = GetCurrentChronoTime();
+		m_phases.emplace_back(name, TimeDiffChrono<std::chrono::milliseconds>(now, m_phaseStart));
+		m_phaseStart = now;
+	}
+
+	long TotalTime() const
+	{
+		return TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_start);
+	}
+
+	void Report() const
+	{
+		LogPrint("RPR plugin loaded in %d ms%s", (int) TotalTime(), HasInteractiveUI() ? "" : " (no UI)");
+
+		for (const auto& phase : m_phases)
+		{
+			LogPrint("  %s: %d ms", phase.first, (int) phase.second);
+		}
+	}
+
+private:
+	TimePoint m_start;
+	TimePoint m_phaseStart;
+	std::vector<std::pair<const char*, long>> m_phases;
+};
+
 void NewSceneBasicSetup(void* data)
 {
 	MGlobal::executeCommand("source \"common.mel\"; checkRPRGlobalsNode(); workingUnitsScriptJobSetup();");
@@ -202,6 +250,7 @@ void mayaExiting(void* data)
 	DebugPrint("mayaExiting");
 	gExitingMaya = true;
 
+	FireRenderProduction::WaitForAthenaUpload();
 	AthenaWrapper::GetAthenaWrapper()->Finalize();
 
     // Clear ViewportManager. It should be cleared before maya destroys OpenGL context
@@ -217,6 +266,9 @@ void mayaExiting(void* data)
 	// For some reason Maya willn't call this method if we simply close Maya
 	FireRenderCmd::cleanUp();
 
+	// released scenes still need RPR thread
+	SceneTeardownWorker::WaitForPendingTeardown();
+
 	FireRenderThread::RunTheThread(false);
 	std::this_thread::yield();
 }
@@ -576,6 +628,8 @@ MStatus initializePlugin(MObject obj)
 	// We have legacy updater here which does not work. Comment this code for now becaue it breaks Maya 2022 startup.
 	//PluginUpdater();
 
+	PluginLoadProfile loadProfile;
+
 	// Added for Linux:
 	Logger::AddCallback(InfoCallback, Logger::LevelInfo);
 
@@ -637,7 +691,15 @@ MStatus initializePlugin(MObject obj)
 
 	MString UserDisplacementClassify("rendernode/firerender/shader/displacement:shader/disaplacement");
 
-	glewInit();
+	bool hasInteractiveUI = HasInteractiveUI();
+
+	// GL is only needed by the viewport
+	if (hasInteractiveUI)
+	{
+		glewInit();
+	}
+
+	loadProfile.EndPhase("libraries");
 
 	StartupContextChecker::CheckContexts();
 	if (!StartupContextChecker::IsRprSupported())
@@ -645,7 +707,8 @@ MStatus initializePlugin(MObject obj)
 		return MStatus::kFailure;
 	}
 
-	if (!StartupContextChecker::IsMLDenoiserSupportedCPU())
+	// a pending ML denoiser check reports its warning when the result is first requested
+	if (StartupContextChecker::IsMLDenoiserCheckComplete() && !StartupContextChecker::IsMLDenoiserSupportedCPU())
 	{
 		MGlobal::displayWarning("Machine learning denoiser is not supported by current CPU");
 	}
@@ -655,6 +718,8 @@ MStatus initializePlugin(MObject obj)
 		FireRenderGlobals::initialize,
 		MPxNode::kDependNode));
 
+	loadProfile.EndPhase("startup check");
+
 	MString setCachePathString = "import fireRender.fireRenderUtils as fru\nfru.setShaderCachePathEnvironment(\"" + pluginVersion + "\")";
 	MGlobal::executePythonCommand(setCachePathString);
 
@@ -665,8 +730,9 @@ MStatus initializePlugin(MObject obj)
 	MString envLightClassification = FireRenderEnvironmentLight::drawDbClassification;
 	MString volumeClassification = FireRenderVolumeLocator::drawDbClassification;
 	
+	// swatch render and material viewer contexts are created on first use
 	static const MString swatchName("swatchFireRenderMaterial");
-	if (MGlobal::mayaState() != MGlobal::kBatch)
+	if (hasInteractiveUI)
 	{
 		MSwatchRenderRegister::registerSwatchRender(swatchName, FireRenderMaterialSwatchRender::creator);
 		UserClassify += ":swatch/"_ms + swatchName;
@@ -681,6 +747,8 @@ MStatus initializePlugin(MObject obj)
 		CHECK_MSTATUS(plugin.registerRenderer(FIRE_RENDER_NAME, FireMaterialViewRenderer::creator));
 	}
 
+	loadProfile.EndPhase("swatch and material viewer");
+
 	CHECK_MSTATUS(plugin.registerCommand("fireRender", FireRenderCmd::creator, FireRenderCmd::newSyntax));
 	CHECK_MSTATUS(plugin.registerCommand("fireRenderViewport", FireRenderViewportCmd::creator, FireRenderViewportCmd::newSyntax));
 	CHECK_MSTATUS(plugin.registerCommand("fireRenderExport", FireRenderExportCmd::creator, FireRenderExportCmd::newSyntax));
@@ -690,6 +758,7 @@ MStatus initializePlugin(MObject obj)
 	CHECK_MSTATUS(plugin.registerCommand("athenaEnable", AthenaEnableCmd::creator, AthenaEnableCmd::newSyntax));
 
 	CHECK_MSTATUS(plugin.registerCommand("enableSaveIntermediate", EnableSaveIntermediateCmd::creator, EnableSaveIntermediateCmd::newSyntax));
+	CHECK_MSTATUS(plugin.registerCommand("fireRenderLockProfiler", LockProfilerCmd::creator, LockProfilerCmd::newSyntax));
 
 	MString namePrefix(FIRE_RENDER_NODE_PREFIX);
 
@@ -701,6 +770,8 @@ MStatus initializePlugin(MObject obj)
 
 	CHECK_MSTATUS(plugin.registerCommand(namePrefix + "ImageComparing", FireRenderImageComparing::creator, FireRenderImageComparing::newSyntax));
 
+	loadProfile.EndPhase("commands");
+
 	CHECK_MSTATUS(plugin.registerNode(namePrefix + "IBL", FireRenderIBL::id,
 		FireRenderIBL::creator, FireRenderIBL::initialize,
 		MPxNode::kLocatorNode, &iblClassification));
@@ -755,6 +826,8 @@ MStatus initializePlugin(MObject obj)
 		FireRenderRenderPass::creator, FireRenderRenderPass::initialize,
 		MPxNode::kDependNode, &renderPassClassification));
 
+	loadProfile.EndPhase("locators");
+
 	NewSceneBasicSetup(NULL);
 
 	beforeNewSceneCallback = MSceneMessage::addCallback(MSceneMessage::kBeforeNew, swapToDefaultRenderOverride, NULL, &status);
@@ -770,7 +843,12 @@ MStatus initializePlugin(MObject obj)
 	openSceneCallback = MSceneMessage::addCallback(MSceneMessage::kAfterOpen, NewSceneBasicSetup, NULL, &status);
 	CHECK_MSTATUS(status);
 
-	auto mlDenoiserSupportedCPU = static_cast<int>(StartupContextChecker::IsMLDenoiserSupportedCPU());
+	// -1 lets the UI query the result lazily through "fireRender -mlDenoiserSupportedCPU"
+	int mlDenoiserSupportedCPU = -1;
+	if (StartupContextChecker::IsMLDenoiserCheckComplete())
+	{
+		mlDenoiserSupportedCPU = static_cast<int>(StartupContextChecker::IsMLDenoiserSupportedCPU());
+	}
 	MString mlSupportCPU = MString(std::to_string(mlDenoiserSupportedCPU).c_str());
 
 	MString registerCmd = MString("registerFireRender(" + mlSupportCPU + ")");
@@ -779,11 +857,16 @@ MStatus initializePlugin(MObject obj)
 	MGlobal::executeCommand("setupFireRenderNodeClassification()");
 
 	AddExtensionAttributesCommon();
-	MGlobal::executeCommand("setupFireRenderExtraUI()");
+	if (hasInteractiveUI)
+	{
+		MGlobal::executeCommand("setupFireRenderExtraUI()");
+	}
 
 	// GLTF
 	MGlobal::executeCommand("rprExportsGLTF(1)");
 
+	loadProfile.EndPhase("scene setup scripts");
+
 	// register shaders
 
 	// RPR Material
@@ -865,6 +948,8 @@ MStatus initializePlugin(MObject obj)
 		FireMaya::Displacement::initialize,
 		MPxNode::kDependNode, &UserDisplacementClassify));
 
+	loadProfile.EndPhase("materials");
+
 	// register maps
 
 	static const MString FireRenderFresnelDrawDBClassification("drawdb/shader/surface/" + namePrefix + "Fresnel");
@@ -951,15 +1036,19 @@ MStatus initializePlugin(MObject obj)
 		FireMaya::RPRRamp::initialize,
 		MPxNode::kDependNode, &UserUtilityClassify));
 
-	// Initialize the viewport render override.
-	FireRenderOverride::instance()->initialize();
+	loadProfile.EndPhase("maps");
 
-	//load main menu
-	if (MGlobal::mayaState() != MGlobal::kBatch)
+	if (hasInteractiveUI)
 	{
+		// Initialize the viewport render override.
+		FireRenderOverride::instance()->initialize();
+
+		//load main menu
 		MGlobal::executePythonCommand("import fireRender.fireRenderMenu\nfireRender.fireRenderMenu.createFireRenderMenu()");
 	}
 
+	loadProfile.EndPhase("viewport override and menu");
+
 	CHECK_MSTATUS(registerNodesInPathEditor());
 
 	SetVersionsForMel();
@@ -973,6 +1062,7 @@ MStatus initializePlugin(MObject obj)
 	// Reload Hypershade window
 	// - After plugin is loaded if Hypershade window was open, it becomes bugged,
 	// - so we close and then open Hypershade (if Hypershade window was opened)
+	if (hasInteractiveUI)
 	{
 		MString command =
 			"string $panels[] = `getPanel - vis`;\n"
@@ -1006,6 +1096,12 @@ MStatus initializePlugin(MObject obj)
 
 	AddExtensionAttributesForMaterials();
 
+	loadProfile.EndPhase("ui and extension attributes");
+	loadProfile.Report();
+
+	// benchmarked by FireRender.Maya.Tools/Tests/plugin_load_benchmark.py
+	FireRenderCmd::setPluginLoadTime(loadProfile.TotalTime());
+
 	return status;
 }
 
@@ -1023,7 +1119,10 @@ MStatus uninitializePlugin(MObject obj)
 	MFnPlugin plugin(obj);
 
 	FireRenderViewportManager::instance().clear();
+	SceneTeardownWorker::WaitForPendingTeardown();
 	FireRenderThread::RunTheThread(false);
+	StartupContextChecker::WaitForPendingChecks();
+	FireRenderProduction::WaitForAthenaUpload();
 	std::this_thread::yield();
 
 	CHECK_MSTATUS(plugin.deregisterCommand("fireRender"));
@@ -1033,6 +1132,7 @@ MStatus uninitializePlugin(MObject obj)
 	CHECK_MSTATUS(plugin.deregisterCommand("fireRenderConvertVRay"));
 
 	CHECK_MSTATUS(plugin.deregisterCommand("enableSaveIntermediate"));
+	CHECK_MSTATUS(plugin.deregisterCommand("fireRenderLockProfiler"));
 
 	CHECK_MSTATUS(deRegisterNodesInPathEditor());
 
@@ -1082,7 +1182,7 @@ MStatus uninitializePlugin(MObject obj)
 	CHECK_MSTATUS(plugin.deregisterCommand(namePrefix + "ImageComparing"));
 	//
 
-	if (MGlobal::mayaState() != MGlobal::kBatch)
+	if (HasInteractiveUI())
 	{
 		CHECK_MSTATUS(MSwatchRenderRegister::unregisterSwatchRender("swatchFireRenderMaterial"));
 		CHECK_MSTATUS(plugin.deregisterRenderer(FIRE_RENDER_NAME));
@@ -1101,7 +1201,7 @@ MStatus uninitializePlugin(MObject obj)
 	FireRenderCmd::cleanUp();
 
 	//remove main menu
-	if (MGlobal::mayaState() != MGlobal::kBatch)
+	if (HasInteractiveUI())
 	{
 		MGlobal::executePythonCommand("import fireRender.fireRenderMenu\nfireRender.fireRenderMenu.removeFireRenderMenu()");
 	}
@@ -0,0 +1,86 @@
+#
+# Copyright 2020 Advanced Micro Devices, Inc
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#    http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Plugin load time regression benchmark.
+
+Loads and unloads the plugin in a headless mayapy session and reads the
+initializePlugin duration the plugin measured itself (fireRender -pluginLoadTime).
+Fails when the median load exceeds the threshold:
+
+    mayapy plugin_load_benchmark.py --runs 5 --threshold-ms 2000
+
+The first load also pays for reading the libraries from disk, so it is
+reported but left out of the median when more than one run is made.
+"""
+
+import argparse
+import sys
+import time
+
+import maya.standalone
+
+PLUGIN_NAME = "RadeonProRender"
+
+
+def measureLoads(runs):
+    import maya.cmds as cmds
+
+    results = []
+    for run in range(runs):
+        start = time.time()
+        cmds.loadPlugin(PLUGIN_NAME, quiet=True)
+        wallMs = (time.time() - start) * 1000.0
+
+        pluginMs = cmds.fireRender(pluginLoadTime=True)
+        print("run %d: initializePlugin %d ms, loadPlugin %.0f ms" % (run + 1, pluginMs, wallMs))
+        results.append(pluginMs)
+
+        cmds.file(new=True, force=True)
+        cmds.flushUndo()
+        cmds.unloadPlugin(PLUGIN_NAME, force=True)
+
+    return results
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--runs", type=int, default=5, help="number of load/unload cycles")
+    parser.add_argument("--threshold-ms", type=float, default=2000.0, help="maximum median initializePlugin time")
+    args = parser.parse_args()
+
+    maya.standalone.initialize(name="python")
+    try:
+        results = measureLoads(max(1, args.runs))
+    finally:
+        maya.standalone.uninitialize()
+
+    warmResults = results[1:] if len(results) > 1 else results
+    loadMs = median(warmResults)
+
+    print("median initializePlugin %.0f ms (threshold %.0f ms)" % (loadMs, args.threshold_ms))
+    if loadMs > args.threshold_ms:
+        print("FAILED: plugin load is slower than the threshold")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
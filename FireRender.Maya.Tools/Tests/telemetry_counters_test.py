@@ -0,0 +1,121 @@
+#
+# Copyright 2020 Advanced Micro Devices, Inc
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#    http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Render test for the incrementally maintained telemetry counters.
+
+Renders a scene several times, adding and deleting meshes and file textures
+between the renders, and asks the plugin to compare its polygon and texture
+counters with a full RPR recount after each render.
+
+Production renders need the render view, so run it in interactive Maya:
+
+    maya -command "python(\"exec(open('telemetry_counters_test.py').read())\")"
+
+Maya exits with code 0 when every render matched and 1 otherwise.
+"""
+
+import os
+import struct
+import sys
+import tempfile
+import traceback
+
+import maya.cmds as cmds
+
+RENDER_WIDTH = 160
+RENDER_HEIGHT = 120
+RENDER_ITERATIONS = 4
+
+
+def writeTestTexture(path, size, seed):
+    """Writes an uncompressed 24 bit TGA with a simple gradient."""
+    with open(path, "wb") as f:
+        f.write(struct.pack("<BBBHHBHHHHBB", 0, 0, 2, 0, 0, 0, 0, 0, size, size, 24, 0))
+        for y in range(size):
+            f.write(bytearray(((x * 7 + seed) & 0xff, (y * 5) & 0xff, (x ^ y) & 0xff)[c]
+                              for x in range(size) for c in range(3)))
+
+
+def createTexturedShader(name, texturePath):
+    shader = cmds.shadingNode("RPRUberMaterial", asShader=True, name=name)
+    shadingGroup = cmds.sets(renderable=True, noSurfaceShader=True, empty=True, name=name + "SG")
+    cmds.connectAttr(shader + ".outColor", shadingGroup + ".surfaceShader")
+
+    fileNode = cmds.shadingNode("file", asTexture=True, name=name + "File")
+    cmds.setAttr(fileNode + ".fileTextureName", texturePath, type="string")
+    cmds.connectAttr(fileNode + ".outColor", shader + ".diffuseColor")
+
+    return shadingGroup
+
+
+def assign(mesh, shadingGroup):
+    cmds.sets(mesh, edit=True, forceElement=shadingGroup)
+
+
+def renderAndVerify(step, camera):
+    cmds.fireRender(verifyTelemetryCounters=True)
+    cmds.fireRender(width=RENDER_WIDTH, height=RENDER_HEIGHT, camera=camera, waitForIt=True)
+
+    matched = cmds.fireRender(telemetryCountersMatched=True) == 1
+    print("telemetry counters %s after %s" % ("match" if matched else "DIFFER", step))
+    return matched
+
+
+def runTest():
+    cmds.loadPlugin("RadeonProRender", quiet=True)
+    cmds.file(new=True, force=True)
+    cmds.setAttr("defaultRenderGlobals.currentRenderer", "FireRender", type="string")
+    cmds.setAttr("RadeonProRenderGlobals.completionCriteriaIterations", RENDER_ITERATIONS)
+
+    textureDir = tempfile.mkdtemp(prefix="rprTelemetryTest")
+    textures = []
+    for i, size in enumerate((64, 128, 32)):
+        path = os.path.join(textureDir, "texture%d.tga" % i)
+        writeTestTexture(path, size, i * 37)
+        textures.append(path)
+
+    camera = cmds.camera(position=(0, 4, 14), rotation=(-15, 0, 0))[0]
+
+    sphere = cmds.polySphere(subdivisionsAxis=32, subdivisionsHeight=24)[0]
+    cube = cmds.polyCube()[0]
+    cmds.move(3, 0, 0, cube)
+    sphereSG = createTexturedShader("sphereMtl", textures[0])
+    cubeSG = createTexturedShader("cubeMtl", textures[1])
+    assign(sphere, sphereSG)
+    assign(cube, cubeSG)
+
+    results = [renderAndVerify("initial scene", camera)]
+
+    # Removed meshes and textures have to leave the counters
+    cmds.delete(cube, "cubeMtl", "cubeMtlFile", cubeSG)
+    plane = cmds.polyPlane(subdivisionsX=20, subdivisionsY=20, width=20, height=20)[0]
+    cmds.move(0, -1, 0, plane)
+    assign(plane, createTexturedShader("planeMtl", textures[2]))
+    results.append(renderAndVerify("delete and create", camera))
+
+    # Topology changes and instances have to be recounted
+    cmds.polySmooth(sphere, divisions=1)
+    instance = cmds.instance(sphere)[0]
+    cmds.move(-3, 0, 0, instance)
+    results.append(renderAndVerify("smooth and instance", camera))
+
+    return all(results)
+
+
+try:
+    passed = runTest()
+except Exception:
+    traceback.print_exc()
+    passed = False
+
+sys.stdout.flush()
+cmds.quit(force=True, exitCode=0 if passed else 1)
@@ -0,0 +1,142 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "../FireRender.Maya.Src/AOVChannelInterleaver.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fireRenderUnitTests
+{
+	// RV_PIXEL layout: r, g, b, a
+	const unsigned int RVPixelStride = 4;
+
+	// AOV buffer filled with random 32 bit patterns; every 7th value is a NaN with random payload
+	std::vector<float> MakeRandomAOV(size_t pixelCount, std::mt19937& generator)
+	{
+		std::vector<float> pixels(pixelCount * RVPixelStride);
+
+		for (size_t idx = 0; idx < pixels.size(); ++idx)
+		{
+			uint32_t bits = generator();
+			if (idx % 7 == 0)
+			{
+				bits = (bits & 0x807fffffu) | 0x7f800001u;
+			}
+
+			std::memcpy(&pixels[idx], &bits, sizeof(bits));
+		}
+
+		return pixels;
+	}
+
+	// pixel by pixel, channel by channel, copying bits the way the previous saveMultichannelAOVs loop did
+	std::vector<uint32_t> ReferenceInterleave(const std::vector<AOVChannelSource>& sources, size_t pixelCount, size_t pixelSize)
+	{
+		std::vector<uint32_t> output(pixelCount * pixelSize);
+
+		for (size_t pixelIdx = 0; pixelIdx < pixelCount; ++pixelIdx)
+		{
+			size_t channel = 0;
+			for (const AOVChannelSource& source : sources)
+			{
+				for (unsigned int component = 0; component < source.componentCount; ++component)
+				{
+					std::memcpy(&output[pixelIdx * pixelSize + channel], source.pixels + pixelIdx * source.pixelStride + component, sizeof(uint32_t));
+					channel++;
+				}
+			}
+		}
+
+		return output;
+	}
+
+	void CheckBitExact(unsigned int width, unsigned int height, const std::vector<unsigned int>& componentCounts)
+	{
+		std::mt19937 generator(width * 31 + height);
+
+		std::vector<std::vector<float>> aovs;
+		std::vector<AOVChannelSource> sources;
+		size_t pixelSize = 0;
+
+		for (unsigned int componentCount : componentCounts)
+		{
+			aovs.push_back(MakeRandomAOV(size_t(width) * height, generator));
+			pixelSize += componentCount;
+		}
+
+		for (size_t idx = 0; idx < aovs.size(); ++idx)
+		{
+			sources.push_back({ aovs[idx].data(), RVPixelStride, componentCounts[idx] });
+		}
+
+		size_t pixelCount = size_t(width) * height;
+		std::vector<uint32_t> expected = ReferenceInterleave(sources, pixelCount, pixelSize);
+
+		std::vector<float> output(pixelCount * pixelSize);
+		InterleaveAOVChannels(sources, width, height, pixelSize, output.data());
+
+		Assert::AreEqual(0, std::memcmp(expected.data(), output.data(), expected.size() * sizeof(uint32_t)));
+	}
+
+	TEST_CLASS(AOVChannelInterleaverTest)
+	{
+	public:
+
+		TEST_METHOD(BeautyAndCryptomatteChannelsAreBitExact)
+		{
+			// color, depth and six cryptomatte rank/coverage AOVs
+			CheckBitExact(1923, 1081, { 4, 1, 4, 4, 4, 4, 4, 4 });
+		}
+
+		TEST_METHOD(MixedComponentCountsAreBitExact)
+		{
+			CheckBitExact(257, 129, { 3, 1, 2, 4, 1 });
+		}
+
+		TEST_METHOD(SmallImagesAreBitExact)
+		{
+			// fewer rows than worker tasks, single row and single column
+			CheckBitExact(5, 3, { 4, 2 });
+			CheckBitExact(64, 1, { 4 });
+			CheckBitExact(1, 64, { 1, 3 });
+		}
+
+		TEST_METHOD(NaNPayloadIsPreserved)
+		{
+			const uint32_t nanBits[] = { 0x7fc00001u, 0x7f800001u, 0xffc12345u, 0x7fbfffffu };
+
+			std::vector<float> aov(RVPixelStride * 2);
+			for (size_t idx = 0; idx < aov.size(); ++idx)
+			{
+				std::memcpy(&aov[idx], &nanBits[idx % 4], sizeof(uint32_t));
+			}
+
+			std::vector<AOVChannelSource> sources = { { aov.data(), RVPixelStride, 4 } };
+			std::vector<float> output(aov.size());
+			InterleaveAOVChannels(sources, 2, 1, 4, output.data());
+
+			for (size_t idx = 0; idx < output.size(); ++idx)
+			{
+				uint32_t bits;
+				std::memcpy(&bits, &output[idx], sizeof(bits));
+				Assert::AreEqual(nanBits[idx % 4], bits);
+			}
+		}
+	};
+}
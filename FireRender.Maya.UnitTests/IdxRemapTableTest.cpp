@@ -0,0 +1,258 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "../FireRender.Maya.Src/Translators/IdxRemapTable.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using FireMaya::IdxRemapTable;
+
+namespace fireRenderUnitTests
+{
+	// vertices and two uv sets, as MultipleShaderMeshTranslator remaps them
+	const unsigned int RemapChannelCount = 3;
+
+	// the unordered_map remapping the translators used before the dense tables, one map per submesh
+	class MapRemapTable
+	{
+	public:
+		void Init(size_t) { m_map.clear(); }
+
+		void NextSubmesh() { m_map.clear(); }
+
+		int Get(int globalIdx) const
+		{
+			auto it = m_map.find(globalIdx);
+			return it == m_map.end() ? IdxRemapTable::NotInDictionary : it->second;
+		}
+
+		void Set(int globalIdx, int localIdx) { m_map[globalIdx] = localIdx; }
+
+	private:
+		std::unordered_map<int, int> m_map;
+	};
+
+	// Grid of quads split in two triangles each, one material per quadrant of the grid.
+	// uv set 0 is shared between faces like vertices are, uv set 1 has separate uvs for every face
+	struct QuadGrid
+	{
+		size_t globalCounts[RemapChannelCount] = {};
+
+		// 6 face-vertex ids per quad, per channel
+		std::vector<int> faceVertexIds[RemapChannelCount];
+
+		std::vector<std::vector<unsigned int>> quadsBySubmesh;
+
+		QuadGrid(unsigned int size)
+		{
+			const unsigned int rowVertices = size + 1;
+			const unsigned int quadCount = size * size;
+
+			globalCounts[0] = (size_t) rowVertices * rowVertices;
+			globalCounts[1] = globalCounts[0];
+			globalCounts[2] = (size_t) quadCount * 4;
+
+			quadsBySubmesh.resize(4);
+
+			for (unsigned int y = 0; y < size; y++)
+			{
+				for (unsigned int x = 0; x < size; x++)
+				{
+					unsigned int quad = y * size + x;
+					int corners[4] = { (int) (y * rowVertices + x), (int) (y * rowVertices + x + 1),
+						(int) ((y + 1) * rowVertices + x + 1), (int) ((y + 1) * rowVertices + x) };
+
+					const int triangleCorners[6] = { 0, 1, 2, 0, 2, 3 };
+					for (int corner : triangleCorners)
+					{
+						faceVertexIds[0].push_back(corners[corner]);
+						faceVertexIds[1].push_back(corners[corner]);
+						faceVertexIds[2].push_back((int) quad * 4 + corner);
+					}
+
+					unsigned int submesh = (x >= size / 2 ? 1 : 0) + (y >= size / 2 ? 2 : 0);
+					quadsBySubmesh[submesh].push_back(quad);
+				}
+			}
+		}
+	};
+
+	struct SubmeshIndices
+	{
+		std::vector<int> indices[RemapChannelCount];
+		int localCounts[RemapChannelCount] = {};
+
+		bool operator==(const SubmeshIndices& other) const
+		{
+			for (unsigned int channel = 0; channel < RemapChannelCount; channel++)
+			{
+				if (indices[channel] != other.indices[channel] || localCounts[channel] != other.localCounts[channel])
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+	// fills submeshes one after another with one table per channel, like the multiple shader translator
+	template <typename Table>
+	std::vector<SubmeshIndices> RemapGrid(const QuadGrid& grid)
+	{
+		Table tables[RemapChannelCount];
+		for (unsigned int channel = 0; channel < RemapChannelCount; channel++)
+		{
+			tables[channel].Init(grid.globalCounts[channel]);
+		}
+
+		std::vector<SubmeshIndices> submeshes(grid.quadsBySubmesh.size());
+
+		for (size_t submeshIdx = 0; submeshIdx < submeshes.size(); submeshIdx++)
+		{
+			SubmeshIndices& submesh = submeshes[submeshIdx];
+
+			for (unsigned int channel = 0; channel < RemapChannelCount; channel++)
+			{
+				if (submeshIdx > 0)
+				{
+					tables[channel].NextSubmesh();
+				}
+
+				submesh.indices[channel].reserve(grid.quadsBySubmesh[submeshIdx].size() * 6);
+			}
+
+			for (unsigned int quad : grid.quadsBySubmesh[submeshIdx])
+			{
+				for (unsigned int channel = 0; channel < RemapChannelCount; channel++)
+				{
+					const int* ids = grid.faceVertexIds[channel].data() + (size_t) quad * 6;
+
+					for (unsigned int idx = 0; idx < 6; idx++)
+					{
+						int localIdx = tables[channel].Get(ids[idx]);
+						if (localIdx == IdxRemapTable::NotInDictionary)
+						{
+							localIdx = submesh.localCounts[channel]++;
+							tables[channel].Set(ids[idx], localIdx);
+						}
+
+						submesh.indices[channel].push_back(localIdx);
+					}
+				}
+			}
+		}
+
+		return submeshes;
+	}
+
+	template <typename Function>
+	long long MeasureMs(Function function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	TEST_CLASS(IdxRemapTableTest)
+	{
+	public:
+
+		TEST_METHOD(EntriesStartNotInDictionary)
+		{
+			IdxRemapTable table;
+			table.Init(16);
+
+			for (int idx = 0; idx < 16; idx++)
+			{
+				Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(idx));
+			}
+		}
+
+		TEST_METHOD(NextSubmeshForgetsEntries)
+		{
+			IdxRemapTable table;
+			table.Init(8);
+
+			table.Set(3, 0);
+			table.Set(5, 1);
+			Assert::AreEqual(0, table.Get(3));
+			Assert::AreEqual(1, table.Get(5));
+
+			table.NextSubmesh();
+			Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(3));
+			Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(5));
+
+			table.Set(5, 0);
+			Assert::AreEqual(0, table.Get(5));
+			Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(3));
+		}
+
+		TEST_METHOD(InitResetsStamps)
+		{
+			IdxRemapTable table;
+			table.Init(4);
+			table.Set(1, 7);
+			table.NextSubmesh();
+			table.Set(2, 9);
+
+			table.Init(4);
+			Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(1));
+			Assert::AreEqual((int) IdxRemapTable::NotInDictionary, table.Get(2));
+		}
+
+		TEST_METHOD(SubmeshRemapMatchesMapRemap)
+		{
+			QuadGrid grid(37);
+
+			std::vector<SubmeshIndices> dense = RemapGrid<IdxRemapTable>(grid);
+			std::vector<SubmeshIndices> reference = RemapGrid<MapRemapTable>(grid);
+
+			Assert::IsTrue(dense == reference);
+
+			// vertices on the seams between quadrants are in two submeshes, the centre one in four;
+			// uv set 1 is not shared between faces at all
+			int vertexCount = 0;
+			int faceUVCount = 0;
+			for (const SubmeshIndices& submesh : dense)
+			{
+				vertexCount += submesh.localCounts[0];
+				faceUVCount += submesh.localCounts[2];
+			}
+
+			Assert::AreEqual(39 * 39, vertexCount);
+			Assert::AreEqual(37 * 37 * 4, faceUVCount);
+		}
+
+		// Remap benchmark of a 1000x1000 quad grid; compares with the unordered_map tables and logs both times
+		TEST_METHOD(SubmeshRemapBenchmark)
+		{
+			QuadGrid grid(1000);
+
+			std::vector<SubmeshIndices> dense;
+			std::vector<SubmeshIndices> reference;
+
+			long long denseMs = MeasureMs([&]() { dense = RemapGrid<IdxRemapTable>(grid); });
+			long long mapMs = MeasureMs([&]() { reference = RemapGrid<MapRemapTable>(grid); });
+
+			std::string message = "IdxRemapTable: " + std::to_string(denseMs) + " ms, unordered_map: " + std::to_string(mapMs) + " ms\n";
+			Logger::WriteMessage(message.c_str());
+
+			Assert::IsTrue(dense == reference);
+		}
+	};
+}
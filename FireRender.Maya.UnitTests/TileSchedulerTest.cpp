@@ -0,0 +1,332 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "stdafx.h"
+
+#include "../FireRender.Maya.Src/PixelBuffer.h"
+#include "../FireRender.Maya.Src/TileScheduler.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// same layout as RV_PIXEL in maya/MRenderView.h
+struct RV_PIXEL
+{
+	float r;
+	float g;
+	float b;
+	float a;
+};
+
+namespace fireRenderUnitTests
+{
+	// stands in for FireRenderContext: "renders" a tile by marking its pixels in the shared frame
+	struct MockContext
+	{
+		std::vector<std::atomic<int>>* frame = nullptr;
+		unsigned int frameWidth = 0;
+		std::atomic<int> renderedTiles { 0 };
+
+		void RenderTile(const RenderRegion& region)
+		{
+			for (unsigned int y = region.bottom; y <= region.top; y++)
+			{
+				for (unsigned int x = region.left; x <= region.right; x++)
+				{
+					(*frame)[y * frameWidth + x]++;
+				}
+			}
+
+			renderedTiles++;
+		}
+	};
+
+	TileRenderInfo MakeInfo(unsigned int width, unsigned int height, unsigned int tileSizeX, unsigned int tileSizeY)
+	{
+		TileRenderInfo info;
+		info.totalWidth = width;
+		info.totalHeight = height;
+		info.tileSizeX = tileSizeX;
+		info.tileSizeY = tileSizeY;
+		info.tilesFillType = TileRenderFillType::Normal;
+
+		return info;
+	}
+
+	// worker contexts are owned by the caller the same way FireRenderProduction owns m_tileWorkerContexts
+	std::vector<std::shared_ptr<MockContext>> CreateContexts(unsigned int count, std::vector<std::atomic<int>>& frame, unsigned int frameWidth)
+	{
+		std::vector<std::shared_ptr<MockContext>> contexts;
+		for (unsigned int idx = 0; idx < count; idx++)
+		{
+			auto context = std::make_shared<MockContext>();
+			context->frame = &frame;
+			context->frameWidth = frameWidth;
+			contexts.push_back(context);
+		}
+
+		return contexts;
+	}
+
+	// tile pixels the way FireRenderAOV::readFrameBuffer returns them: first row is the top of the region
+	std::vector<RV_PIXEL> RenderTilePixels(const RenderRegion& region, unsigned int aovId)
+	{
+		std::vector<RV_PIXEL> pixels;
+		pixels.reserve(region.getWidth() * region.getHeight());
+
+		for (unsigned int y = 0; y < region.getHeight(); y++)
+		{
+			for (unsigned int x = 0; x < region.getWidth(); x++)
+			{
+				pixels.push_back({ (float) (region.left + x), (float) (region.top - y), (float) aovId, 1.0f });
+			}
+		}
+
+		return pixels;
+	}
+
+	// the worker function copies are gone once Run returns, so dropping the caller's references has to free the contexts
+	void AssertContextsReleased(std::vector<std::shared_ptr<MockContext>>& contexts)
+	{
+		std::vector<std::weak_ptr<MockContext>> released(contexts.begin(), contexts.end());
+		contexts.clear();
+
+		for (const std::weak_ptr<MockContext>& context : released)
+		{
+			Assert::IsTrue(context.expired());
+		}
+	}
+
+	TEST_CLASS(TileSchedulerTest)
+	{
+	public:
+
+		TEST_METHOD(TileLayoutCoversFrame)
+		{
+			TileScheduler scheduler(MakeInfo(1000, 700, 128, 96));
+
+			Assert::AreEqual(8, scheduler.GetTilesX());
+			Assert::AreEqual(8, scheduler.GetTilesY());
+			Assert::AreEqual(64u, scheduler.GetTileCount());
+
+			// tiles are handed out row by row starting from the top of the image
+			TileDescription tile;
+			Assert::IsTrue(scheduler.GetNextTile(tile));
+			Assert::AreEqual(1u, tile.sequenceNumber);
+			Assert::AreEqual(0, tile.xTile);
+			Assert::AreEqual(7, tile.yTile);
+			Assert::AreEqual(0, tile.yTileIdx);
+			Assert::AreEqual(699u, tile.region.top);
+			Assert::AreEqual(672u, tile.region.bottom);
+
+			unsigned int handedOut = 1;
+			TileDescription lastTile = tile;
+			while (scheduler.GetNextTile(tile))
+			{
+				handedOut++;
+				lastTile = tile;
+			}
+
+			Assert::AreEqual(64u, handedOut);
+
+			// edge tiles are clamped to the frame size
+			Assert::AreEqual(999u, lastTile.region.right);
+			Assert::AreEqual(896u, lastTile.region.left);
+			Assert::AreEqual(0u, lastTile.region.bottom);
+			Assert::AreEqual(7, lastTile.yTileIdx);
+		}
+
+		TEST_METHOD(EveryTileRenderedExactlyOnce)
+		{
+			const unsigned int width = 1000;
+			const unsigned int height = 700;
+			const unsigned int workerCount = 4;
+
+			std::vector<std::atomic<int>> frame(width * height);
+			std::vector<std::shared_ptr<MockContext>> contexts = CreateContexts(workerCount, frame, width);
+
+			TileScheduler scheduler(MakeInfo(width, height, 64, 64));
+			std::vector<std::atomic<int>> tileHits(scheduler.GetTileCount() + 1);
+
+			// worker function keeps its own references, the scheduler should drop them once Run returns
+			scheduler.Run(workerCount, [contexts, &tileHits](unsigned int workerIndex, const TileDescription& tile)
+			{
+				contexts[workerIndex]->RenderTile(tile.region);
+				tileHits[tile.sequenceNumber]++;
+
+				return true;
+			});
+
+			Assert::IsFalse(scheduler.IsCancelled());
+
+			for (unsigned int sequenceNumber = 1; sequenceNumber < tileHits.size(); sequenceNumber++)
+			{
+				Assert::AreEqual(1, tileHits[sequenceNumber].load());
+			}
+
+			// tiles neither overlap nor leave gaps
+			for (const std::atomic<int>& pixel : frame)
+			{
+				Assert::AreEqual(1, pixel.load());
+			}
+
+			int renderedTiles = 0;
+			for (const std::shared_ptr<MockContext>& context : contexts)
+			{
+				renderedTiles += context->renderedTiles;
+			}
+
+			Assert::AreEqual((int) scheduler.GetTileCount(), renderedTiles);
+
+			AssertContextsReleased(contexts);
+		}
+
+		TEST_METHOD(TilesMergedIntoAOVPixelBuffers)
+		{
+			const unsigned int width = 1000;
+			const unsigned int height = 700;
+			const unsigned int workerCount = 4;
+			const unsigned int aovIds[] = { 0, 3, 11 };
+
+			std::vector<std::atomic<int>> frame(width * height);
+			std::vector<std::shared_ptr<MockContext>> contexts = CreateContexts(workerCount, frame, width);
+
+			AOVPixelBuffers out;
+			for (unsigned int aovId : aovIds)
+			{
+				PixelBuffer& buffer = out[aovId];
+				buffer.resize(width, height);
+
+				RV_PIXEL* pixels = buffer.get();
+				for (size_t idx = 0; idx < buffer.width() * buffer.height(); idx++)
+				{
+					pixels[idx] = { -1.0f, -1.0f, -1.0f, -1.0f };
+				}
+			}
+
+			TileScheduler scheduler(MakeInfo(width, height, 64, 48));
+
+			// same merge as the production tile callback: every context writes its tiles straight into the shared buffers
+			scheduler.Run(workerCount, [contexts, &out](unsigned int workerIndex, const TileDescription& tile)
+			{
+				contexts[workerIndex]->RenderTile(tile.region);
+
+				for (auto& it : out)
+				{
+					std::vector<RV_PIXEL> pixels = RenderTilePixels(tile.region, it.first);
+					it.second.overwrite(pixels.data(), tile.region, height, width, it.first);
+				}
+
+				return true;
+			});
+
+			Assert::IsFalse(scheduler.IsCancelled());
+
+			// buffers are stored top row first, every pixel has to come from the tile covering it
+			for (unsigned int aovId : aovIds)
+			{
+				const RV_PIXEL* pixels = out[aovId].get();
+				size_t mismatches = 0;
+
+				for (unsigned int row = 0; row < height; row++)
+				{
+					for (unsigned int x = 0; x < width; x++)
+					{
+						const RV_PIXEL& pixel = pixels[row * width + x];
+
+						if (pixel.r != (float) x || pixel.g != (float) (height - 1 - row) || pixel.b != (float) aovId || pixel.a != 1.0f)
+						{
+							mismatches++;
+						}
+					}
+				}
+
+				Assert::AreEqual((size_t) 0, mismatches);
+			}
+
+			AssertContextsReleased(contexts);
+		}
+
+		TEST_METHOD(CancelStopsHandingOutTiles)
+		{
+			const unsigned int width = 512;
+			const unsigned int height = 512;
+			const unsigned int workerCount = 3;
+			const int cancelAfter = 5;
+
+			std::vector<std::atomic<int>> frame(width * height);
+			std::vector<std::shared_ptr<MockContext>> contexts = CreateContexts(workerCount, frame, width);
+
+			TileScheduler scheduler(MakeInfo(width, height, 32, 32));
+			std::atomic<int> renderedTiles { 0 };
+
+			scheduler.Run(workerCount, [contexts, &renderedTiles](unsigned int workerIndex, const TileDescription& tile)
+			{
+				contexts[workerIndex]->RenderTile(tile.region);
+
+				// returning false is how the production render reports cancellation
+				return ++renderedTiles < cancelAfter;
+			});
+
+			Assert::IsTrue(scheduler.IsCancelled());
+
+			// workers which already took a tile finish it, nothing new is handed out
+			Assert::IsTrue(renderedTiles.load() >= cancelAfter);
+			Assert::IsTrue(renderedTiles.load() < cancelAfter + (int) workerCount);
+
+			TileDescription tile;
+			Assert::IsFalse(scheduler.GetNextTile(tile));
+
+			AssertContextsReleased(contexts);
+		}
+
+		TEST_METHOD(WorkerExceptionRethrownAfterAllWorkersFinish)
+		{
+			const unsigned int width = 512;
+			const unsigned int height = 512;
+			const unsigned int workerCount = 4;
+
+			std::vector<std::atomic<int>> frame(width * height);
+			std::vector<std::shared_ptr<MockContext>> contexts = CreateContexts(workerCount, frame, width);
+
+			TileScheduler scheduler(MakeInfo(width, height, 32, 32));
+			std::atomic<int> activeWorkers { 0 };
+
+			auto runScheduler = [&]()
+			{
+				scheduler.Run(workerCount, [contexts, &activeWorkers](unsigned int workerIndex, const TileDescription& tile)
+				{
+					activeWorkers++;
+					contexts[workerIndex]->RenderTile(tile.region);
+					activeWorkers--;
+
+					if (tile.sequenceNumber == 10)
+						throw std::runtime_error("tile render failed");
+
+					return true;
+				});
+			};
+
+			Assert::ExpectException<std::runtime_error>(runScheduler);
+
+			// all worker threads are joined before the exception reaches the caller
+			Assert::AreEqual(0, activeWorkers.load());
+			Assert::IsTrue(scheduler.IsCancelled());
+
+			AssertContextsReleased(contexts);
+		}
+	};
+}